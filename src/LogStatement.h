@@ -87,6 +87,15 @@ public:
         return line.str();
     }
 
+    static const std::string tRecursiveRuleOrder(const std::string& relationName, const int version,
+            const std::string& atomOrder, const SrcLocation& srcLocation, const std::string& datalogText) {
+        const char* messageType = "@t-recursive-rule-order";
+        std::stringstream line;
+        line << messageType << ";" << relationName << ";" << version << ";" << atomOrder << ";" << srcLocation
+             << ";" << datalogText << ";";
+        return line.str();
+    }
+
     static const std::string tRecursiveRelation(
             const std::string& relationName, const SrcLocation& srcLocation) {
         const char* messageType = "@t-recursive-relation";
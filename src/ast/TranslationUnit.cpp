@@ -9,12 +9,16 @@
 #include "ast/TranslationUnit.h"
 #include "Global.h"
 #include "ast/Program.h"
+#include "ast/analysis/Analysis.h"
 #include "ast/analysis/PrecedenceGraph.h"
 #include "ast/analysis/SCCGraph.h"
 #include "reports/DebugReport.h"
+#include <chrono>
+#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace souffle::ast {
 
@@ -30,7 +34,18 @@ analysis::Analysis* TranslationUnit::addAnalysis(char const* name, Own<analysis:
     static const bool debug = Global::config().has("debug-report");
     auto* anaPtr = analysis.get();
     analyses.insert({name, std::move(analysis)});
+
+    // nested analyses are part of the time of the outermost one
+    const bool outermost = running.empty();
+    auto start = std::chrono::high_resolution_clock::now();
+    running.push_back(name);
     anaPtr->run(*this);
+    running.pop_back();
+    if (outermost) {
+        auto end = std::chrono::high_resolution_clock::now();
+        analysisTime += std::chrono::duration<double>(end - start).count();
+    }
+    analysisRuns++;
     if (debug) {
         std::ostringstream ss;
         std::string strName = name;
@@ -45,8 +60,47 @@ analysis::Analysis* TranslationUnit::addAnalysis(char const* name, Own<analysis:
     return anaPtr;
 }
 
-void TranslationUnit::invalidateAnalyses() const {
-    analyses.clear();
+void TranslationUnit::addDependency(char const* name) const {
+    if (running.empty() || running.back() == name) {
+        return;
+    }
+    // only look up known dependencies, so that analyses may query others from several threads
+    const std::string& user = running.back();
+    auto it = dependents.find(name);
+    if (it != dependents.end() && it->second.count(user) > 0) {
+        return;
+    }
+    dependents[name].insert(user);
+}
+
+void TranslationUnit::removeAnalysis(const std::string& name) const {
+    analyses.erase(name);
+    auto it = dependents.find(name);
+    if (it == dependents.end()) {
+        return;
+    }
+    std::set<std::string> users = std::move(it->second);
+    dependents.erase(it);
+    for (const auto& user : users) {
+        removeAnalysis(user);
+    }
+}
+
+void TranslationUnit::invalidateAnalyses(ProgramParts parts) const {
+    if (parts == ProgramPart::All) {
+        analyses.clear();
+        dependents.clear();
+        return;
+    }
+    std::vector<std::string> stale;
+    for (const auto& [name, analysis] : analyses) {
+        if ((analysis->getReadParts() & parts) != 0) {
+            stale.push_back(name);
+        }
+    }
+    for (const auto& name : stale) {
+        removeAnalysis(name);
+    }
 }
 
 }  // namespace souffle::ast
@@ -18,8 +18,12 @@
 
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/Types.h"
+#include <cstddef>
 #include <map>
+#include <set>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace souffle {
 class ErrorReport;
@@ -34,6 +38,26 @@ namespace analysis {
 class Analysis;
 }
 
+/**
+ * Parts of a program, combined as bit sets. Analyses declare the parts they read and
+ * transformers the parts they modify, so that a transformation only invalidates the
+ * cached analyses reading a part it has changed.
+ */
+namespace ProgramPart {
+enum : unsigned {
+    None = 0,
+    Types = 1u << 0,
+    Functors = 1u << 1,
+    Relations = 1u << 2,
+    Clauses = 1u << 3,
+    Directives = 1u << 4,
+    Components = 1u << 5,
+    All = (1u << 6) - 1
+};
+}  // namespace ProgramPart
+
+using ProgramParts = unsigned;
+
 /**
  * @class TranslationUnit
  * @brief Translation unit class for the translation pipeline
@@ -58,6 +82,7 @@ public:
         } else {
             ana = it->second.get();
         }
+        addDependency(Analysis::name);
 
         return as<Analysis>(ana);
     }
@@ -72,8 +97,21 @@ public:
         return errorReport;
     }
 
-    /** Destroy all cached analyses of translation unit */
-    void invalidateAnalyses() const;
+    /**
+     * Destroy the cached analyses reading any of the given parts of the program, and
+     * the analyses that used them; by default all cached analyses are destroyed
+     */
+    void invalidateAnalyses(ProgramParts parts = ProgramPart::All) const;
+
+    /** Return the total time spent running analyses, in seconds */
+    double getAnalysisTime() const {
+        return analysisTime;
+    }
+
+    /** Return the number of analyses run so far */
+    std::size_t getAnalysisRuns() const {
+        return analysisRuns;
+    }
 
     /** Return debug report */
     DebugReport& getDebugReport() {
@@ -83,10 +121,28 @@ public:
 private:
     analysis::Analysis* addAnalysis(char const* name, Own<analysis::Analysis> analysis) const;
 
+    /** Record that the analysis being run uses the given analysis */
+    void addDependency(char const* name) const;
+
+    /** Destroy a cached analysis and the analyses that used it */
+    void removeAnalysis(const std::string& name) const;
+
 private:
     /** Cached analyses */
     mutable std::map<std::string, Own<analysis::Analysis>> analyses;
 
+    /** The analyses that used each analysis while running */
+    mutable std::map<std::string, std::set<std::string>> dependents;
+
+    /** Analyses being run, innermost last */
+    mutable std::vector<std::string> running;
+
+    /** Time spent running analyses, in seconds */
+    mutable double analysisTime = 0;
+
+    /** Number of analyses run */
+    mutable std::size_t analysisRuns = 0;
+
     /** AST program */
     Own<Program> program;
 
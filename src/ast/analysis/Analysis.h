@@ -16,14 +16,13 @@
 
 #pragma once
 
+#include "ast/TranslationUnit.h"
 #include <ostream>
 #include <string>
 #include <utility>
 
 namespace souffle::ast {
 
-class TranslationUnit;
-
 namespace analysis {
 
 /**
@@ -37,6 +36,11 @@ public:
     /** run analysis for a Ast translation unit */
     virtual void run(const TranslationUnit& /*translationUnit*/) = 0;
 
+    /** get the parts of the program read by the analysis, which invalidate it when modified */
+    virtual ProgramParts getReadParts() const {
+        return ProgramPart::All;
+    }
+
     /** print the analysis result in HTML format */
     virtual void print(std::ostream&) const {}
 
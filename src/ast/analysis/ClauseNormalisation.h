@@ -94,6 +94,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Clauses;
+    }
+
     void print(std::ostream& os) const override;
 
     const NormalisedClause& getNormalisation(const Clause* clause) const;
@@ -79,6 +79,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Components;
+    }
+
     /**
      * Performs a lookup operation for a component with the given name within the addressed scope.
      *
@@ -38,6 +38,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Relations | ProgramPart::Directives;
+    }
+
     void print(std::ostream& os) const override;
 
     bool isInput(const Relation* relation) const {
@@ -44,6 +44,11 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    /** the program is only read through other analyses */
+    ProgramParts getReadParts() const override {
+        return ProgramPart::None;
+    }
+
     void print(std::ostream& os) const override;
 
     // Numeric constants
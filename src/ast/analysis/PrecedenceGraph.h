@@ -40,6 +40,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Relations | ProgramPart::Clauses;
+    }
+
     /** Output precedence graph in graphviz format to a given stream */
     void print(std::ostream& os) const override;
 
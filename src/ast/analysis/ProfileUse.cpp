@@ -18,9 +18,13 @@
 #include "ast/analysis/ProfileUse.h"
 #include "Global.h"
 #include "ast/QualifiedName.h"
+#include "souffle/profile/ProfileDatabase.h"
+#include "souffle/profile/ProfileEvent.h"
 #include "souffle/profile/ProgramRun.h"
 #include "souffle/profile/Reader.h"
 #include "souffle/profile/Relation.h"
+#include "souffle/utility/MiscUtil.h"
+#include <algorithm>
 #include <limits>
 #include <string>
 
@@ -33,6 +37,39 @@ void ProfileUseAnalysis::run(const TranslationUnit&) {
     if (Global::config().has("profile-use")) {
         std::string filename = Global::config().get("profile-use");
         profile::Reader(filename, programRun).processFile();
+        loadStatistics();
+    }
+}
+
+/**
+ * Retrieve the column statistics recorded with --profile-statistics
+ */
+void ProfileUseAnalysis::loadStatistics() {
+    const auto& db = ProfileEventSingleton::instance().getDB();
+    const auto* dir = as<profile::DirectoryEntry>(db.lookupEntry({"program", "statistics"}));
+    if (dir == nullptr) {
+        return;
+    }
+    for (const auto& relName : dir->getKeys()) {
+        auto readSize = [&](const std::vector<std::string>& path) -> const profile::SizeEntry* {
+            std::vector<std::string> qualifier{"program", "statistics", relName};
+            qualifier.insert(qualifier.end(), path.begin(), path.end());
+            return as<profile::SizeEntry>(db.lookupEntry(qualifier));
+        };
+        const auto* tuples = readSize({"tuples"});
+        if (tuples == nullptr) {
+            continue;
+        }
+        ColumnStatistics& stats = statistics[relName];
+        stats.tuples = tuples->getSize();
+        while (const auto* column = readSize({"column", std::to_string(stats.columns.size())})) {
+            stats.columns.push_back(column->getSize());
+        }
+        for (size_t len = 1; len < stats.columns.size(); len++) {
+            if (const auto* prefix = readSize({"prefix", std::to_string(len)})) {
+                stats.prefixes[len] = prefix->getSize();
+            }
+        }
     }
 }
 
@@ -59,4 +96,48 @@ size_t ProfileUseAnalysis::getRelationSize(const QualifiedName& rel) const {
     }
 }
 
+/**
+ * Check whether column statistics are defined in profile
+ */
+bool ProfileUseAnalysis::hasColumnStatistics(const QualifiedName& rel) const {
+    return statistics.count(rel.toString()) > 0;
+}
+
+/**
+ * Get number of distinct values of a column from profile
+ */
+size_t ProfileUseAnalysis::getDistinctValues(const QualifiedName& rel, size_t column) const {
+    auto stats = statistics.find(rel.toString());
+    if (stats == statistics.end() || column >= stats->second.columns.size()) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return stats->second.columns[column];
+}
+
+/**
+ * Estimate the fraction of tuples matching a binding of the given columns. A binding of a prefix
+ * of the columns uses the distinct prefixes, otherwise the columns are assumed to be independent.
+ */
+double ProfileUseAnalysis::getSelectivity(const QualifiedName& rel, const std::set<size_t>& columns) const {
+    auto stats = statistics.find(rel.toString());
+    if (stats == statistics.end() || columns.empty()) {
+        return 1.0;
+    }
+    const ColumnStatistics& cur = stats->second;
+    double distinct = 1.0;
+    auto prefix = cur.prefixes.find(columns.size());
+    if (*columns.rbegin() + 1 == columns.size() && prefix != cur.prefixes.end()) {
+        distinct = prefix->second;
+    } else {
+        for (size_t column : columns) {
+            if (column < cur.columns.size()) {
+                distinct *= std::max<size_t>(cur.columns[column], 1);
+            }
+        }
+    }
+    // the relation cannot have more distinct bindings than tuples
+    distinct = std::min(distinct, static_cast<double>(std::max<size_t>(cur.tuples, 1)));
+    return 1.0 / std::max(distinct, 1.0);
+}
+
 }  // namespace souffle::ast::analysis
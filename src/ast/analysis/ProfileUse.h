@@ -22,8 +22,11 @@
 #include "souffle/profile/ProgramRun.h"
 #include <cstddef>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 namespace souffle::ast {
 class TranslationUnit;
@@ -44,6 +47,11 @@ public:
     /** Run analysis */
     void run(const TranslationUnit& translationUnit) override;
 
+    /** The profile is read from a file, not the program */
+    ProgramParts getReadParts() const override {
+        return ProgramPart::None;
+    }
+
     /** Output some profile information */
     void print(std::ostream& os) const override;
 
@@ -53,9 +61,34 @@ public:
     /** Return size of relation in the profile */
     size_t getRelationSize(const QualifiedName& rel) const;
 
+    /** Check whether column statistics of the relation exist in profile */
+    bool hasColumnStatistics(const QualifiedName& rel) const;
+
+    /** Return estimated number of distinct values of a column of the relation */
+    size_t getDistinctValues(const QualifiedName& rel, size_t column) const;
+
+    /** Return estimated fraction of tuples of the relation matching a binding of the given columns */
+    double getSelectivity(const QualifiedName& rel, const std::set<size_t>& columns) const;
+
 private:
+    /** Column statistics of a relation */
+    struct ColumnStatistics {
+        /** number of tuples */
+        size_t tuples = 0;
+        /** number of distinct values of each column */
+        std::vector<size_t> columns;
+        /** number of distinct prefixes of each length */
+        std::map<size_t, size_t> prefixes;
+    };
+
+    /** Load column statistics from the profile database */
+    void loadStatistics();
+
     /** performance model of profile run */
     std::shared_ptr<profile::ProgramRun> programRun;
+
+    /** column statistics of the relations */
+    std::map<std::string, ColumnStatistics> statistics;
 };
 
 }  // namespace analysis
@@ -41,6 +41,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Relations | ProgramPart::Clauses;
+    }
+
     void print(std::ostream& os) const override;
 
     bool recursive(const Clause* clause) const {
@@ -42,6 +42,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Relations;
+    }
+
     void print(std::ostream& os) const override;
 
     const std::set<QualifiedName>& getRedundantRelations() const {
@@ -45,6 +45,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Relations | ProgramPart::Clauses;
+    }
+
     void print(std::ostream& os) const override;
 
     Relation* getRelation(const QualifiedName& name) const {
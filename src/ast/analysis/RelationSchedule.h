@@ -79,6 +79,11 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    /** the program is only read through other analyses */
+    ProgramParts getReadParts() const override {
+        return ProgramPart::None;
+    }
+
     const std::vector<RelationScheduleAnalysisStep>& schedule() const {
         return relationSchedule;
     }
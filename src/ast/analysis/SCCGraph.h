@@ -47,6 +47,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Relations;
+    }
+
     /** Get the number of SCCs in the graph. */
     size_t getNumberOfSCCs() const {
         return sccToRelation.size();
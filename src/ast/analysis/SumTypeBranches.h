@@ -33,6 +33,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Types;
+    }
+
     /**
      * A type can be nullptr in case of a malformed program.
      */
@@ -46,6 +46,11 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    /** the program is only read through other analyses */
+    ProgramParts getReadParts() const override {
+        return ProgramPart::None;
+    }
+
     const std::vector<size_t>& order() const {
         return sccOrder;
     }
@@ -56,6 +56,7 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace souffle::ast::analysis {
 
@@ -450,20 +451,34 @@ void TypeAnalysis::run(const TranslationUnit& translationUnit) {
     visitDepthFirst(
             program, [&](const FunctorDeclaration& fdecl) { udfDeclaration[fdecl.getName()] = &fdecl; });
 
+    // The analyses used per clause are obtained before clauses are analysed in parallel
+    translationUnit.getAnalysis<TypeEnvironmentAnalysis>();
+    translationUnit.getAnalysis<SumTypeBranchesAnalysis>();
+    const std::vector<Clause*> clauses = program.getClauses();
+
     // Rest of the analysis done until fixpoint reached
     bool changed = true;
     while (changed) {
         changed = false;
         argumentTypes.clear();
 
-        // Analyse general argument types, clause by clause.
-        for (const Clause* clause : program.getClauses()) {
-            auto clauseArgumentTypes = analyseTypes(translationUnit, *clause, debugStream);
-            argumentTypes.insert(clauseArgumentTypes.begin(), clauseArgumentTypes.end());
+        // Analyse general argument types, clause by clause. The clauses are independent,
+        // so they are analysed in parallel and their results merged in order.
+        std::vector<std::map<const Argument*, TypeSet>> clauseArgumentTypes(clauses.size());
+        std::vector<std::stringstream> clauseLogs(debugStream != nullptr ? clauses.size() : 0);
+#pragma omp parallel for schedule(dynamic)
+        for (std::size_t i = 0; i < clauses.size(); i++) {
+            std::ostream* logs = debugStream != nullptr ? &clauseLogs[i] : nullptr;
+            clauseArgumentTypes[i] = analyseTypes(translationUnit, *clauses[i], logs);
+        }
+
+        for (std::size_t i = 0; i < clauses.size(); i++) {
+            argumentTypes.insert(clauseArgumentTypes[i].begin(), clauseArgumentTypes[i].end());
 
             if (debugStream != nullptr) {
+                *debugStream << clauseLogs[i].str();
                 // Store an annotated clause for printing purposes
-                annotatedClauses.emplace_back(createAnnotatedClause(clause, clauseArgumentTypes));
+                annotatedClauses.emplace_back(createAnnotatedClause(clauses[i], clauseArgumentTypes[i]));
             }
         }
 
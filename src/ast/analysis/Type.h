@@ -50,6 +50,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Types | ProgramPart::Functors | ProgramPart::Relations | ProgramPart::Clauses;
+    }
+
     void print(std::ostream& os) const override;
 
     /** Get the computed types for the given argument. */
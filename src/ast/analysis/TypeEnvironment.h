@@ -37,6 +37,10 @@ public:
 
     void run(const TranslationUnit& translationUnit) override;
 
+    ProgramParts getReadParts() const override {
+        return ProgramPart::Types;
+    }
+
     void print(std::ostream& os) const override;
 
     const TypeEnvironment& getTypeEnvironment() const {
@@ -28,11 +28,15 @@
 #include "ast/Relation.h"
 #include "ast/TranslationUnit.h"
 #include "ast/Variable.h"
+#include "ast/analysis/IOType.h"
+#include "ast/analysis/SCCGraph.h"
+#include "ast/analysis/TypeEnvironment.h"
 #include "ast/utility/Utils.h"
 #include "parser/ParserDriver.h"
 #include "reports/DebugReport.h"
 #include "reports/ErrorReport.h"
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -228,4 +232,53 @@ TEST(Program, RemoveRelation) {
     EXPECT_EQ(tu1->getProgram(), tu2->getProgram());
 }
 
+/** test that only the analyses reading a modified part of the program are recomputed */
+TEST(TranslationUnit, InvalidateAnalyses) {
+    ErrorReport e;
+    DebugReport d;
+    Own<TranslationUnit> tu = ParserDriver::parseTranslationUnit(
+            R"(
+                   .type Node <: symbol
+                   .decl e ( a : Node , b : Node )
+                   .decl r ( from : Node , to : Node )
+                   .input e
+                   .output r
+
+                   r(X,Y) :- e(X,Y).
+                   r(X,Z) :- r(X,Y), r(Y,Z).
+            )",
+            e, d);
+
+    // the SCC graph uses the precedence graph, relation details and IO types
+    tu->getAnalysis<analysis::SCCGraphAnalysis>();
+    tu->getAnalysis<analysis::TypeEnvironmentAnalysis>();
+    std::size_t runs = tu->getAnalysisRuns();
+    EXPECT_EQ(5, runs);
+
+    // clauses invalidate the analyses of the SCC graph except the IO types
+    tu->invalidateAnalyses(ProgramPart::Clauses);
+    tu->getAnalysis<analysis::TypeEnvironmentAnalysis>();
+    tu->getAnalysis<analysis::IOTypeAnalysis>();
+    EXPECT_EQ(runs, tu->getAnalysisRuns());
+    tu->getAnalysis<analysis::SCCGraphAnalysis>();
+    EXPECT_EQ(runs + 3, tu->getAnalysisRuns());
+
+    // directives invalidate the IO types, and the SCC graph using them
+    runs = tu->getAnalysisRuns();
+    tu->invalidateAnalyses(ProgramPart::Directives);
+    tu->getAnalysis<analysis::SCCGraphAnalysis>();
+    EXPECT_EQ(runs + 2, tu->getAnalysisRuns());
+
+    runs = tu->getAnalysisRuns();
+    tu->invalidateAnalyses(ProgramPart::Types);
+    tu->getAnalysis<analysis::SCCGraphAnalysis>();
+    tu->getAnalysis<analysis::TypeEnvironmentAnalysis>();
+    EXPECT_EQ(runs + 1, tu->getAnalysisRuns());
+
+    runs = tu->getAnalysisRuns();
+    tu->invalidateAnalyses();
+    tu->getAnalysis<analysis::SCCGraphAnalysis>();
+    EXPECT_EQ(runs + 4, tu->getAnalysisRuns());
+}
+
 }  // namespace souffle::ast::test
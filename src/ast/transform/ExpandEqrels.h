@@ -28,6 +28,10 @@ public:
         return "ExpandEqrelsTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Relations | ProgramPart::Clauses;
+    }
+
 private:
     ExpandEqrelsTransformer* cloneImpl() const override {
         return new ExpandEqrelsTransformer();
@@ -51,6 +51,10 @@ public:
         return "FoldAnonymousRecords";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     FoldAnonymousRecords* cloneImpl() const override {
         return new FoldAnonymousRecords();
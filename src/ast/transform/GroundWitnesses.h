@@ -45,6 +45,10 @@ public:
         return "GroundWitnessesTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     GroundWitnessesTransformer* cloneImpl() const override {
         return new GroundWitnessesTransformer();
@@ -55,6 +55,10 @@ public:
         return "IOAttributesTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Directives;
+    }
+
 private:
     IOAttributesTransformer* cloneImpl() const override {
         return new IOAttributesTransformer();
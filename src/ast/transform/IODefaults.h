@@ -38,6 +38,10 @@ public:
         return "IODefaultsTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Directives;
+    }
+
 private:
     IODefaultsTransformer* cloneImpl() const override {
         return new IODefaultsTransformer();
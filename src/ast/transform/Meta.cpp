@@ -17,19 +17,25 @@
 #include "ast/transform/Meta.h"
 #include "souffle/utility/MiscUtil.h"
 #include <chrono>
+#include <cstddef>
 #include <iostream>
 
 namespace souffle::ast::transform {
 
 bool MetaTransformer::applySubtransformer(TranslationUnit& translationUnit, Transformer* transformer) {
+    const double analysisStart = translationUnit.getAnalysisTime();
+    const std::size_t analysisRuns = translationUnit.getAnalysisRuns();
     auto start = std::chrono::high_resolution_clock::now();
     bool changed = transformer->apply(translationUnit);
     auto end = std::chrono::high_resolution_clock::now();
 
     if (verbose && (!isA<MetaTransformer>(transformer))) {
         std::string changedString = changed ? "changed" : "unchanged";
+        // the time includes the analyses the transformer had to (re)compute
         std::cout << transformer->getName() << " time: " << std::chrono::duration<double>(end - start).count()
-                  << "sec [" << changedString << "]" << std::endl;
+                  << "sec [" << changedString << "], analysis time: "
+                  << translationUnit.getAnalysisTime() - analysisStart << "sec ("
+                  << translationUnit.getAnalysisRuns() - analysisRuns << " analyses)" << std::endl;
     }
 
     return changed;
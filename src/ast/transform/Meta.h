@@ -44,6 +44,11 @@ public:
     /* Disable subtransformers */
     virtual void disableTransformers(const std::set<std::string>& transforms) = 0;
 
+    /* Nested transformers invalidate the analyses affected by their own changes */
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::None;
+    }
+
     /* Apply a nested transformer */
     bool applySubtransformer(TranslationUnit& translationUnit, Transformer* transformer);
 };
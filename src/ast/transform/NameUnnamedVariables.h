@@ -35,6 +35,10 @@ public:
         return "NameUnnamedVariablesTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     NameUnnamedVariablesTransformer* cloneImpl() const override {
         return new NameUnnamedVariablesTransformer();
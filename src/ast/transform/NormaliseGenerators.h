@@ -28,6 +28,10 @@ public:
         return "NormaliseGeneratorsTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     bool transform(TranslationUnit& translationUnit) override;
 
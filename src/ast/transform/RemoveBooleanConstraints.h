@@ -30,6 +30,10 @@ public:
         return "RemoveBooleanConstraintsTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     RemoveBooleanConstraintsTransformer* cloneImpl() const override {
         return new RemoveBooleanConstraintsTransformer();
@@ -32,6 +32,10 @@ public:
         return "RemoveRedundantSumsTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     RemoveRedundantSumsTransformer* cloneImpl() const override {
         return new RemoveRedundantSumsTransformer();
@@ -37,6 +37,10 @@ public:
         return "ReorderLiteralsTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
     /**
      * Reorder the clause based on a given SIPS function.
      * @param sipsFunction SIPS metric to use
@@ -31,6 +31,10 @@ public:
         return "ReplaceSingletonVariablesTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     ReplaceSingletonVariablesTransformer* cloneImpl() const override {
         return new ReplaceSingletonVariablesTransformer();
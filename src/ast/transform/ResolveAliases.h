@@ -34,6 +34,10 @@ public:
         return "ResolveAliasesTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
     /**
      * Converts the given clause into a version without variables aliasing
      * grounded variables.
@@ -38,6 +38,10 @@ public:
         return "ResolveAnonymousRecordAliases";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     ResolveAnonymousRecordAliasesTransformer* cloneImpl() const override {
         return new ResolveAnonymousRecordAliasesTransformer();
@@ -32,6 +32,10 @@ public:
         return "SimplifyAggregateTargetExpressionTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     SimplifyAggregateTargetExpressionTransformer* cloneImpl() const override {
         return new SimplifyAggregateTargetExpressionTransformer();
@@ -24,8 +24,8 @@ bool Transformer::apply(TranslationUnit& translationUnit) {
     // invoke the transformation
     bool changed = transform(translationUnit);
 
-    if (changed) {
-        translationUnit.invalidateAnalyses();
+    if (changed && getModifiedParts() != ProgramPart::None) {
+        translationUnit.invalidateAnalyses(getModifiedParts());
     }
 
     /* Abort evaluation of the program if errors were encountered */
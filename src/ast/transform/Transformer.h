@@ -33,6 +33,11 @@ public:
 
     virtual std::string getName() const = 0;
 
+    /** Get the parts of the program the transformer may modify, whose analyses are invalidated */
+    virtual ProgramParts getModifiedParts() const {
+        return ProgramPart::All;
+    }
+
     Own<Transformer> clone() const {
         return Own<Transformer>(cloneImpl());
     }
@@ -29,6 +29,10 @@ public:
         return "UniqueAggregationVariablesTransformer";
     }
 
+    ProgramParts getModifiedParts() const override {
+        return ProgramPart::Clauses;
+    }
+
 private:
     UniqueAggregationVariablesTransformer* cloneImpl() const override {
         return new UniqueAggregationVariablesTransformer();
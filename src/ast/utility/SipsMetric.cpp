@@ -24,22 +24,31 @@
 #include "ast/utility/BindingStore.h"
 #include "ast/utility/Utils.h"
 #include "ast/utility/Visitor.h"
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <set>
 #include <vector>
 
 namespace souffle::ast {
 
-std::vector<unsigned int> SipsMetric::getReordering(const Clause* clause) const {
+std::vector<unsigned int> SipsMetric::getReordering(
+        const Clause* clause, const std::vector<unsigned int>& prefix) const {
     BindingStore bindingStore(clause);
     auto atoms = getBodyLiterals<Atom>(*clause);
     std::vector<unsigned int> newOrder(atoms.size());
+    assert(prefix.size() <= atoms.size() && "prefix should not exceed the number of atoms");
 
     size_t numAdded = 0;
     while (numAdded < atoms.size()) {
-        // grab the index of the next atom, based on the SIPS function
-        const auto& costs = evaluateCosts(atoms, bindingStore);
-        auto minIdx = std::distance(costs.begin(), std::min_element(costs.begin(), costs.end()));
+        // grab the index of the next atom, based on the prefix or the SIPS function
+        size_t minIdx;
+        if (numAdded < prefix.size()) {
+            minIdx = prefix[numAdded];
+        } else {
+            const auto& costs = evaluateCosts(atoms, bindingStore);
+            minIdx = std::distance(costs.begin(), std::min_element(costs.begin(), costs.end()));
+        }
         const auto* nextAtom = atoms[minIdx];
         assert(nextAtom != nullptr && "nullptr atoms should have maximal cost");
 
@@ -236,7 +245,8 @@ std::vector<double> LeastFreeVarsSips::evaluateCosts(
 std::vector<double> ProfileUseSips::evaluateCosts(
         const std::vector<Atom*> atoms, const BindingStore& bindingStore) const {
     // Goal: reorder based on the given profiling information
-    // Metric: cost(atom_R) = log(|atom_R|) * #free/#args
+    // Metric: cost(atom_R) = log(|atom_R| * selectivity(bound args)) with column statistics,
+    //         cost(atom_R) = log(|atom_R|) * #free/#args otherwise
     //         - exception: propositions are prioritised
     std::vector<double> cost;
     for (const auto* atom : atoms) {
@@ -252,11 +262,28 @@ std::vector<double> ProfileUseSips::evaluateCosts(
             continue;
         }
 
+        const auto& name = atom->getQualifiedName();
+        double size = profileUse.getRelationSize(name);
+        if (profileUse.hasColumnStatistics(name)) {
+            // estimate the number of matching tuples per binding of the bound arguments
+            std::set<size_t> boundColumns;
+            const auto& args = atom->getArguments();
+            for (size_t i = 0; i < args.size(); i++) {
+                if (bindingStore.isBound(args[i])) {
+                    boundColumns.insert(i);
+                }
+            }
+            double matches = size * profileUse.getSelectivity(name, boundColumns);
+            cost.push_back(log(std::max(matches, 1.0)));
+            continue;
+        }
+
         // calculate log(|R|) * #free/#args
         int numBound = bindingStore.numBoundArguments(atom);
         int numFree = arity - numBound;
-        double value = log(profileUse.getRelationSize(atom->getQualifiedName()));
+        double value = log(size);
         value *= (numFree * 1.0) / arity;
+        cost.push_back(value);
     }
     return cost;
 }
@@ -43,9 +43,11 @@ public:
     /**
      * Determines the new ordering of a clause after the SIPS is applied.
      * @param clause clause to reorder
+     * @param prefix positions of the atoms that are scheduled first, in this order
      * @return the vector of new positions; v[i] = j iff atom j moves to pos i
      */
-    std::vector<unsigned int> getReordering(const Clause* clause) const;
+    std::vector<unsigned int> getReordering(
+            const Clause* clause, const std::vector<unsigned int>& prefix = {}) const;
 
     /** Create a SIPS metric based on a given heuristic. */
     static std::unique_ptr<SipsMetric> create(const std::string& heuristic, const TranslationUnit& tu);
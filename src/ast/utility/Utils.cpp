@@ -123,7 +123,7 @@ void removeRelationClauses(TranslationUnit& tu, const QualifiedName& name) {
         program.removeClause(clause.get());
     }
 
-    tu.invalidateAnalyses();
+    tu.invalidateAnalyses(ProgramPart::Clauses);
 }
 
 void removeRelationIOs(TranslationUnit& tu, const QualifiedName& name) {
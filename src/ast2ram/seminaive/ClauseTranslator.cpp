@@ -28,13 +28,16 @@
 #include "ast/Relation.h"
 #include "ast/StringConstant.h"
 #include "ast/UnnamedVariable.h"
+#include "ast/Variable.h"
 #include "ast/analysis/Functor.h"
+#include "ast/utility/SipsMetric.h"
 #include "ast/utility/Utils.h"
 #include "ast/utility/Visitor.h"
 #include "ast2ram/utility/Location.h"
 #include "ast2ram/utility/TranslatorContext.h"
 #include "ast2ram/utility/Utils.h"
 #include "ast2ram/utility/ValueIndex.h"
+#include "ram/Adaptive.h"
 #include "ram/Aggregate.h"
 #include "ram/Break.h"
 #include "ram/Constraint.h"
@@ -45,10 +48,12 @@
 #include "ram/FloatConstant.h"
 #include "ram/GuardedProject.h"
 #include "ram/LogRelationTimer.h"
+#include "ram/LogTimer.h"
 #include "ram/Negation.h"
 #include "ram/NestedIntrinsicOperator.h"
 #include "ram/Project.h"
 #include "ram/Query.h"
+#include "ram/RelationSize.h"
 #include "ram/Scan.h"
 #include "ram/Sequence.h"
 #include "ram/SignedConstant.h"
@@ -59,6 +64,9 @@
 #include "souffle/SymbolTable.h"
 #include "souffle/utility/StringUtil.h"
 #include <map>
+#include <numeric>
+#include <set>
+#include <string>
 #include <vector>
 
 namespace souffle::ast2ram::seminaive {
@@ -100,8 +108,9 @@ Own<ram::Statement> ClauseTranslator::translateRecursiveClause(
             [&](const ast::Atom* atom) { return contains(scc, context.getAtomRelation(atom)); });
     this->version = version;
 
-    // Translate the resultant clause as would be done normally
-    Own<ram::Statement> rule = translateNonRecursiveClause(clause);
+    // Translate the resultant clause as would be done normally, or with join orders chosen at runtime
+    Own<ram::Statement> rule = Global::config().has("adaptive-joins") ? createAdaptiveRuleQuery(clause)
+                                                                       : translateNonRecursiveClause(clause);
 
     // Add logging
     if (Global::config().has("profile")) {
@@ -172,6 +181,43 @@ Own<ram::Statement> ClauseTranslator::createRamRuleQuery(const ast::Clause& clau
     return mk<ram::Query>(std::move(op));
 }
 
+Own<ram::Statement> ClauseTranslator::createAdaptiveRuleQuery(const ast::Clause& clause) {
+    const auto& orders = getAlternativeOrderings(clause);
+    if (orders.size() < 2) {
+        return translateNonRecursiveClause(clause);
+    }
+
+    const auto& atoms = ast::getBodyLiterals<ast::Atom>(clause);
+    VecOwn<ram::Expression> costs;
+    VecOwn<ram::Statement> alternatives;
+    for (const auto& order : orders) {
+        // Translate the clause with the alternative ordering from scratch
+        atomOrder = order;
+        operators.clear();
+        generators.clear();
+        Own<ram::Statement> query = createRamRuleQuery(clause);
+
+        // Log the chosen ordering of each iteration
+        if (Global::config().has("profile")) {
+            std::vector<std::string> atomNames;
+            for (unsigned int i : order) {
+                atomNames.push_back(getClauseAtomName(clause, atoms.at(i)));
+            }
+            const std::string logTimerStatement = LogStatement::tRecursiveRuleOrder(
+                    getConcreteRelationName(clause.getHead()->getQualifiedName()), version,
+                    toString(join(atomNames, ",")), clause.getSrcLoc(), stringify(toString(clause)));
+            query = mk<ram::LogTimer>(std::move(query), logTimerStatement);
+        }
+
+        // The outermost atom is scanned in full, so its size estimates the cost of the join
+        costs.push_back(mk<ram::RelationSize>(getClauseAtomName(clause, atoms.at(order.front()))));
+        alternatives.push_back(std::move(query));
+    }
+    atomOrder.clear();
+
+    return mk<ram::Adaptive>(std::move(costs), std::move(alternatives));
+}
+
 Own<ram::Operation> ClauseTranslator::addEntryPoint(const ast::Clause& clause, Own<ram::Operation> op) const {
     auto cond = createCondition(clause);
     return cond != nullptr ? mk<ram::Filter>(std::move(cond), std::move(op)) : std::move(op);
@@ -606,6 +652,10 @@ Own<ram::Condition> ClauseTranslator::getFunctionalDependencies(const ast::Claus
 std::vector<ast::Atom*> ClauseTranslator::getAtomOrdering(const ast::Clause& clause) const {
     auto atoms = ast::getBodyLiterals<ast::Atom>(clause);
 
+    if (!atomOrder.empty()) {
+        return reorderAtoms(atoms, atomOrder);
+    }
+
     const auto& plan = clause.getExecutionPlan();
     if (plan == nullptr) {
         return atoms;
@@ -625,6 +675,56 @@ std::vector<ast::Atom*> ClauseTranslator::getAtomOrdering(const ast::Clause& cla
     return reorderAtoms(atoms, newOrder);
 }
 
+std::vector<std::vector<unsigned int>> ClauseTranslator::getAlternativeOrderings(
+        const ast::Clause& clause) const {
+    // bound the number of alternatives to keep the size of the generated code in check
+    constexpr size_t maxAlternatives = 4;
+    std::vector<std::vector<unsigned int>> orders;
+
+    // an ordering imposed by a plan is kept as is
+    const auto& plan = clause.getExecutionPlan();
+    if (plan != nullptr && contains(plan->getOrders(), version)) {
+        return orders;
+    }
+
+    // count the atoms that do not share a named variable with the atoms before; constants and
+    // unnamed variables do not connect atoms, as they do not restrict the tuples of one atom by
+    // the tuples of another
+    const auto& atoms = ast::getBodyLiterals<ast::Atom>(clause);
+    auto countCrossProducts = [&](const std::vector<unsigned int>& order) {
+        std::set<std::string> boundVariables;
+        size_t crossProducts = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            const auto* atom = atoms.at(order[i]);
+            bool isConnected = atom->getArity() == 0 || i == 0;
+            visitDepthFirst(*atom, [&](const ast::Variable& var) {
+                isConnected = isConnected || contains(boundVariables, var.getName());
+            });
+            crossProducts += isConnected ? 0 : 1;
+            visitDepthFirst(*atom, [&](const ast::Variable& var) { boundVariables.insert(var.getName()); });
+        }
+        return crossProducts;
+    };
+
+    // the default ordering comes first so that it wins ties
+    std::vector<unsigned int> defaultOrder(atoms.size());
+    std::iota(defaultOrder.begin(), defaultOrder.end(), 0);
+    orders.push_back(defaultOrder);
+    const size_t defaultCrossProducts = countCrossProducts(defaultOrder);
+
+    // start the join with each other atom, and order the remaining atoms with the SIPS
+    for (unsigned int i = 1; i < atoms.size() && orders.size() < maxAlternatives; i++) {
+        if (atoms[i]->getArity() == 0) {
+            continue;
+        }
+        auto order = context.getSipsMetric()->getReordering(&clause, {i});
+        if (countCrossProducts(order) <= defaultCrossProducts && !contains(orders, order)) {
+            orders.push_back(order);
+        }
+    }
+    return orders;
+}
+
 int ClauseTranslator::addOperatorLevel(const ast::Node* node) {
     int nodeLevel = operators.size() + generators.size();
     operators.push_back(node);
@@ -67,6 +67,9 @@ protected:
     size_t version{0};
     std::vector<ast::Atom*> sccAtoms{};
 
+    /** Atom ordering imposed on the translated clause, if not empty */
+    std::vector<unsigned int> atomOrder{};
+
     bool isRecursive() const;
 
     std::string getClauseString(const ast::Clause& clause) const;
@@ -82,11 +85,13 @@ protected:
     /** Main clause translation */
     virtual Own<ram::Statement> createRamFactQuery(const ast::Clause& clause) const;
     virtual Own<ram::Statement> createRamRuleQuery(const ast::Clause& clause);
+    Own<ram::Statement> createAdaptiveRuleQuery(const ast::Clause& clause);
 
     virtual Own<ram::Operation> createProjection(const ast::Clause& clause) const;
     virtual Own<ram::Condition> createCondition(const ast::Clause& clause) const;
 
     std::vector<ast::Atom*> getAtomOrdering(const ast::Clause& clause) const;
+    std::vector<std::vector<unsigned int>> getAlternativeOrderings(const ast::Clause& clause) const;
 
     /** Indexing */
     void indexClause(const ast::Clause& clause);
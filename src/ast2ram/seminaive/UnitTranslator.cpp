@@ -27,14 +27,18 @@
 #include "ram/Call.h"
 #include "ram/Clear.h"
 #include "ram/Condition.h"
+#include "ram/Constant.h"
 #include "ram/Conjunction.h"
 #include "ram/Constraint.h"
+#include "ram/Dataflow.h"
 #include "ram/DebugInfo.h"
 #include "ram/EmptinessCheck.h"
 #include "ram/Exit.h"
 #include "ram/Expression.h"
 #include "ram/Extend.h"
+#include "ram/Facts.h"
 #include "ram/Filter.h"
+#include "ram/GuardedProject.h"
 #include "ram/IO.h"
 #include "ram/LogRelationTimer.h"
 #include "ram/LogSize.h"
@@ -64,12 +68,14 @@
 #include "souffle/utility/FunctionalUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/StringUtil.h"
+#include "souffle/utility/json11.h"
 #include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
@@ -91,25 +97,47 @@ Own<ram::Statement> UnitTranslator::generateClearRelation(const ast::Relation* r
     return mk<ram::Clear>(getConcreteRelationName(relation->getQualifiedName()));
 }
 
-Own<ram::Statement> UnitTranslator::generateNonRecursiveRelation(const ast::Relation& rel) const {
-    VecOwn<ram::Statement> result;
-    std::string relName = getConcreteRelationName(rel.getQualifiedName());
+namespace {
 
-    // Iterate over all non-recursive clauses that belong to the relation
-    for (const auto* clause : context->getClauses(rel.getQualifiedName())) {
-        // Skip recursive rules
-        if (context->isRecursiveClause(clause)) {
-            continue;
+/**
+ * Append the values of a fact translated to a projection of constants only, returning
+ * whether the fact is of that form.
+ */
+bool appendConstantFact(const ram::Statement& stmt, std::vector<RamDomain>& values) {
+    const auto* query = as<ram::Query>(stmt);
+    if (query == nullptr) {
+        return false;
+    }
+    // projections guarded by functional dependencies insert conditionally
+    const auto* project = as<ram::Project>(query->getOperation());
+    if (project == nullptr || isA<ram::GuardedProject>(project) || project->getValues().empty()) {
+        return false;
+    }
+    std::vector<RamDomain> row;
+    for (const auto* value : project->getValues()) {
+        const auto* constant = as<ram::Constant>(value);
+        if (constant == nullptr) {
+            return false;
         }
+        row.push_back(constant->getConstant());
+    }
+    values.insert(values.end(), row.begin(), row.end());
+    return true;
+}
 
-        // Translate clause
-        Own<ram::Statement> rule = context->translateNonRecursiveClause(*symbolTable, *clause);
+}  // namespace
 
+Own<ram::Statement> UnitTranslator::generateNonRecursiveRelation(const ast::Relation& rel) const {
+    VecOwn<ram::Statement> result;
+    std::string relName = getConcreteRelationName(rel.getQualifiedName());
+
+    // Add the logging and debug information of a rule
+    auto addRule = [&](const ast::Clause& clause, Own<ram::Statement> rule) {
         // Add logging
         if (Global::config().has("profile")) {
             const std::string& relationName = toString(rel.getQualifiedName());
-            const auto& srcLocation = clause->getSrcLoc();
-            const std::string clauseText = stringify(toString(*clause));
+            const auto& srcLocation = clause.getSrcLoc();
+            const std::string clauseText = stringify(toString(clause));
             const std::string logTimerStatement =
                     LogStatement::tNonrecursiveRule(relationName, srcLocation, clauseText);
             rule = mk<ram::LogRelationTimer>(std::move(rule), logTimerStatement, relName);
@@ -117,12 +145,44 @@ Own<ram::Statement> UnitTranslator::generateNonRecursiveRelation(const ast::Rela
 
         // Add debug info
         std::ostringstream ds;
-        ds << toString(*clause) << "\nin file ";
-        ds << clause->getSrcLoc();
+        ds << toString(clause) << "\nin file ";
+        ds << clause.getSrcLoc();
         rule = mk<ram::DebugInfo>(std::move(rule), ds.str());
 
         // Add rule to result
         appendStmt(result, std::move(rule));
+    };
+
+    // Facts of constants only, inserted together as a single table
+    std::vector<std::pair<const ast::Clause*, Own<ram::Statement>>> facts;
+    std::vector<RamDomain> factValues;
+
+    // Iterate over all non-recursive clauses that belong to the relation
+    for (const auto* clause : context->getClauses(rel.getQualifiedName())) {
+        // Skip recursive rules
+        if (context->isRecursiveClause(clause)) {
+            continue;
+        }
+
+        // Translate clause
+        Own<ram::Statement> rule = context->translateNonRecursiveClause(*symbolTable, *clause);
+        if (isFact(*clause) && appendConstantFact(*rule, factValues)) {
+            facts.emplace_back(clause, std::move(rule));
+            continue;
+        }
+        addRule(*clause, std::move(rule));
+    }
+
+    // A single fact stays a query
+    if (facts.size() == 1) {
+        addRule(*facts.front().first, std::move(facts.front().second));
+    } else if (!facts.empty()) {
+        const std::size_t arity = factValues.size() / facts.size();
+        Own<ram::Statement> table = mk<ram::Facts>(relName, arity, std::move(factValues));
+        std::ostringstream ds;
+        ds << facts.size() << " facts of " << rel.getQualifiedName() << "\nin file ";
+        ds << facts.front().first->getSrcLoc();
+        result.insert(result.begin(), mk<ram::DebugInfo>(std::move(table), ds.str()));
     }
 
     // Add logging for entire relation
@@ -155,6 +215,9 @@ Own<ram::Statement> UnitTranslator::generateStratum(size_t scc) const {
     // load all internal input relations from the facts dir with a .facts extension
     for (const auto& relation : context->getInputRelationsInSCC(scc)) {
         appendStmt(current, generateLoadRelation(relation));
+        if (Global::config().has("profile-statistics", "input")) {
+            appendStmt(current, generateRelationStatistics(relation));
+        }
     }
 
     // Compute the current stratum
@@ -167,6 +230,13 @@ Own<ram::Statement> UnitTranslator::generateStratum(size_t scc) const {
         appendStmt(current, generateNonRecursiveRelation(*relation));
     }
 
+    // Collect the column statistics of the computed relations
+    if (Global::config().has("profile-statistics", "all")) {
+        for (const auto* relation : sccRelations) {
+            appendStmt(current, generateRelationStatistics(relation));
+        }
+    }
+
     // Store all internal output relations to the output dir with a .csv extension
     for (const auto& relation : context->getOutputRelationsInSCC(scc)) {
         appendStmt(current, generateStoreRelation(relation));
@@ -386,6 +456,12 @@ Own<ram::Statement> UnitTranslator::generateLoadRelation(const ast::Relation* re
         }
         addAuxiliaryArity(relation, directives);
 
+        // Input files can be read ahead of the stratum, whereas the standard input is read in order
+        if (Global::config().has("prefetch-input") &&
+                (directives["IO"] == "file" || directives["IO"] == "jsonfile")) {
+            directives.insert(std::make_pair("prefetch", "true"));
+        }
+
         // Create the resultant load statement, with profile information
         std::string ramRelationName = getConcreteRelationName(relation->getQualifiedName());
         Own<ram::Statement> loadStmt = mk<ram::IO>(ramRelationName, directives);
@@ -410,6 +486,13 @@ Own<ram::Statement> UnitTranslator::generateStoreRelation(const ast::Relation* r
         }
         addAuxiliaryArity(relation, directives);
 
+        // Output files can be written in the background, whereas the order of the standard output
+        // is kept
+        if (Global::config().has("async-output") &&
+                (directives["IO"] == "file" || directives["IO"] == "jsonfile")) {
+            directives.insert(std::make_pair("async", "true"));
+        }
+
         // Create the resultant store statement, with profile information
         std::string ramRelationName = getConcreteRelationName(relation->getQualifiedName());
         Own<ram::Statement> storeStmt = mk<ram::IO>(ramRelationName, directives);
@@ -424,6 +507,48 @@ Own<ram::Statement> UnitTranslator::generateStoreRelation(const ast::Relation* r
     return mk<ram::Sequence>(std::move(storeStmts));
 }
 
+Own<ram::Statement> UnitTranslator::generateRelationStatistics(const ast::Relation* relation) const {
+    // The statistics are collected by an output statement with its own writer, which only needs to
+    // know the attribute types of the relation
+    std::vector<json11::Json> attributeTypes;
+    for (const auto* attribute : relation->getAttributes()) {
+        attributeTypes.push_back(context->getAttributeTypeQualifier(attribute->getTypeName()));
+    }
+    json11::Json relationTypes = json11::Json::object{
+            {"arity", static_cast<long long>(relation->getArity())}, {"types", attributeTypes}};
+    json11::Json types = json11::Json::object{{"relation", relationTypes}};
+
+    std::string ramRelationName = getConcreteRelationName(relation->getQualifiedName());
+    std::map<std::string, std::string> directives;
+    directives.insert(std::make_pair("IO", "statistics"));
+    directives.insert(std::make_pair("operation", "statistics"));
+    directives.insert(std::make_pair("name", ramRelationName));
+    directives.insert(std::make_pair("types", types.dump()));
+    addAuxiliaryArity(relation, directives);
+    return mk<ram::IO>(ramRelationName, directives);
+}
+
+Own<ram::Statement> UnitTranslator::generateSpillRelation(
+        const ast::Relation* relation, const std::string& operation) const {
+    // Spilled relations are written in a raw format, which only needs to know the arity
+    std::vector<json11::Json> attributeTypes;
+    for (const auto* attribute : relation->getAttributes()) {
+        attributeTypes.push_back(context->getAttributeTypeQualifier(attribute->getTypeName()));
+    }
+    json11::Json relationTypes = json11::Json::object{
+            {"arity", static_cast<long long>(relation->getArity())}, {"types", attributeTypes}};
+    json11::Json types = json11::Json::object{{"relation", relationTypes}};
+
+    std::string ramRelationName = getConcreteRelationName(relation->getQualifiedName());
+    std::map<std::string, std::string> directives;
+    directives.insert(std::make_pair("IO", "spill"));
+    directives.insert(std::make_pair("operation", operation));
+    directives.insert(std::make_pair("name", ramRelationName));
+    directives.insert(std::make_pair("types", types.dump()));
+    addAuxiliaryArity(relation, directives);
+    return mk<ram::IO>(ramRelationName, directives);
+}
+
 Own<ram::Relation> UnitTranslator::createRamRelation(
         const ast::Relation* baseRelation, std::string ramRelationName) const {
     auto arity = baseRelation->getArity();
@@ -472,14 +597,19 @@ Own<ram::Sequence> UnitTranslator::generateProgram(const ast::TranslationUnit& t
     const auto& sccOrdering =
             translationUnit.getAnalysis<ast::analysis::TopologicallySortedSCCGraphAnalysis>()->order();
 
+    // Strata run concurrently in dataflow mode, which clears the expired relations by itself
+    const bool dataflow = Global::config().has("concurrent-strata");
+
     // Create subroutines for each SCC according to topological order
     for (size_t i = 0; i < sccOrdering.size(); i++) {
         // Generate the main stratum code
         auto stratum = generateStratum(sccOrdering.at(i));
 
         // Clear expired relations
-        const auto& expiredRelations = context->getExpiredRelations(i);
-        stratum = mk<ram::Sequence>(std::move(stratum), generateClearExpiredRelations(expiredRelations));
+        if (!dataflow) {
+            const auto& expiredRelations = context->getExpiredRelations(i);
+            stratum = mk<ram::Sequence>(std::move(stratum), generateClearExpiredRelations(expiredRelations));
+        }
 
         // Add the subroutine
         std::string stratumID = "stratum_" + toString(i);
@@ -488,8 +618,14 @@ Own<ram::Sequence> UnitTranslator::generateProgram(const ast::TranslationUnit& t
 
     // Invoke all strata
     VecOwn<ram::Statement> res;
-    for (size_t i = 0; i < sccOrdering.size(); i++) {
-        appendStmt(res, mk<ram::Call>("stratum_" + toString(i)));
+    if (dataflow) {
+        appendStmt(res, generateDataflow(sccOrdering));
+    } else if (Global::config().has("memory-limit") || Global::config().has("compress-spills")) {
+        appendStmt(res, generateSpillingStrata(sccOrdering));
+    } else {
+        for (size_t i = 0; i < sccOrdering.size(); i++) {
+            appendStmt(res, mk<ram::Call>("stratum_" + toString(i)));
+        }
     }
 
     // Add main timer if profiling
@@ -503,6 +639,123 @@ Own<ram::Sequence> UnitTranslator::generateProgram(const ast::TranslationUnit& t
     return mk<ram::Sequence>(std::move(res));
 }
 
+Own<ram::Statement> UnitTranslator::generateDataflow(const std::vector<size_t>& sccOrdering) const {
+    VecOwn<ram::Statement> steps;
+    std::vector<std::vector<size_t>> predecessors;
+    auto addStep = [&](Own<ram::Statement> step, std::set<size_t> after) {
+        appendStmt(steps, std::move(step));
+        predecessors.emplace_back(after.begin(), after.end());
+        return steps.size() - 1;
+    };
+
+    std::map<size_t, size_t> stratumStep;
+    std::optional<size_t> lastSharedStream;
+    for (size_t i = 0; i < sccOrdering.size(); i++) {
+        const size_t scc = sccOrdering.at(i);
+
+        // A stratum starts once the strata computing the relations it reads have finished
+        std::set<size_t> after;
+        for (size_t pred : context->getPredecessorSCCs(scc)) {
+            after.insert(stratumStep.at(pred));
+        }
+
+        // Strata sharing a stream, such as the standard output, keep their order
+        const bool sharedStream = hasSharedStream(scc);
+        if (sharedStream && lastSharedStream.has_value()) {
+            after.insert(*lastSharedStream);
+        }
+
+        stratumStep[scc] = addStep(mk<ram::Call>("stratum_" + toString(i)), std::move(after));
+        if (sharedStream) {
+            lastSharedStream = stratumStep[scc];
+        }
+
+        // An expired relation is cleared as soon as the last of the strata reading it has
+        // finished, i.e., once the count of the strata still reading it drops to zero
+        for (const auto* rel : context->getExpiredRelations(i)) {
+            std::set<size_t> readers;
+            readers.insert(stratumStep.at(context->getSCC(rel)));
+            for (size_t reader : context->getSuccessorSCCs(rel)) {
+                readers.insert(stratumStep.at(reader));
+            }
+            addStep(generateClearExpiredRelations({rel}), std::move(readers));
+        }
+    }
+
+    // The number of strata running at once is limited, not the memory of their relations
+    const size_t concurrencyLimit = std::stoul(Global::config().get("concurrent-strata"));
+    return mk<ram::Dataflow>(std::move(steps), std::move(predecessors), concurrencyLimit);
+}
+
+Own<ram::Statement> UnitTranslator::generateSpillingStrata(const std::vector<size_t>& sccOrdering) const {
+    std::map<size_t, size_t> position;
+    for (size_t i = 0; i < sccOrdering.size(); i++) {
+        position[sccOrdering.at(i)] = i;
+    }
+
+    // Strata using each relation, i.e., the stratum computing it and the strata reading it
+    std::vector<std::pair<const ast::Relation*, std::set<size_t>>> uses;
+    for (const auto* rel : context->getProgram()->getRelations()) {
+        if (rel->getArity() == 0) {
+            continue;
+        }
+        auto& strata = uses.emplace_back(rel, std::set<size_t>()).second;
+        strata.insert(position.at(context->getSCC(rel)));
+        for (size_t reader : context->getSuccessorSCCs(rel)) {
+            strata.insert(position.at(reader));
+        }
+    }
+
+    VecOwn<ram::Statement> res;
+    for (size_t i = 0; i < sccOrdering.size(); i++) {
+        // Restore the spilled relations that the stratum reads
+        for (const auto& [rel, strata] : uses) {
+            if (*strata.begin() < i && contains(strata, i)) {
+                appendStmt(res, generateSpillRelation(rel, "restore"));
+            }
+        }
+
+        appendStmt(res, mk<ram::Call>("stratum_" + toString(i)));
+
+        // Relations that are computed but not needed by the next stratum can be spilled,
+        // those needed last first
+        std::vector<std::pair<size_t, const ast::Relation*>> cold;
+        for (const auto& [rel, strata] : uses) {
+            auto next = strata.upper_bound(i);
+            if (*strata.begin() <= i && next != strata.end() && *next > i + 1) {
+                cold.emplace_back(*next, rel);
+            }
+        }
+        std::stable_sort(cold.begin(), cold.end(),
+                [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+        for (const auto& cur : cold) {
+            appendStmt(res, generateSpillRelation(cur.second, "spill"));
+        }
+    }
+    return mk<ram::Sequence>(std::move(res));
+}
+
+bool UnitTranslator::hasSharedStream(size_t scc) const {
+    auto isShared = [&](const std::vector<ast::Directive*>& directives) {
+        return any_of(directives, [&](const ast::Directive* directive) {
+            const auto& params = directive->getParameters();
+            const auto io = params.find("IO");
+            return io == params.end() || (io->second != "file" && io->second != "jsonfile");
+        });
+    };
+    for (const auto* rel : context->getInputRelationsInSCC(scc)) {
+        if (isShared(context->getLoadDirectives(rel->getQualifiedName()))) {
+            return true;
+        }
+    }
+    for (const auto* rel : context->getOutputRelationsInSCC(scc)) {
+        if (isShared(context->getStoreDirectives(rel->getQualifiedName()))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 Own<ram::TranslationUnit> UnitTranslator::translateUnit(ast::TranslationUnit& tu) {
     /* -- Set-up -- */
     auto ram_start = std::chrono::high_resolution_clock::now();
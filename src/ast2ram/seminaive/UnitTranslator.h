@@ -64,12 +64,18 @@ protected:
 
     /** High-level relation translation */
     virtual Own<ram::Sequence> generateProgram(const ast::TranslationUnit& translationUnit);
+    Own<ram::Statement> generateDataflow(const std::vector<size_t>& sccOrdering) const;
+    Own<ram::Statement> generateSpillingStrata(const std::vector<size_t>& sccOrdering) const;
     Own<ram::Statement> generateNonRecursiveRelation(const ast::Relation& rel) const;
     Own<ram::Statement> generateRecursiveStratum(const std::set<const ast::Relation*>& scc) const;
 
     /** IO translation */
     Own<ram::Statement> generateStoreRelation(const ast::Relation* relation) const;
     Own<ram::Statement> generateLoadRelation(const ast::Relation* relation) const;
+    Own<ram::Statement> generateRelationStatistics(const ast::Relation* relation) const;
+    Own<ram::Statement> generateSpillRelation(
+            const ast::Relation* relation, const std::string& operation) const;
+    bool hasSharedStream(size_t scc) const;
 
     /** Low-level stratum translation */
     Own<ram::Statement> generateStratum(size_t scc) const;
@@ -146,6 +146,18 @@ std::set<const ast::Relation*> TranslatorContext::getOutputRelationsInSCC(size_t
     return sccGraph->getInternalOutputRelations(scc);
 }
 
+size_t TranslatorContext::getSCC(const ast::Relation* relation) const {
+    return sccGraph->getSCC(relation);
+}
+
+std::set<size_t> TranslatorContext::getPredecessorSCCs(size_t scc) const {
+    return sccGraph->getPredecessorSCCs(scc);
+}
+
+std::set<size_t> TranslatorContext::getSuccessorSCCs(const ast::Relation* relation) const {
+    return sccGraph->getSuccessorSCCs(relation);
+}
+
 std::set<const ast::Relation*> TranslatorContext::getExpiredRelations(size_t scc) const {
     return relationSchedule->schedule().at(scc).expired();
 }
@@ -99,6 +99,9 @@ public:
     std::set<const ast::Relation*> getRelationsInSCC(size_t scc) const;
     std::set<const ast::Relation*> getInputRelationsInSCC(size_t scc) const;
     std::set<const ast::Relation*> getOutputRelationsInSCC(size_t scc) const;
+    size_t getSCC(const ast::Relation* relation) const;
+    std::set<size_t> getPredecessorSCCs(size_t scc) const;
+    std::set<size_t> getSuccessorSCCs(const ast::Relation* relation) const;
 
     /** Functor methods */
     TypeAttribute getFunctorReturnType(const ast::Functor* functor) const;
@@ -62,10 +62,22 @@ protected:
      */
     size_t num_jobs;
 
+    /**
+     * provenance flag
+     */
+    bool provenance;
+
+    /**
+     * file of explain queries answered instead of the interactive explain interface
+     */
+    std::string explain_batch;
+
 public:
     // all argument constructor
-    CmdOptions(const char* s, const char* id, const char* od, bool pe, const char* pfn, size_t nj)
-            : src(s), input_dir(id), output_dir(od), profiling(pe), profile_name(pfn), num_jobs(nj) {}
+    CmdOptions(const char* s, const char* id, const char* od, bool pe, const char* pfn, size_t nj,
+            bool pv = false)
+            : src(s), input_dir(id), output_dir(od), profiling(pe), profile_name(pfn), num_jobs(nj),
+              provenance(pv) {}
 
     /**
      * get source code name
@@ -109,6 +121,13 @@ public:
         return num_jobs;
     }
 
+    /**
+     * get file of explain queries, empty for the interactive explain interface
+     */
+    const std::string& getExplainBatchFile() const {
+        return explain_batch;
+    }
+
     /**
      * Parses the given command line parameters, handles -h help requests or errors
      * and returns whether the parsing was successful or not.
@@ -127,6 +146,7 @@ public:
         // long options
         option longOptions[] = {{"facts", true, nullptr, 'F'}, {"output", true, nullptr, 'D'},
                 {"profile", true, nullptr, 'p'}, {"jobs", true, nullptr, 'j'}, {"index", true, nullptr, 'i'},
+                {"explain-batch", true, nullptr, 'e'},
                 // the terminal option -- needs to be null
                 {nullptr, false, nullptr, 0}};
 
@@ -134,7 +154,7 @@ public:
         bool ok = true;
 
         int c; /* command-line arguments processing */
-        while ((c = getopt_long(argc, argv, "D:F:hp:j:i:", longOptions, nullptr)) != EOF) {
+        while ((c = getopt_long(argc, argv, "D:F:hp:j:i:e:", longOptions, nullptr)) != EOF) {
             switch (c) {
                 /* Fact directories */
                 case 'F':
@@ -160,6 +180,18 @@ public:
                     }
                     profile_name = optarg;
                     break;
+                case 'e':
+                    if (!provenance) {
+                        std::cerr << "\nError: provenance was not enabled in compilation\n\n";
+                        printHelpPage(exec_name);
+                        exit(EXIT_FAILURE);
+                    }
+                    if (!existFile(optarg)) {
+                        printf("Explain query file %s does not exists!\n", optarg);
+                        ok = false;
+                    }
+                    explain_batch = optarg;
+                    break;
                 case 'j':
 #ifdef _OPENMP
                     if (std::string(optarg) == "auto") {
@@ -207,6 +239,9 @@ private:
             std::cerr << "    -p <file>, --profile=<file>  -- Specify filename for profiling\n";
             std::cerr << "                                    (default: " << profile_name << ")\n";
         }
+        if (provenance) {
+            std::cerr << "    -e <file>, --explain-batch=<file> -- Answer the explain queries of a file\n";
+        }
 #ifdef _OPENMP
         std::cerr << "    -j <NUM>, --jobs=<NUM>       -- Specify number of threads\n";
         if (num_jobs > 0) {
@@ -22,7 +22,9 @@
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
 #include "souffle/datastructure/Brie.h"
+#include "souffle/datastructure/CompressedIndex.h"
 #include "souffle/datastructure/EquivalenceRelation.h"
+#include "souffle/datastructure/RowStore.h"
 #include "souffle/datastructure/Table.h"
 #include "souffle/io/IOSystem.h"
 #include "souffle/io/WriteStream.h"
@@ -32,6 +34,7 @@
 #include "souffle/utility/FileUtil.h"
 #include "souffle/utility/FunctionalUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/NumaUtil.h"
 #include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
@@ -40,6 +43,7 @@
 #include "souffle/profile/Logger.h"
 #include "souffle/profile/ProfileEvent.h"
 #endif
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
@@ -47,11 +51,14 @@
 #include <cstdint>
 #include <cstdlib>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <memory>
 #include <regex>
+#include <set>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -67,6 +74,26 @@ inline souffle::SouffleProgram* getInstance(const char* p) {
 }
 }
 
+namespace detail {
+/** Whether a relation type looks up tuples by their primary attributes, i.e., stores provenance */
+template <class RelType, class = void>
+struct has_find_primary : std::false_type {};
+
+template <class RelType>
+struct has_find_primary<RelType, std::void_t<decltype(std::declval<const RelType&>().findPrimary(
+                                         std::declval<const typename RelType::t_tuple&>()))>>
+        : std::true_type {};
+
+/** Whether a relation type can be layered over a base relation, see BaseDatabase */
+template <class RelType, class = void>
+struct has_set_base : std::false_type {};
+
+template <class RelType>
+struct has_set_base<RelType,
+        std::void_t<decltype(std::declval<RelType&>().setBase(std::declval<const RelType*>()))>>
+        : std::true_type {};
+}  // namespace detail
+
 /**
  * Relation wrapper used internally in the generated Datalog program
  */
@@ -138,6 +165,14 @@ public:
         }
         relation.insert(t);
     }
+    void insertAll(const RamDomain* data, std::size_t count) override {
+        TupleType t;
+        auto ctxt = relation.createContext();
+        for (std::size_t i = 0; i < count; i++) {
+            std::copy_n(data + i * Arity, Arity, t.begin());
+            relation.insert(t, ctxt);
+        }
+    }
     bool contains(const tuple& arg) const override {
         TupleType t;
         assert(arg.size() == Arity && "wrong tuple arity");
@@ -146,9 +181,39 @@ public:
         }
         return relation.contains(t);
     }
+    bool findAuxiliary(const RamDomain* primary, RamDomain* auxiliary) const override {
+        if constexpr (detail::has_find_primary<RelType>::value) {
+            const arity_type primaryArity = Arity - numAuxAttribs;
+            TupleType t{};
+            std::copy_n(primary, primaryArity, t.begin());
+            auto pos = relation.findPrimary(t);
+            if (pos == relation.end()) {
+                return false;
+            }
+            const auto& found = *pos;
+            for (size_t i = primaryArity; i < Arity; i++) {
+                auxiliary[i - primaryArity] = found[i];
+            }
+            return true;
+        } else {
+            return Relation::findAuxiliary(primary, auxiliary);
+        }
+    }
+    bool setBase(const Relation& base) override {
+        if constexpr (detail::has_set_base<RelType>::value) {
+            if (const auto* other = dynamic_cast<const RelationWrapper*>(&base)) {
+                relation.setBase(&other->relation);
+                return true;
+            }
+        }
+        return false;
+    }
     std::size_t size() const override {
         return relation.size();
     }
+    bool empty() const override {
+        return relation.empty();
+    }
     std::string getName() const override {
         return name;
     }
@@ -174,6 +239,19 @@ public:
     void purge() override {
         relation.purge();
     }
+
+protected:
+    /** Visit the tuples of the relation without going through tuple objects */
+    void forEachTuple(const std::function<void(const RamDomain*)>& visitor) const override {
+        for (const auto& cur : relation) {
+            // the iterators of nullary relations produce no values
+            if constexpr (Arity == 0) {
+                visitor(nullptr);
+            } else {
+                visitor(cur.data());
+            }
+        }
+    }
 };
 
 /** Nullary relations */
@@ -250,6 +328,9 @@ public:
     std::size_t size() const {
         return data ? 1 : 0;
     }
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this);
+    }
     bool empty() const {
         return !data;
     }
@@ -333,6 +414,9 @@ public:
     std::size_t size() const {
         return data.size();
     }
+    std::size_t getMemoryUsage() const {
+        return sizeof(*this) + data.capacity() * sizeof(Tuple<RamDomain, Arity>);
+    }
     bool empty() const {
         return data.size() == 0;
     }
@@ -18,9 +18,11 @@
 #pragma once
 
 #include "souffle/RamTypes.h"
+#include "souffle/utility/HugePageUtil.h"
 #include "souffle/utility/span.h"
 #include <cassert>
 #include <cstddef>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <unordered_map>
@@ -46,13 +48,15 @@ class RecordMap {
         }
     };
 
-    /** map from records to references */
+    /** map from records to references; the buckets of large maps are placed on huge pages */
     // TODO (b-scholz): replace vector<RamDomain> with something more memory-frugal
-    std::unordered_map<std::vector<RamDomain>, RamDomain, RecordHash> recordToIndex;
+    std::unordered_map<std::vector<RamDomain>, RamDomain, RecordHash, std::equal_to<std::vector<RamDomain>>,
+            HugePageAllocator<std::pair<const std::vector<RamDomain>, RamDomain>>>
+            recordToIndex;
 
     /** array of records; index represents record reference */
     // TODO (b-scholz): replace vector<RamDomain> with something more memory-frugal
-    std::vector<std::vector<RamDomain>> indexToRecord;
+    std::vector<std::vector<RamDomain>, HugePageAllocator<std::vector<RamDomain>>> indexToRecord;
 
 public:
     explicit RecordMap(size_t arity) : arity(arity), indexToRecord(1) {}  // note: index 0 element left free
@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <map>
@@ -291,6 +292,28 @@ public:
      */
     virtual void insert(const tuple& t) = 0;
 
+    /**
+     * Insert tuples stored contiguously, getArity() values per tuple.
+     * Symbols are given by their index in the symbol table, which may be obtained for many
+     * symbols at once with SymbolTable::lookup, so that no tuple objects are constructed.
+     *
+     * @param data Pointer to the values of the tuples
+     * @param count The number of tuples
+     */
+    virtual void insertAll(const RamDomain* data, std::size_t count);
+
+    /**
+     * Visit the tuples of a relation in chunks of at most chunkSize tuples.
+     * The visitor receives the values of the tuples of a chunk stored contiguously, getArity()
+     * values per tuple, and the number of tuples in the chunk. The values are only valid
+     * during the call of the visitor.
+     *
+     * @param visitor The function called for each chunk
+     * @param chunkSize The maximal number of tuples per chunk
+     */
+    void forEachChunk(const std::function<void(const RamDomain*, std::size_t)>& visitor,
+            std::size_t chunkSize = 1024) const;
+
     /**
      * Check whether a tuple exists in a relation.
      * The definition of contains has to be defined by the child class of relation class.
@@ -300,6 +323,31 @@ public:
      */
     virtual bool contains(const tuple& t) const = 0;
 
+    /**
+     * Find the tuple with the given primary attributes and get its auxiliary attributes,
+     * e.g., the provenance annotations of the tuple.
+     * The default implementation scans the relation; relations with an index whose order ends
+     * with the auxiliary attributes look the tuple up in that index instead.
+     *
+     * @param primary Pointer to the getPrimaryArity() primary attributes of the tuple
+     * @param auxiliary Pointer receiving the getAuxiliaryArity() auxiliary attributes of the tuple
+     * @return Boolean. True, if a tuple with the given primary attributes exists. False, otherwise
+     */
+    virtual bool findAuxiliary(const RamDomain* primary, RamDomain* auxiliary) const;
+
+    /**
+     * Layer the relation over the same relation of an evaluated instance of the program, see
+     * BaseDatabase. The tuples of the base relation are read in place and are not inserted
+     * again, while the base relation must not be modified.
+     * Only relations generated with --layered-relations support layering.
+     *
+     * @param base The relation of the base instance
+     * @return Boolean. True, if the relation is layered over the base relation. False, otherwise
+     */
+    virtual bool setBase(const Relation& /* base */) {
+        return false;
+    }
+
     /**
      * Return an iterator pointing to the first tuple of the relation.
      * This iterator is used to access the tuples of the relation.
@@ -322,6 +370,15 @@ public:
      */
     virtual std::size_t size() const = 0;
 
+    /**
+     * Check whether a relation holds no tuples, without counting them.
+     *
+     * @return True if the relation is empty
+     */
+    virtual bool empty() const {
+        return size() == 0;
+    }
+
     /**
      * Get the name of a relation.
      *
@@ -424,6 +481,16 @@ public:
      * in the table, set the next element pointer points to the current element itself.
      */
     virtual void purge() = 0;
+
+protected:
+    /**
+     * Visit the values of each tuple of a relation, which are only valid during the call
+     * of the visitor; this is the source of the tuples of forEachChunk.
+     * The default implementation copies the tuples of the iterators of the relation.
+     *
+     * @param visitor The function called for each tuple
+     */
+    virtual void forEachTuple(const std::function<void(const RamDomain*)>& visitor) const;
 };
 
 /**
@@ -685,6 +752,63 @@ public:
     }
 };
 
+inline void Relation::insertAll(const RamDomain* data, std::size_t count) {
+    const arity_type arity = getArity();
+    tuple t(this);
+    for (std::size_t i = 0; i < count; i++) {
+        for (arity_type j = 0; j < arity; j++) {
+            t[j] = data[i * arity + j];
+        }
+        insert(t);
+    }
+}
+
+inline void Relation::forEachChunk(
+        const std::function<void(const RamDomain*, std::size_t)>& visitor, std::size_t chunkSize) const {
+    const arity_type arity = getArity();
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    std::vector<RamDomain> buffer(chunkSize * arity);
+    std::size_t count = 0;
+    forEachTuple([&](const RamDomain* tuple) {
+        std::copy_n(tuple, arity, buffer.data() + count * arity);
+        if (++count == chunkSize) {
+            visitor(buffer.data(), count);
+            count = 0;
+        }
+    });
+    if (count > 0) {
+        visitor(buffer.data(), count);
+    }
+}
+
+inline void Relation::forEachTuple(const std::function<void(const RamDomain*)>& visitor) const {
+    const arity_type arity = getArity();
+    std::vector<RamDomain> values(arity);
+    for (auto& cur : *this) {
+        for (arity_type j = 0; j < arity; j++) {
+            values[j] = cur[j];
+        }
+        visitor(values.data());
+    }
+}
+
+inline bool Relation::findAuxiliary(const RamDomain* primary, RamDomain* auxiliary) const {
+    const arity_type primaryArity = getPrimaryArity();
+    for (auto& cur : *this) {
+        bool match = true;
+        for (arity_type i = 0; i < primaryArity && match; i++) {
+            match = cur[i] == primary[i];
+        }
+        if (match) {
+            for (arity_type i = primaryArity; i < getArity(); i++) {
+                auxiliary[i - primaryArity] = cur[i];
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * Abstract base class for generated Datalog programs.
  */
@@ -717,11 +841,25 @@ private:
      * allRelations store all the relation in a vector.
      */
     std::vector<Relation*> allRelations;
+
+    /**
+     * Snapshot of the input relations restored by reset(), with the values of the tuples of
+     * each relation stored contiguously and the number of tuples.
+     */
+    std::vector<std::tuple<Relation*, std::vector<RamDomain>, std::size_t>> inputSnapshot;
+
+    /**
+     * The evaluated instance the relations of a query are layered over, see BaseDatabase
+     */
+    std::shared_ptr<SouffleProgram> baseInstance;
+
     /**
      * The number of threads used by OpenMP
      */
     std::size_t numThreads = 1;
 
+    friend class BaseDatabase;
+
 protected:
     /**
      * Add the relation to relationMap (with its name) and allRelations,
@@ -802,6 +940,18 @@ public:
      */
     virtual void dumpOutputs() = 0;
 
+    /**
+     * Check whether the tuples of a relation remain valid when facts are added to the program,
+     * i.e., the relation is computed without negation, aggregation or choice domains, and only
+     * from relations for which this holds as well.
+     *
+     * @param name The name of the relation
+     * @return Boolean. True, if the relation only grows when facts are added. False, otherwise
+     */
+    virtual bool isMonotone(const std::string& /* name */) const {
+        return false;
+    }
+
     /**
      * Set the number of threads to be used
      */
@@ -954,6 +1104,54 @@ public:
         }
     }
 
+    /**
+     * Take a snapshot of the tuples of the input relations, e.g. after inserting the facts
+     * shared by all runs of the program; reset() restores the snapshot, so that only the facts
+     * specific to a run have to be inserted again. Replaces any previous snapshot.
+     */
+    void snapshotInputs() {
+        inputSnapshot.clear();
+        for (Relation* relation : inputRelations) {
+            std::vector<RamDomain> data;
+            std::size_t count = 0;
+            relation->forEachChunk([&](const RamDomain* chunk, std::size_t size) {
+                data.insert(data.end(), chunk, chunk + size * relation->getArity());
+                count += size;
+            });
+            inputSnapshot.emplace_back(relation, std::move(data), count);
+        }
+    }
+
+    /**
+     * Discard the snapshot of the input relations.
+     */
+    void clearSnapshot() {
+        inputSnapshot.clear();
+    }
+
+    /**
+     * Remove all the tuples from all relations and restore the snapshot of the input
+     * relations, if one was taken, so that the program can be run again on new facts.
+     * Reusing a program in this way avoids creating a new instance for each run.
+     *
+     * Only relations holding tuples are cleared. The indexes keep the node pools of their
+     * b-trees and tries, so clearing a relation drops its nodes without visiting them, and
+     * the next run refills the memory of the previous one instead of allocating anew.
+     * Operation hints belong to the contexts of a run and hence start afresh.
+     *
+     * @see snapshotInputs()
+     */
+    void reset() {
+        for (Relation* relation : allRelations) {
+            if (!relation->empty()) {
+                relation->purge();
+            }
+        }
+        for (auto& cur : inputSnapshot) {
+            std::get<0>(cur)->insertAll(std::get<1>(cur).data(), std::get<2>(cur));
+        }
+    }
+
     /**
      * Helper function for the wrapper function Relation::insert() and Relation::contains().
      */
@@ -1109,4 +1307,98 @@ public:
         }
     }
 };
+
+/**
+ * An evaluated base database shared by the queries of a program.
+ *
+ * The base database is an instance of a program evaluated on a large set of base facts. Each
+ * query is a new instance of the program whose relations are layered over the relations of the
+ * base instance: a layered relation reads the tuples of the base relation in place and only
+ * stores the tuples added by the query, i.e., the facts specific to the query and the tuples
+ * derived from them. Queries do not modify the base instance, so that queries may be created
+ * and run concurrently; a base database may be shared by copying it, and each query keeps the
+ * base instance alive.
+ *
+ * Only relations generated with --layered-relations, which excludes provenance, are layered;
+ * the tuples of the other relations are copied into the query. Relations computed using
+ * negation, aggregation or choice domains, directly or from other such relations, may lose
+ * tuples when the query adds facts; they are neither layered nor copied but computed again
+ * when the query is run. Hence, such relations must not be input relations of the base. Records
+ * are not shared, so a program with relations holding records cannot be used as a base database.
+ */
+class BaseDatabase {
+public:
+    /**
+     * Create the base database of a program by evaluating an instance holding the base facts.
+     *
+     * @param name The name of the program, used to create the instances of the queries
+     * @param base The instance of the program holding the base facts, which is run
+     * @return The base database, or null pointer if the instance is null, the program has
+     * relations holding records or input relations that are not monotone
+     */
+    static Own<BaseDatabase> evaluate(std::string name, Own<SouffleProgram> base) {
+        if (base == nullptr) {
+            return nullptr;
+        }
+        for (const Relation* relation : base->getInputRelations()) {
+            if (!base->isMonotone(relation->getName())) {
+                return nullptr;
+            }
+        }
+        for (const Relation* relation : base->getAllRelations()) {
+            for (std::size_t i = 0; i < relation->getArity(); i++) {
+                const char kind = relation->getAttrType(i)[0];
+                if (kind == 'r' || kind == '+') {
+                    return nullptr;
+                }
+            }
+        }
+        base->run();
+        return Own<BaseDatabase>(new BaseDatabase(std::move(name), std::move(base)));
+    }
+
+    /**
+     * Create a program instance for a query, layered over the base instance.
+     *
+     * @return The new instance, or null pointer if the program is not found
+     */
+    Own<SouffleProgram> newQuery() const {
+        Own<SouffleProgram> query(ProgramFactory::newInstance(name));
+        if (query == nullptr) {
+            return nullptr;
+        }
+        query->getSymbolTable() = baseInstance->getSymbolTable();
+        for (Relation* relation : query->getAllRelations()) {
+            // the tuples of the base relation may not hold once the query adds facts
+            if (!baseInstance->isMonotone(relation->getName())) {
+                continue;
+            }
+            const Relation* base = baseInstance->getRelation(relation->getName());
+            if (base == nullptr || relation->setBase(*base)) {
+                continue;
+            }
+            base->forEachChunk([&](const RamDomain* chunk, std::size_t size) {
+                relation->insertAll(chunk, size);
+            });
+        }
+        query->baseInstance = baseInstance;
+        return query;
+    }
+
+    /**
+     * Get the evaluated base instance, which must not be modified.
+     */
+    const SouffleProgram& getBase() const {
+        return *baseInstance;
+    }
+
+private:
+    BaseDatabase(std::string name, Own<SouffleProgram> base)
+            : name(std::move(name)), baseInstance(std::move(base)) {}
+
+    std::string name;
+
+    /** The evaluated instance, shared by all copies of the base database and its queries */
+    std::shared_ptr<SouffleProgram> baseInstance;
+};
 }  // namespace souffle
@@ -17,12 +17,14 @@
 #pragma once
 
 #include "souffle/RamTypes.h"
+#include "souffle/utility/HugePageUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StreamUtil.h"
 #include <algorithm>
 #include <cstdlib>
 #include <deque>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <string>
@@ -45,10 +47,12 @@ private:
     mutable Lock access;
 
     /** Map indices to strings. */
-    std::deque<std::string> numToStr;
+    std::deque<std::string, HugePageAllocator<std::string>> numToStr;
 
-    /** Map strings to indices. */
-    std::unordered_map<std::string, size_t> strToNum;
+    /** Map strings to indices; the buckets of large tables are placed on huge pages. */
+    std::unordered_map<std::string, size_t, std::hash<std::string>, std::equal_to<std::string>,
+            HugePageAllocator<std::pair<const std::string, size_t>>>
+            strToNum;
 
     /** Convenience method to place a new symbol in the table, if it does not exist, and return the index of
      * it. */
@@ -123,6 +127,22 @@ public:
         }
     }
 
+    /** Find the indexes of the given symbols, inserting the symbols that do not exist there already;
+     * the table is locked once for all symbols. */
+    std::vector<RamDomain> lookup(const std::vector<std::string>& symbols) {
+        std::vector<RamDomain> result;
+        result.reserve(symbols.size());
+        {
+            auto lease = access.acquire();
+            (void)lease;  // avoid warning;
+            strToNum.reserve(size() + symbols.size());
+            for (const auto& symbol : symbols) {
+                result.push_back(static_cast<RamDomain>(newSymbolOfIndex(symbol)));
+            }
+        }
+        return result;
+    }
+
     /** Finds the index of a symbol in the table, giving an error if it's not found */
     RamDomain lookupExisting(const std::string& symbol) const {
         {
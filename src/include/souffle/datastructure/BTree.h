@@ -17,11 +17,14 @@
 
 #pragma once
 
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/NodePool.h"
 #include "souffle/utility/CacheUtil.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/ParallelUtil.h"
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -33,6 +36,11 @@
 #include <typeinfo>
 #include <vector>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SOUFFLE_SIMD_SEARCH
+#include <immintrin.h>
+#endif
+
 namespace souffle {
 
 namespace detail {
@@ -203,6 +211,211 @@ struct binary_search : public search_strategy {
     }
 };
 
+/**
+ * Obtains the column a comparator orders by first, if it compares this column as
+ * a signed RamDomain value. Comparators declare it by a static member leading_column;
+ * the value is -1 for all other comparators.
+ */
+template <typename Comp, typename = void>
+struct leading_column_of {
+    static constexpr int value = -1;
+};
+
+template <typename Comp>
+struct leading_column_of<Comp, std::void_t<decltype(Comp::leading_column)>> {
+    static constexpr int value = Comp::leading_column;
+};
+
+template <std::size_t N>
+struct leading_column_of<comparator<std::array<RamDomain, N>>> {
+    static constexpr int value = 0;
+};
+
+/**
+ * A search strategy for tuples of RamDomain values. The range of elements
+ * sharing the leading column of the key is located by a vectorised scan over
+ * this column, and the remaining columns are compared by a binary search within
+ * this range. Keys that are not tuples, or comparators not declaring a leading
+ * column, are searched by a binary search.
+ */
+struct simd_search : public search_strategy {
+    /**
+     * Required user-defined default constructor.
+     */
+    simd_search() = default;
+
+    /**
+     * Obtains an iterator pointing to some element within the given
+     * range that is equal to the given key, if available. If no such
+     * element is present, a reference to the first element not less than
+     * the given key will be returned.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    Iter operator()(const Key& k, Iter a, Iter b, Comp& comp) const {
+        narrow(k, a, b, comp);
+        return binary_search()(k, a, b, comp);
+    }
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * is not less than the given key.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    Iter lower_bound(const Key& k, Iter a, Iter b, Comp& comp) const {
+        narrow(k, a, b, comp);
+        return binary_search().lower_bound(k, a, b, comp);
+    }
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * such that the given key is less than the referenced element.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    Iter upper_bound(const Key& k, Iter a, Iter b, Comp& comp) const {
+        narrow(k, a, b, comp);
+        return binary_search().upper_bound(k, a, b, comp);
+    }
+
+private:
+    template <typename T>
+    struct tuple_arity {
+        static constexpr std::size_t value = 0;
+    };
+
+    template <std::size_t N>
+    struct tuple_arity<std::array<RamDomain, N>> {
+        static constexpr std::size_t value = N;
+    };
+
+    /**
+     * Narrows the given range to the elements whose leading column equals the
+     * leading column of the given key.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    static void narrow(const Key& k, Iter& a, Iter& b, Comp&) {
+        using tuple_type = std::decay_t<decltype(*a)>;
+        constexpr int column = leading_column_of<std::remove_cv_t<Comp>>::value;
+        constexpr std::size_t arity = tuple_arity<tuple_type>::value;
+        if constexpr (column >= 0 && static_cast<std::size_t>(column) < arity &&
+                      std::is_same<std::decay_t<Key>, tuple_type>::value) {
+            static_assert(sizeof(tuple_type) == arity * sizeof(RamDomain), "tuples must be contiguous");
+            if (a == b) {
+                return;
+            }
+            std::size_t less = 0;
+            std::size_t lessEqual = 0;
+            count(&(*a)[column], b - a, arity, k[column], less, lessEqual);
+            b = a + lessEqual;
+            a = a + less;
+        }
+    }
+
+    /**
+     * Counts the values less than and not greater than the key in a sorted column
+     * of n values, which are the given number of values apart.
+     */
+    static void count(const RamDomain* values, std::size_t n, std::size_t stride, RamDomain key,
+            std::size_t& less, std::size_t& lessEqual) {
+#ifdef SOUFFLE_SIMD_SEARCH
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        static const bool sse42 = __builtin_cpu_supports("sse4.2");
+        if (avx2) {
+            countAVX2(values, n, stride, key, less, lessEqual);
+            return;
+        }
+        if (sse42) {
+            countSSE42(values, n, stride, key, less, lessEqual);
+            return;
+        }
+#endif
+        countScalar(values, n, stride, key, less, lessEqual);
+    }
+
+    static void countScalar(const RamDomain* values, std::size_t n, std::size_t stride, RamDomain key,
+            std::size_t& less, std::size_t& lessEqual) {
+        for (std::size_t i = 0; i < n; i++) {
+            RamDomain value = values[i * stride];
+            if (value > key) {
+                return;
+            }
+            less += (value < key);
+            lessEqual++;
+        }
+    }
+
+#ifdef SOUFFLE_SIMD_SEARCH
+    __attribute__((target("avx2"))) static void countAVX2(const RamDomain* values, std::size_t n,
+            std::size_t stride, RamDomain key, std::size_t& less, std::size_t& lessEqual) {
+        std::size_t i = 0;
+        if constexpr (sizeof(RamDomain) == 4) {
+            const __m256i k = _mm256_set1_epi32(key);
+            const __m256i index = _mm256_mullo_epi32(
+                    _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+            for (; i + 8 <= n; i += 8) {
+                __m256i v =
+                        _mm256_i32gather_epi32(reinterpret_cast<const int*>(values + i * stride), index, 4);
+                int lt = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, v)));
+                int gt = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, k)));
+                less += __builtin_popcount(lt);
+                lessEqual += 8 - __builtin_popcount(gt);
+                if (gt != 0) {
+                    return;
+                }
+            }
+        } else {
+            const __m256i k = _mm256_set1_epi64x(key);
+            const auto s = static_cast<long long>(stride);
+            const __m256i index = _mm256_setr_epi64x(0, s, 2 * s, 3 * s);
+            for (; i + 4 <= n; i += 4) {
+                __m256i v = _mm256_i64gather_epi64(
+                        reinterpret_cast<const long long*>(values + i * stride), index, 8);
+                int lt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, v)));
+                int gt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, k)));
+                less += __builtin_popcount(lt);
+                lessEqual += 4 - __builtin_popcount(gt);
+                if (gt != 0) {
+                    return;
+                }
+            }
+        }
+        countScalar(values + i * stride, n - i, stride, key, less, lessEqual);
+    }
+
+    __attribute__((target("sse4.2"))) static void countSSE42(const RamDomain* values, std::size_t n,
+            std::size_t stride, RamDomain key, std::size_t& less, std::size_t& lessEqual) {
+        std::size_t i = 0;
+        if constexpr (sizeof(RamDomain) == 4) {
+            const __m128i k = _mm_set1_epi32(key);
+            for (; i + 4 <= n; i += 4) {
+                const RamDomain* p = values + i * stride;
+                __m128i v = _mm_setr_epi32(p[0], p[stride], p[2 * stride], p[3 * stride]);
+                int lt = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, v)));
+                int gt = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, k)));
+                less += __builtin_popcount(lt);
+                lessEqual += 4 - __builtin_popcount(gt);
+                if (gt != 0) {
+                    return;
+                }
+            }
+        } else {
+            const __m128i k = _mm_set1_epi64x(key);
+            for (; i + 2 <= n; i += 2) {
+                const RamDomain* p = values + i * stride;
+                __m128i v = _mm_set_epi64x(p[stride], p[0]);
+                int lt = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(k, v)));
+                int gt = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(v, k)));
+                less += __builtin_popcount(lt);
+                lessEqual += 2 - __builtin_popcount(gt);
+                if (gt != 0) {
+                    return;
+                }
+            }
+        }
+        countScalar(values + i * stride, n - i, stride, key, less, lessEqual);
+    }
+#endif
+};
+
 // ---------- search strategies selection --------------
 
 /**
@@ -216,6 +429,7 @@ struct strategy_selection {
 
 struct linear : public strategy_selection<linear_search> {};
 struct binary : public strategy_selection<binary_search> {};
+struct simd : public strategy_selection<simd_search> {};
 
 // by default every key utilizes binary search
 template <typename Key>
@@ -227,6 +441,9 @@ struct default_strategy<int> : public linear {};
 template <typename... Ts>
 struct default_strategy<std::tuple<Ts...>> : public linear {};
 
+template <std::size_t N>
+struct default_strategy<std::array<RamDomain, N>> : public simd {};
+
 /**
  * The default non-updater
  */
@@ -240,15 +457,14 @@ struct updater {
  *
  * @tparam Key             .. the element type to be stored in this tree
  * @tparam Comparator     .. a class defining an order on the stored elements
- * @tparam Allocator     .. utilized for allocating memory for required nodes
+ * @tparam Allocator     .. utilized for allocating memory for required nodes; a PoolAllocator
+ *                          draws nodes from a pool of the tree, dropped as a whole by clear()
  * @tparam blockSize    .. determines the number of bytes/block utilized by leaf nodes
  * @tparam SearchStrategy .. enables switching between linear, binary or any other search strategy
  * @tparam isSet        .. true = set, false = multiset
  */
-template <typename Key, typename Comparator,
-        typename Allocator,  // is ignored so far - TODO: add support
-        unsigned blockSize, typename SearchStrategy, bool isSet, typename WeakComparator = Comparator,
-        typename Updater = detail::updater<Key>>
+template <typename Key, typename Comparator, typename Allocator, unsigned blockSize, typename SearchStrategy,
+        bool isSet, typename WeakComparator = Comparator, typename Updater = detail::updater<Key>>
 class btree {
 public:
     class iterator;
@@ -258,6 +474,9 @@ public:
     using element_type = Key;
     using chunk = range<iterator>;
 
+    // the creation and destruction of nodes
+    using node_allocator_type = detail::node_allocator<Allocator>;
+
 protected:
     /* ------------- static utilities ----------------- */
 
@@ -385,10 +604,10 @@ protected:
         /**
          * A deep-copy operation creating a clone of this node.
          */
-        node* clone() const {
+        node* clone(node_allocator_type& nodes) const {
             // create a clone of this node
-            node* res = (this->isInner()) ? static_cast<node*>(new inner_node())
-                                          : static_cast<node*>(new leaf_node());
+            node* res = (this->isInner()) ? static_cast<node*>(nodes.template create<inner_node>())
+                                          : static_cast<node*>(nodes.template create<leaf_node>());
 
             // copy basic fields
             res->position = this->position;
@@ -406,7 +625,7 @@ protected:
             // copy child nodes recursively
             auto* ires = (inner_node*)res;
             for (size_type i = 0; i <= this->numElements; ++i) {
-                ires->children[i] = this->getChild(i)->clone();
+                ires->children[i] = this->getChild(i)->clone(nodes);
                 ires->children[i]->parent = res;
             }
 
@@ -539,19 +758,21 @@ protected:
         /**
          * Splits this node.
          *
+         * @param nodes .. the source of new nodes of the enclosing b-tree
          * @param root .. a pointer to the root-pointer of the enclosing b-tree
          *                 (might have to be updated if the root-node needs to be split)
          * @param idx  .. the position of the insert causing the split
          */
 #ifdef IS_PARALLEL
-        void split(node** root, lock_type& root_lock, int idx, std::vector<node*>& locked_nodes) {
+        void split(node_allocator_type& nodes, node** root, lock_type& root_lock, int idx,
+                std::vector<node*>& locked_nodes) {
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
             assert((this->parent != nullptr) || root_lock.is_write_locked());
             assert(this->isLeaf() || souffle::contains(locked_nodes, this));
             assert(!this->parent || souffle::contains(locked_nodes, const_cast<node*>(this->parent)));
 #else
-        void split(node** root, lock_type& root_lock, int idx) {
+        void split(node_allocator_type& nodes, node** root, lock_type& root_lock, int idx) {
 #endif
             assert(this->numElements == maxKeys);
 
@@ -559,8 +780,8 @@ protected:
             int split_point = getSplitPoint(idx);
 
             // create a new sibling node
-            node* sibling = (this->inner) ? static_cast<node*>(new inner_node())
-                                          : static_cast<node*>(new leaf_node());
+            node* sibling = (this->inner) ? static_cast<node*>(nodes.template create<inner_node>())
+                                          : static_cast<node*>(nodes.template create<leaf_node>());
 
 #ifdef IS_PARALLEL
             // lock sibling
@@ -590,9 +811,9 @@ protected:
 
             // update parent
 #ifdef IS_PARALLEL
-            grow_parent(root, root_lock, sibling, locked_nodes);
+            grow_parent(nodes, root, root_lock, sibling, locked_nodes);
 #else
-            grow_parent(root, root_lock, sibling);
+            grow_parent(nodes, root, root_lock, sibling);
 #endif
         }
 
@@ -609,14 +830,15 @@ protected:
          */
         // TODO: remove root_lock ... no longer needed
 #ifdef IS_PARALLEL
-        int rebalance_or_split(node** root, lock_type& root_lock, int idx, std::vector<node*>& locked_nodes) {
+        int rebalance_or_split(node_allocator_type& nodes, node** root, lock_type& root_lock, int idx,
+                std::vector<node*>& locked_nodes) {
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
             assert((this->parent != nullptr) || root_lock.is_write_locked());
             assert(this->isLeaf() || souffle::contains(locked_nodes, this));
             assert(!this->parent || souffle::contains(locked_nodes, const_cast<node*>(this->parent)));
 #else
-        int rebalance_or_split(node** root, lock_type& root_lock, int idx) {
+        int rebalance_or_split(node_allocator_type& nodes, node** root, lock_type& root_lock, int idx) {
 #endif
 
             // this node is full ... and needs some space
@@ -634,7 +856,7 @@ protected:
                 // lock access to left sibling
                 if (!left->lock.try_start_write()) {
                     // left node is currently updated => skip balancing and split
-                    split(root, root_lock, idx, locked_nodes);
+                    split(nodes, root, root_lock, idx, locked_nodes);
                     return 0;
                 }
 #endif
@@ -707,9 +929,9 @@ protected:
 
             // Option B) split node
 #ifdef IS_PARALLEL
-            split(root, root_lock, idx, locked_nodes);
+            split(nodes, root, root_lock, idx, locked_nodes);
 #else
-            split(root, root_lock, idx);
+            split(nodes, root, root_lock, idx);
 #endif
             return 0;  // = no re-balancing
         }
@@ -724,21 +946,22 @@ protected:
          * @param sibling .. the new right-sibling to be add to the parent node
          */
 #ifdef IS_PARALLEL
-        void grow_parent(node** root, lock_type& root_lock, node* sibling, std::vector<node*>& locked_nodes) {
+        void grow_parent(node_allocator_type& nodes, node** root, lock_type& root_lock, node* sibling,
+                std::vector<node*>& locked_nodes) {
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
             assert((this->parent != nullptr) || root_lock.is_write_locked());
             assert(this->isLeaf() || souffle::contains(locked_nodes, this));
             assert(!this->parent || souffle::contains(locked_nodes, const_cast<node*>(this->parent)));
 #else
-        void grow_parent(node** root, lock_type& root_lock, node* sibling) {
+        void grow_parent(node_allocator_type& nodes, node** root, lock_type& root_lock, node* sibling) {
 #endif
 
             if (this->parent == nullptr) {
                 assert(*root == this);
 
                 // create a new root node
-                auto* new_root = new inner_node();
+                auto* new_root = nodes.template create<inner_node>();
                 new_root->numElements = 1;
                 new_root->keys[0] = keys[this->numElements];
 
@@ -760,9 +983,9 @@ protected:
 
 #ifdef IS_PARALLEL
                 parent->insert_inner(
-                        root, root_lock, pos, this, keys[this->numElements], sibling, locked_nodes);
+                        nodes, root, root_lock, pos, this, keys[this->numElements], sibling, locked_nodes);
 #else
-                parent->insert_inner(root, root_lock, pos, this, keys[this->numElements], sibling);
+                parent->insert_inner(nodes, root, root_lock, pos, this, keys[this->numElements], sibling);
 #endif
             }
         }
@@ -776,13 +999,13 @@ protected:
          * @param newNode .. the new right-child of the inserted key
          */
 #ifdef IS_PARALLEL
-        void insert_inner(node** root, lock_type& root_lock, unsigned pos, node* predecessor, const Key& key,
-                node* newNode, std::vector<node*>& locked_nodes) {
+        void insert_inner(node_allocator_type& nodes, node** root, lock_type& root_lock, unsigned pos,
+                node* predecessor, const Key& key, node* newNode, std::vector<node*>& locked_nodes) {
             assert(this->lock.is_write_locked());
             assert(souffle::contains(locked_nodes, this));
 #else
-        void insert_inner(node** root, lock_type& root_lock, unsigned pos, node* predecessor, const Key& key,
-                node* newNode) {
+        void insert_inner(node_allocator_type& nodes, node** root, lock_type& root_lock, unsigned pos,
+                node* predecessor, const Key& key, node* newNode) {
 #endif
 
             // check capacity
@@ -795,9 +1018,9 @@ protected:
 
                 // split this node
 #ifdef IS_PARALLEL
-                pos -= rebalance_or_split(root, root_lock, pos, locked_nodes);
+                pos -= rebalance_or_split(nodes, root, root_lock, pos, locked_nodes);
 #else
-                pos -= rebalance_or_split(root, root_lock, pos);
+                pos -= rebalance_or_split(nodes, root, root_lock, pos);
 #endif
 
                 // complete insertion within new sibling if necessary
@@ -822,9 +1045,9 @@ protected:
                     }
 
                     pos = (i > other->numElements) ? 0 : i;
-                    other->insert_inner(root, root_lock, pos, predecessor, key, newNode, locked_nodes);
+                    other->insert_inner(nodes, root, root_lock, pos, predecessor, key, newNode, locked_nodes);
 #else
-                    other->insert_inner(root, root_lock, pos, predecessor, key, newNode);
+                    other->insert_inner(nodes, root, root_lock, pos, predecessor, key, newNode);
 #endif
                     return;
                 }
@@ -1068,19 +1291,6 @@ protected:
 
         // a simple default constructor initializing member fields
         inner_node() : node(true) {}
-
-        // clear up child nodes recursively
-        ~inner_node() {
-            for (unsigned i = 0; i <= this->numElements; ++i) {
-                if (children[i] != nullptr) {
-                    if (children[i]->isLeaf()) {
-                        delete static_cast<leaf_node*>(children[i]);
-                    } else {
-                        delete static_cast<inner_node*>(children[i]);
-                    }
-                }
-            }
-        }
     };
 
     /**
@@ -1235,6 +1445,9 @@ protected:
     // a pointer to the left-most node of this tree (initial note for iteration)
     leaf_node* leftmost;
 
+    // the source of the nodes of this tree
+    node_allocator_type nodes;
+
     /* -------------- operator hint statistics ----------------- */
 
     // an aggregation of statistical values of the hint utilization
@@ -1276,6 +1489,7 @@ public:
             : comp(other.comp), weak_comp(other.weak_comp), root(other.root), leftmost(other.leftmost) {
         other.root = nullptr;
         other.leftmost = nullptr;
+        nodes.swap(other.nodes);
     }
 
     // a copy constructor
@@ -1284,14 +1498,6 @@ public:
         *this = set;
     }
 
-protected:
-    /**
-     * An internal constructor enabling the specific creation of a tree
-     * based on internal parameters.
-     */
-    btree(size_type /* size */, node* root, leaf_node* leftmost) : root(root), leftmost(leftmost) {}
-
-public:
     // the destructor freeing all contained nodes
     ~btree() {
         clear();
@@ -1339,7 +1545,7 @@ public:
             }
 
             // create new node
-            leftmost = new leaf_node();
+            leftmost = nodes.template create<leaf_node>();
             leftmost->numElements = 1;
             leftmost->keys[0] = k;
             root = leftmost;
@@ -1537,7 +1743,7 @@ public:
 
                 // split this node
                 auto old_root = root;
-                idx -= cur->rebalance_or_split(const_cast<node**>(&root), root_lock, idx, parents);
+                idx -= cur->rebalance_or_split(nodes, const_cast<node**>(&root), root_lock, idx, parents);
 
                 // release parent lock
                 for (auto it = parents.rbegin(); it != parents.rend(); ++it) {
@@ -1589,7 +1795,7 @@ public:
         // special handling for inserting first element
         if (empty()) {
             // create new node
-            leftmost = new leaf_node();
+            leftmost = nodes.template create<leaf_node>();
             leftmost->numElements = 1;
             leftmost->keys[0] = k;
             root = leftmost;
@@ -1664,7 +1870,7 @@ public:
 
             if (cur->numElements >= node::maxKeys) {
                 // split this node
-                idx -= cur->rebalance_or_split(&root, root_lock, static_cast<int>(idx));
+                idx -= cur->rebalance_or_split(nodes, &root, root_lock, static_cast<int>(idx));
 
                 // insert element in right fragment
                 if (((size_type)idx) > cur->numElements) {
@@ -1933,13 +2139,14 @@ public:
      * Clears this tree.
      */
     void clear() {
-        if (root != nullptr) {
-            if (root->isLeaf()) {
-                delete static_cast<leaf_node*>(root);
-            } else {
-                delete static_cast<inner_node*>(root);
-            }
-        }
+        // pooled nodes without destructors are dropped together with their pool
+        constexpr bool trivial = node_allocator_type::pooled &&
+                                 std::is_trivially_destructible<leaf_node>::value &&
+                                 std::is_trivially_destructible<inner_node>::value;
+        if (root != nullptr && !trivial) {
+            destroy(root);
+        }
+        nodes.clear();
         root = nullptr;
         leftmost = nullptr;
     }
@@ -1953,6 +2160,7 @@ public:
         // swap the content
         std::swap(root, other.root);
         std::swap(leftmost, other.leftmost);
+        nodes.swap(other.nodes);
     }
 
     // Implementation of the assignment operation for trees.
@@ -1969,7 +2177,7 @@ public:
         }
 
         // clone content (deep copy)
-        root = other.root->clone();
+        root = other.root->clone(nodes);
 
         // update leftmost reference
         auto tmp = root;
@@ -2025,6 +2233,9 @@ public:
 
     // Determines the amount of memory used by this data structure
     size_type getMemoryUsage() const {
+        if (node_allocator_type::pooled) {
+            return sizeof(*this) + nodes.getMemoryUsage();
+        }
         return sizeof(*this) + (empty() ? 0 : root->getMemoryUsage());
     }
 
@@ -2099,17 +2310,20 @@ public:
             return R();
         }
 
-        // resolve tree recursively
-        auto root = buildSubTree(a, b - 1);
+        // resolve tree recursively, drawing the nodes from the result
+        R res;
+        btree& tree = res;
+        tree.root = buildSubTree(tree.nodes, a, b - 1);
 
         // find leftmost node
-        node* leftmost = root;
+        node* leftmost = tree.root;
         while (!leftmost->isLeaf()) {
             leftmost = leftmost->getChild(0);
         }
+        tree.leftmost = static_cast<leaf_node*>(leftmost);
 
         // build result
-        return R(b - a, root, static_cast<leaf_node*>(leftmost));
+        return res;
     }
 
 protected:
@@ -2142,6 +2356,21 @@ protected:
     }
 
 private:
+    // Destroys the given node and all its sub-nodes.
+    void destroy(node* cur) {
+        if (cur->isLeaf()) {
+            nodes.destroy(static_cast<leaf_node*>(cur));
+            return;
+        }
+        auto* inner = static_cast<inner_node*>(cur);
+        for (unsigned i = 0; i <= inner->numElements; ++i) {
+            if (inner->children[i] != nullptr) {
+                destroy(inner->children[i]);
+            }
+        }
+        nodes.destroy(inner);
+    }
+
     /**
      * Determines whether the range covered by this node covers
      * the upper bound of the given key.
@@ -2153,7 +2382,7 @@ private:
 
     // Utility function for the load operation above.
     template <typename Iter>
-    static node* buildSubTree(const Iter& a, const Iter& b) {
+    static node* buildSubTree(node_allocator_type& nodes, const Iter& a, const Iter& b) {
         const int N = node::maxKeys;
 
         // divide range in N+1 sub-ranges
@@ -2162,7 +2391,7 @@ private:
         // terminal case: length is less then maxKeys
         if (length <= N) {
             // create a leaf node
-            node* res = new leaf_node();
+            node* res = nodes.template create<leaf_node>();
             res->numElements = length;
 
             for (int i = 0; i < length; ++i) {
@@ -2182,7 +2411,7 @@ private:
         }
 
         // create inner node
-        node* res = new inner_node();
+        node* res = nodes.template create<inner_node>();
         res->numElements = numKeys;
 
         Iter c = a;
@@ -2191,7 +2420,7 @@ private:
             res->keys[i] = c[step];
 
             // get sub-tree
-            auto child = buildSubTree(c, c + (step - 1));
+            auto child = buildSubTree(nodes, c, c + (step - 1));
             child->parent = res;
             child->position = i;
             res->getChildren()[i] = child;
@@ -2200,7 +2429,7 @@ private:
         }
 
         // and the remaining part
-        auto child = buildSubTree(c, b);
+        auto child = buildSubTree(nodes, c, b);
         child->parent = res;
         child->position = numKeys;
         res->getChildren()[numKeys] = child;
@@ -2228,7 +2457,7 @@ const SearchStrategy
  * @tparam SearchStrategy .. enables switching between linear, binary or any other search strategy
  */
 template <typename Key, typename Comparator = detail::comparator<Key>,
-        typename Allocator = std::allocator<Key>,  // is ignored so far
+        typename Allocator = std::allocator<Key>,
         unsigned blockSize = 256,
         typename SearchStrategy = typename souffle::detail::default_strategy<Key>::type,
         typename WeakComparator = Comparator, typename Updater = souffle::detail::updater<Key>>
@@ -2261,12 +2490,6 @@ public:
     // A move constructor.
     btree_set(btree_set&& other) : super(std::move(other)) {}
 
-private:
-    // A constructor required by the bulk-load facility.
-    template <typename s, typename n, typename l>
-    btree_set(s size, n* root, l* leftmost) : super(size, root, leftmost) {}
-
-public:
     // Support for the assignment operator.
     btree_set& operator=(const btree_set& other) {
         super::operator=(other);
@@ -2290,7 +2513,7 @@ public:
  * @tparam SearchStrategy .. enables switching between linear, binary or any other search strategy
  */
 template <typename Key, typename Comparator = detail::comparator<Key>,
-        typename Allocator = std::allocator<Key>,  // is ignored so far
+        typename Allocator = std::allocator<Key>,
         unsigned blockSize = 256,
         typename SearchStrategy = typename souffle::detail::default_strategy<Key>::type,
         typename WeakComparator = Comparator, typename Updater = souffle::detail::updater<Key>>
@@ -2323,12 +2546,6 @@ public:
     // A move constructor.
     btree_multiset(btree_multiset&& other) : super(std::move(other)) {}
 
-private:
-    // A constructor required by the bulk-load facility.
-    template <typename s, typename n, typename l>
-    btree_multiset(s size, n* root, l* leftmost) : super(size, root, leftmost) {}
-
-public:
     // Support for the assignment operator.
     btree_multiset& operator=(const btree_multiset& other) {
         super::operator=(other);
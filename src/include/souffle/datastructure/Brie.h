@@ -27,6 +27,7 @@
 #pragma once
 
 #include "souffle/RamTypes.h"
+#include "souffle/datastructure/NodePool.h"
 #include "souffle/utility/CacheUtil.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
@@ -318,13 +319,19 @@ using namespace detail::brie;
  *              instance of this array. For instance, this is utilized by the
  *              trie implementation to create a clone of each sub-tree instead
  *              of preserving the original pointer.
+ * @tparam Allocator utilized for allocating nodes; a PoolAllocator draws nodes from
+ *              a pool of the array, dropped as a whole when the array is cleaned.
  */
-template <typename T, unsigned BITS = 6, typename merge_op = default_merge<T>, typename copy_op = identity<T>>
-class SparseArray {
+template <typename T, unsigned BITS = 6, typename merge_op = default_merge<T>, typename copy_op = identity<T>,
+        typename Allocator = std::allocator<T>>
+class SparseArray : private detail::node_allocator<Allocator> {
     template <typename A>
     friend struct detail::brie::SparseArrayIter;
 
-    using this_t = SparseArray<T, BITS, merge_op, copy_op>;
+    // the source of the nodes of this array; a base, such that it takes no space by default
+    using node_allocator_type = detail::node_allocator<Allocator>;
+
+    using this_t = SparseArray<T, BITS, merge_op, copy_op, Allocator>;
     using key_type = uint64_t;
 
     // some internal constants
@@ -427,6 +434,7 @@ public:
         other.unsynced.root = nullptr;
         other.unsynced.levels = 0;
         other.unsynced.first = nullptr;
+        nodes().swap(other.nodes());
     }
 
     /**
@@ -481,6 +489,7 @@ public:
         other.unsynced.root = nullptr;
         other.unsynced.levels = 0;
         other.unsynced.first = nullptr;
+        nodes().swap(other.nodes());
 
         // done
         return *this;
@@ -541,7 +550,9 @@ public:
         std::size_t res = sizeof(*this);
 
         // add nodes
-        if (unsynced.root) {
+        if (node_allocator_type::pooled) {
+            res += nodes().getMemoryUsage();
+        } else if (unsynced.root) {
             res += getMemoryUsage(unsynced.root, unsynced.levels);
         }
 
@@ -811,7 +822,7 @@ private:
             }
 
             // somebody else was faster => use standard insertion procedure
-            delete info.root;
+            nodes().destroy(info.root);
 
             // retrieve new root info
             info = getRootInfo();
@@ -854,7 +865,7 @@ private:
                 // try to update next
                 if (!aNext.compare_exchange_strong(next, newNext)) {
                     // some other thread was faster => use updated next
-                    delete newNext;
+                    nodes().destroy(newNext);
                 } else {
                     // the locally created next is the new next
                     next = newNext;
@@ -980,14 +991,14 @@ public:
 
 private:
     /**
-     * A static operation utilized internally for merging sub-trees recursively.
+     * An operation utilized internally for merging sub-trees recursively.
      *
      * @param parent the parent node of the current merge operation
      * @param trg a reference to the pointer the cloned node should be stored to
      * @param src the node to be cloned
      * @param levels the height of the cloned node
      */
-    static void merge(const Node* parent, Node*& trg, const Node* src, int levels) {
+    void merge(const Node* parent, Node*& trg, const Node* src, int levels) {
         // if other side is null => done
         if (src == nullptr) {
             return;
@@ -1310,31 +1321,46 @@ private:
     //                                 Utilities
     // --------------------------------------------------------------------------
 
+    /**
+     * Obtains the source of the nodes of this array.
+     */
+    node_allocator_type& nodes() {
+        return *this;
+    }
+
+    const node_allocator_type& nodes() const {
+        return *this;
+    }
+
     /**
      * Creates new nodes and initializes them with 0.
      */
-    static Node* newNode() {
-        return new Node();
+    Node* newNode() {
+        return nodes().template create<Node>();
     }
 
     /**
      * Destroys a node and all its sub-nodes recursively.
      */
-    static void freeNodes(Node* node, int level) {
+    void freeNodes(Node* node, int level) {
         if (!node) return;
         if (level != 0) {
             for (int i = 0; i < NUM_CELLS; i++) {
                 freeNodes(node->cell[i].ptr, level - 1);
             }
         }
-        delete node;
+        nodes().destroy(node);
     }
 
     /**
      * Conducts a cleanup of the internal tree structure.
      */
     void clean() {
-        freeNodes(unsynced.root, unsynced.levels);
+        // pooled nodes are dropped together with their pool
+        if (!node_allocator_type::pooled) {
+            freeNodes(unsynced.root, unsynced.levels);
+        }
+        nodes().clear();
         unsynced.root = nullptr;
         unsynced.levels = 0;
     }
@@ -1342,14 +1368,14 @@ private:
     /**
      * Clones the given node and all its sub-nodes.
      */
-    static Node* clone(const Node* node, int level) {
+    Node* clone(const Node* node, int level) {
         // support null-pointers
         if (node == nullptr) {
             return nullptr;
         }
 
         // create a clone
-        auto* res = new Node();
+        auto* res = newNode();
 
         // handle leaf level
         if (level == 0) {
@@ -1454,7 +1480,7 @@ private:
             oldRoot->parent = info.root;
         } else {
             // throw away temporary new node
-            delete newRoot;
+            nodes().destroy(newRoot);
         }
     }
 
@@ -1616,13 +1642,14 @@ private:
  * structure.
  *
  * @tparam BITS similar to the BITS parameter of the sparse array type
+ * @tparam Allocator similar to the Allocator parameter of the sparse array type
  */
-template <unsigned BITS = 4>
+template <unsigned BITS = 4, typename Allocator = std::allocator<uint64_t>>
 class SparseBitMap {
     template <typename A>
     friend class detail::brie::SparseBitMapIter;
 
-    using this_t = SparseBitMap<BITS>;
+    using this_t = SparseBitMap<BITS, Allocator>;
 
     // the element type stored in the nested sparse array
     using value_t = uint64_t;
@@ -1635,7 +1662,7 @@ class SparseBitMap {
     };
 
     // the type of the internal data store
-    using data_store_t = SparseArray<value_t, BITS, merge_op>;
+    using data_store_t = SparseArray<value_t, BITS, merge_op, identity<value_t>, Allocator>;
     using atomic_value_t = typename data_store_t::atomic_value_type;
 
     // some constants for manipulating stored values
@@ -0,0 +1,246 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file CompressedIndex.h
+ *
+ * An immutable index of tuples searched in place while compressed
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/CompressedTuples.h"
+#include "souffle/utility/Iteration.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * An index of tuples compressed in blocks of CompressedTuples, sorted by a comparator.
+ *
+ * The first tuple of each block is kept uncompressed, so that a search binary-searches
+ * these tuples and then decodes the single block holding its result. Iterators decode
+ * the blocks they visit one at a time. The index is built at once from a sorted range,
+ * e.g., a b-tree using the same comparator, and is not modified afterwards; concurrent
+ * reads are safe.
+ *
+ * @tparam Tuple ... the type of the tuples, an array of RamDomain values
+ * @tparam Comparator ... the order of the tuples, providing less and equal
+ */
+template <typename Tuple, typename Comparator>
+class CompressedIndex {
+    using block_type = std::shared_ptr<const std::vector<Tuple>>;
+
+public:
+    /**
+     * The last block decoded by the searches of a thread, reused by its next search
+     * as long as the searches hit the same block.
+     */
+    struct operation_hints {
+        std::size_t block = 0;
+        block_type tuples;
+    };
+
+    /**
+     * The iterator type, decoding the block it refers to on first access.
+     */
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Tuple;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Tuple*;
+        using reference = const Tuple&;
+
+        iterator() = default;
+
+        iterator(const CompressedIndex* index, std::size_t block, std::size_t pos, block_type tuples = {})
+                : index(index), block(block), pos(pos), tuples(std::move(tuples)) {}
+
+        bool operator==(const iterator& other) const {
+            return block == other.block && pos == other.pos;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+        const Tuple& operator*() const {
+            if (!tuples) {
+                tuples = index->decode(block);
+            }
+            return (*tuples)[pos];
+        }
+
+        const Tuple* operator->() const {
+            return &**this;
+        }
+
+        iterator& operator++() {
+            if (++pos == index->tuples.getBlockSize(block)) {
+                block++;
+                pos = 0;
+                tuples.reset();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto res = *this;
+            ++(*this);
+            return res;
+        }
+
+    private:
+        const CompressedIndex* index = nullptr;
+        std::size_t block = 0;
+        std::size_t pos = 0;
+        mutable block_type tuples;
+    };
+
+    using chunk = range<iterator>;
+
+    CompressedIndex() : tuples(Tuple().size()) {}
+
+    /** Replace the tuples of the index by the given range, sorted by the comparator */
+    template <typename Iter>
+    void assign(Iter begin, Iter end) {
+        clear();
+        for (std::size_t i = 0; begin != end; ++begin, ++i) {
+            if (i % CompressedTuples::blockSize == 0) {
+                firsts.push_back(*begin);
+            }
+            tuples.append((*begin).data());
+        }
+        tuples.flush();
+    }
+
+    iterator begin() const {
+        return iterator(this, 0, 0);
+    }
+
+    iterator end() const {
+        return iterator(this, firsts.size(), 0);
+    }
+
+    /** The first tuple not less than the given tuple */
+    iterator lower_bound(const Tuple& t, operation_hints& hints) const {
+        return search(t, hints, [&](const Tuple& a, const Tuple& b) { return comp.less(a, b); });
+    }
+
+    iterator lower_bound(const Tuple& t) const {
+        operation_hints hints;
+        return lower_bound(t, hints);
+    }
+
+    /** The first tuple greater than the given tuple */
+    iterator upper_bound(const Tuple& t, operation_hints& hints) const {
+        return search(t, hints, [&](const Tuple& a, const Tuple& b) { return !comp.less(b, a); });
+    }
+
+    iterator upper_bound(const Tuple& t) const {
+        operation_hints hints;
+        return upper_bound(t, hints);
+    }
+
+    iterator find(const Tuple& t, operation_hints& hints) const {
+        auto pos = lower_bound(t, hints);
+        return pos != end() && comp.equal(*pos, t) ? pos : end();
+    }
+
+    iterator find(const Tuple& t) const {
+        operation_hints hints;
+        return find(t, hints);
+    }
+
+    bool contains(const Tuple& t, operation_hints& hints) const {
+        return find(t, hints) != end();
+    }
+
+    bool contains(const Tuple& t) const {
+        operation_hints hints;
+        return contains(t, hints);
+    }
+
+    /** Split the index into at most the given number of ranges of whole blocks */
+    std::vector<chunk> getChunks(std::size_t num) const {
+        std::vector<chunk> res;
+        const std::size_t step = std::max<std::size_t>(1, (firsts.size() + num - 1) / std::max<std::size_t>(1, num));
+        for (std::size_t b = 0; b < firsts.size(); b += step) {
+            res.push_back(chunk(iterator(this, b, 0), iterator(this, std::min(b + step, firsts.size()), 0)));
+        }
+        return res;
+    }
+
+    std::size_t size() const {
+        return tuples.size();
+    }
+
+    bool empty() const {
+        return firsts.empty();
+    }
+
+    /** Drop all tuples and free their memory */
+    void clear() {
+        tuples.clear();
+        std::vector<Tuple>().swap(firsts);
+    }
+
+    /** Number of bytes used by the index */
+    std::size_t getMemoryUsage() const {
+        return tuples.getMemoryUsage() + firsts.capacity() * sizeof(Tuple);
+    }
+
+private:
+    /**
+     * The first tuple of the index for which before(t, tuple) fails, where before is
+     * monotone in the order of the comparator.
+     */
+    template <typename Before>
+    iterator search(const Tuple& t, operation_hints& hints, const Before& before) const {
+        // the result is in the block preceding the first block whose first tuple is not
+        // before t, or starts that block
+        auto next = std::partition_point(
+                firsts.begin(), firsts.end(), [&](const Tuple& first) { return before(first, t); });
+        if (next == firsts.begin()) {
+            return iterator(this, 0, 0);
+        }
+        const std::size_t block = (next - firsts.begin()) - 1;
+        if (!hints.tuples || hints.block != block) {
+            hints.tuples = decode(block);
+            hints.block = block;
+        }
+        const auto& decoded = *hints.tuples;
+        auto pos = std::partition_point(
+                decoded.begin(), decoded.end(), [&](const Tuple& cur) { return before(cur, t); });
+        if (pos == decoded.end()) {
+            return iterator(this, block + 1, 0);
+        }
+        return iterator(this, block, pos - decoded.begin(), hints.tuples);
+    }
+
+    block_type decode(std::size_t block) const {
+        auto res = std::make_shared<std::vector<Tuple>>(tuples.getBlockSize(block));
+        tuples.decode(block, reinterpret_cast<RamDomain*>(res->data()));
+        return res;
+    }
+
+    Comparator comp;
+    CompressedTuples tuples;
+    /** the first tuple of each block */
+    std::vector<Tuple> firsts;
+};
+
+}  // namespace souffle
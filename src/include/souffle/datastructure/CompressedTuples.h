@@ -0,0 +1,211 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file CompressedTuples.h
+ *
+ * An immutable sequence of tuples compressed in blocks
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A sequence of tuples of a fixed width, compressed in blocks of blockSize tuples.
+ *
+ * Within a block, each column is either delta encoded, which suits the leading column
+ * of tuples appended in the order of an index, or encoded relative to its minimum
+ * (frame of reference), whichever needs fewer bits. The encoded values are bit-packed
+ * with the smallest width holding all of them, so that a block of tuples sharing
+ * their leading columns needs only a few bits per value. Any order of tuples is
+ * supported, at a worse compression for unsorted ones.
+ *
+ * Blocks are decoded one at a time, so that a search only decodes the block holding
+ * its result, see CompressedIndex.
+ */
+class CompressedTuples {
+public:
+    /** Number of tuples per block */
+    static constexpr std::size_t blockSize = 128;
+
+    explicit CompressedTuples(std::size_t width) : width(width) {}
+
+    /** Append a tuple */
+    void append(const RamDomain* tuple) {
+        pending.insert(pending.end(), tuple, tuple + width);
+        if (pending.size() == blockSize * width) {
+            flush();
+        }
+    }
+
+    /** Encode the pending tuples; required before reading the tuples */
+    void flush() {
+        if (pending.empty()) {
+            return;
+        }
+        const std::size_t count = pending.size() / width;
+        blocks.push_back({numBits, count, columns.size()});
+        numTuples += count;
+        for (std::size_t c = 0; c < width; c++) {
+            // the largest encoded value of either encoding, relative to the minimum
+            // or to the previous value
+            RamUnsigned min = value(0, c);
+            uint64_t maxDelta = 0;
+            for (std::size_t i = 1; i < count; i++) {
+                maxDelta |= RamUnsigned(value(i, c) - value(i - 1, c));
+                if (value(i, c) < min) {
+                    min = value(i, c);
+                }
+            }
+            uint64_t maxOffset = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                maxOffset |= RamUnsigned(value(i, c) - min);
+            }
+            const bool delta = maxDelta < maxOffset;
+            const uint64_t max = delta ? maxDelta : maxOffset;
+            const auto bitWidth = static_cast<uint8_t>(max == 0 ? 0 : 64 - __builtin_clzll(max));
+            columns.push_back({ramBitCast(delta ? value(0, c) : min), bitWidth, delta});
+            for (std::size_t i = delta ? 1 : 0; i < count; i++) {
+                write(RamUnsigned(value(i, c) - (delta ? value(i - 1, c) : min)), bitWidth);
+            }
+        }
+        pending.clear();
+    }
+
+    /** Decode all tuples in the order of their insertion */
+    template <typename F /* const RamDomain* -> void */>
+    void forEach(const F& f) const {
+        std::vector<RamDomain> tuples;
+        for (std::size_t b = 0; b < blocks.size(); b++) {
+            tuples.resize(blocks[b].count * width);
+            decode(b, tuples.data());
+            for (std::size_t i = 0; i < blocks[b].count; i++) {
+                f(&tuples[i * width]);
+            }
+        }
+    }
+
+    /** Decode the tuples of a block into the given buffer of getBlockSize(block) tuples */
+    void decode(std::size_t block, RamDomain* tuples) const {
+        const auto& header = blocks[block];
+        std::size_t position = header.offset;
+        for (std::size_t c = 0; c < width; c++) {
+            const auto& column = columns[header.column + c];
+            const auto base = ramBitCast<RamUnsigned>(column.base);
+            auto previous = base;
+            for (std::size_t i = 0; i < header.count; i++) {
+                RamUnsigned cur = base;
+                if (column.delta) {
+                    cur = i == 0 ? base : RamUnsigned(previous + read(position, column.bitWidth));
+                    previous = cur;
+                } else {
+                    cur = RamUnsigned(base + read(position, column.bitWidth));
+                }
+                tuples[i * width + c] = ramBitCast(cur);
+            }
+        }
+    }
+
+    /** Number of encoded tuples */
+    std::size_t size() const {
+        return numTuples;
+    }
+
+    /** Number of encoded blocks */
+    std::size_t getNumBlocks() const {
+        return blocks.size();
+    }
+
+    /** Number of tuples of an encoded block */
+    std::size_t getBlockSize(std::size_t block) const {
+        return blocks[block].count;
+    }
+
+    /** Drop all tuples and free their memory */
+    void clear() {
+        std::vector<RamDomain>().swap(pending);
+        std::vector<uint64_t>().swap(words);
+        std::vector<Block>().swap(blocks);
+        std::vector<Column>().swap(columns);
+        numTuples = 0;
+        numBits = 0;
+    }
+
+    /** Number of bytes used by the encoded tuples */
+    std::size_t getMemoryUsage() const {
+        return words.size() * sizeof(uint64_t) + blocks.size() * sizeof(Block) +
+               columns.size() * sizeof(Column);
+    }
+
+private:
+    struct Block {
+        /** position of the first bit of the block */
+        std::size_t offset;
+        /** number of tuples */
+        std::size_t count;
+        /** index of the first column header */
+        std::size_t column;
+    };
+
+    struct Column {
+        /** the first value of a delta encoded column, the minimum otherwise */
+        RamDomain base;
+        uint8_t bitWidth;
+        bool delta;
+    };
+
+    RamUnsigned value(std::size_t tuple, std::size_t column) const {
+        return ramBitCast<RamUnsigned>(pending[tuple * width + column]);
+    }
+
+    /** Append the lowest bits of a value */
+    void write(uint64_t x, uint8_t bitWidth) {
+        if (bitWidth == 0) {
+            return;
+        }
+        const std::size_t offset = numBits % 64;
+        words.resize((numBits + bitWidth + 63) / 64, 0);
+        words[numBits / 64] |= x << offset;
+        if (offset + bitWidth > 64) {
+            words[numBits / 64 + 1] |= x >> (64 - offset);
+        }
+        numBits += bitWidth;
+    }
+
+    /** Read a value of the given number of bits, advancing the position */
+    uint64_t read(std::size_t& position, uint8_t bitWidth) const {
+        if (bitWidth == 0) {
+            return 0;
+        }
+        const std::size_t offset = position % 64;
+        uint64_t x = words[position / 64] >> offset;
+        if (offset + bitWidth > 64) {
+            x |= words[position / 64 + 1] << (64 - offset);
+        }
+        position += bitWidth;
+        return bitWidth == 64 ? x : x & ((uint64_t(1) << bitWidth) - 1);
+    }
+
+    const std::size_t width;
+    std::size_t numTuples = 0;
+    std::vector<RamDomain> pending;
+    std::vector<uint64_t> words;
+    std::size_t numBits = 0;
+    std::vector<Block> blocks;
+    std::vector<Column> columns;
+};
+
+}  // namespace souffle
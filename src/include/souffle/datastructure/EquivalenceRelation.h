@@ -19,18 +19,18 @@
 #pragma once
 
 #include "souffle/RamTypes.h"
-#include "souffle/datastructure/LambdaBTree.h"
 #include "souffle/datastructure/PiggyList.h"
 #include "souffle/datastructure/UnionFind.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <functional>
 #include <iostream>
 #include <iterator>
-#include <set>
+#include <map>
 #include <shared_mutex>
 #include <stdexcept>
 #include <tuple>
@@ -44,11 +44,10 @@ class EquivalenceRelation {
 
     // mapping from representative to disjoint set
     // just a cache, essentially, used for iteration over
+    // the cache is updated incrementally, only the disjoint sets that changed are regenerated
     using StatesList = souffle::PiggyList<value_type>;
     using StatesBucket = StatesList*;
-    using StorePair = std::pair<value_type, StatesBucket>;
-    using StatesMap = souffle::LambdaBTreeSet<StorePair, std::function<StatesBucket(StorePair&)>,
-            souffle::EqrelMapComparator<StorePair>>;
+    using StatesMap = std::map<value_type, StatesBucket>;
 
 public:
     using element_type = TupleType;
@@ -101,6 +100,11 @@ public:
         // indicate that iterators will have to generate on request
         this->statesMapStale.store(true, std::memory_order_relaxed);
         bool retval = contains(x, y);
+        if (!retval) {
+            // the disjoint sets of both nodes have to be regenerated
+            touched.append(x);
+            touched.append(y);
+        }
         sds.unionNodes(x, y);
         return retval;
     }
@@ -112,19 +116,8 @@ public:
     void insertAll(const EquivalenceRelation<TupleType>& other) {
         other.genAllDisjointSetLists();
 
-        // iterate over partitions at a time
-        for (typename StatesMap::chunk it : other.equivalencePartition.getChunks(MAX_THREADS)) {
-            for (auto& p : it) {
-                value_type rep = p.first;
-                StatesList& pl = *p.second;
-                const size_t ksize = pl.size();
-                for (size_t i = 0; i < ksize; ++i) {
-                    this->sds.unionNodes(rep, pl.get(i));
-                }
-            }
-        }
-        // invalidate iterators unconditionally
-        this->statesMapStale.store(true, std::memory_order_relaxed);
+        // iterate over the disjoint sets in parallel
+        insertSets(other.getDisjointSetLists());
     }
 
     /**
@@ -137,42 +130,31 @@ public:
         // nothing to extend if there's no new/original knowledge
         if (other.size() == 0 || this->size() == 0) return;
 
-        this->genAllDisjointSetLists();
         other.genAllDisjointSetLists();
 
-        std::set<value_type> repsCovered;
-
-        // find all the disjoint sets that need to be added to this relation
-        // that exist in other (and exist in this)
+        // find all the disjoint sets of other that intersect with this relation; only the
+        // elements of this relation are visited, not all elements of other
+        std::vector<std::pair<value_type, StatesBucket>> covered;
         {
-            auto it = this->sds.sparseToDenseMap.begin();
-            auto end = this->sds.sparseToDenseMap.end();
-            value_type el;
-            for (; it != end; ++it) {
-                std::tie(el, std::ignore) = *it;
+            std::vector<value_type> repsCovered;
+            const size_t dSetSize = this->sds.ds.a_blocks.size();
+            for (size_t i = 0; i < dSetSize; ++i) {
+                const value_type el = this->sds.toSparse(i);
                 if (other.containsElement(el)) {
-                    value_type rep = other.sds.findNode(el);
-                    if (repsCovered.count(rep) == 0) {
-                        repsCovered.emplace(rep);
-                    }
+                    repsCovered.push_back(other.sds.findNode(el));
                 }
             }
+            std::sort(repsCovered.begin(), repsCovered.end());
+            repsCovered.erase(std::unique(repsCovered.begin(), repsCovered.end()), repsCovered.end());
+            for (value_type rep : repsCovered) {
+                auto found = other.equivalencePartition.find(rep);
+                assert(found != other.equivalencePartition.end() && "disjoint set of other is not cached");
+                covered.push_back(*found);
+            }
         }
 
         // add the intersecting dj sets into this one
-        {
-            value_type el;
-            value_type rep;
-            auto it = other.sds.sparseToDenseMap.begin();
-            auto end = other.sds.sparseToDenseMap.end();
-            for (; it != end; ++it) {
-                std::tie(el, std::ignore) = *it;
-                rep = other.sds.findNode(el);
-                if (repsCovered.count(rep) != 0) {
-                    this->insert(el, rep);
-                }
-            }
-        }
+        insertSets(covered);
     }
 
     /**
@@ -205,6 +187,7 @@ public:
         this->statesMapStale.store(true, std::memory_order_relaxed);
 
         equivalencePartition.clear();
+        cachedRep.clear();
     }
 
     /**
@@ -215,6 +198,7 @@ public:
 
         sds.clear();
         emptyPartition();
+        touched.clear();
 
         statesLock.unlock();
     }
@@ -238,6 +222,17 @@ public:
         return retVal;
     }
 
+    /**
+     * Estimate of the memory used by the relation
+     * @return the number of bytes of the disjoint set, its mapping from and to the dense
+     * values, and the cached disjoint set lists with their representatives
+     */
+    size_t getMemoryUsage() const {
+        const size_t elements = sds.size();
+        return sizeof(*this) + elements * (sizeof(block_t) + sizeof(std::pair<value_type, parent_t>) +
+                                                  3 * sizeof(value_type));
+    }
+
     // an almighty iterator for several types of iteration.
     // Unfortunately, subclassing isn't an option with souffle
     //   - we don't deal with pointers (so no virtual)
@@ -604,7 +599,7 @@ public:
         genAllDisjointSetLists();
 
         // locate the blocklist that the anterior val resides in
-        auto found = equivalencePartition.find({sds.findNode(anteriorVal), nullptr});
+        auto found = equivalencePartition.find(sds.findNode(anteriorVal));
         assert(found != equivalencePartition.end() && "iterator called on partition that doesn't exist");
 
         return iterator(static_cast<const EquivalenceRelation*>(this),
@@ -626,7 +621,7 @@ public:
         genAllDisjointSetLists();
 
         // locate the blocklist that the val resides in
-        auto found = equivalencePartition.find({sds.findNode(posteriorVal), nullptr});
+        auto found = equivalencePartition.find(sds.findNode(posteriorVal));
         assert(found != equivalencePartition.end() && "iterator called on partition that doesn't exist");
 
         return iterator(this, anteriorVal, posteriorVal, (*found).second);
@@ -641,7 +636,7 @@ public:
         genAllDisjointSetLists();
 
         // locate the blocklist that the val resides in
-        auto found = equivalencePartition.find({sds.findNode(rep), nullptr});
+        auto found = equivalencePartition.find(sds.findNode(rep));
         return iterator(this, (*found).second);
     }
 
@@ -715,9 +710,54 @@ private:
     // whether the cache is stale
     mutable std::atomic<bool> statesMapStale;
 
+    // nodes whose disjoint sets were merged since the cache was generated
+    mutable PiggyList<value_type> touched;
+    // for each dense node in the cache, the representative its disjoint set is cached under
+    mutable std::vector<value_type> cachedRep;
+
+    /**
+     * Union all elements of the given disjoint sets into this relation, in parallel over the sets
+     */
+    void insertSets(const std::vector<std::pair<value_type, StatesBucket>>& sets) {
+        const size_t numSets = sets.size();
+        PARALLEL_START
+        pfor(size_t i = 0; i < numSets; ++i) {
+            const value_type rep = sets[i].first;
+            StatesList& pl = *sets[i].second;
+            const size_t ksize = pl.size();
+            for (size_t j = 0; j < ksize; ++j) {
+                this->insert(pl.get(j), rep);
+            }
+        }
+        PARALLEL_END
+    }
+
+    /**
+     * Get the cached disjoint sets as a list, e.g. for parallel iteration over them
+     */
+    std::vector<std::pair<value_type, StatesBucket>> getDisjointSetLists() const {
+        return std::vector<std::pair<value_type, StatesBucket>>(
+                equivalencePartition.begin(), equivalencePartition.end());
+    }
+
+    /**
+     * Add a node to the cached disjoint set of its representative
+     */
+    void cacheNode(value_type sparseVal) const {
+        const value_type rep = this->sds.findNode(sparseVal);
+        StatesBucket& mapList = equivalencePartition[rep];
+        if (mapList == nullptr) {
+            mapList = new StatesList(1);
+        }
+        mapList->append(sparseVal);
+        cachedRep[this->sds.toDense(sparseVal)] = rep;
+    }
+
     /**
      * Generate a cache of the sets such that they can be iterated over efficiently.
      * Each set is partitioned into a PiggyList.
+     * Only the sets of the nodes that were merged or added since the last generation are
+     * regenerated, unless most of the nodes changed.
      */
     void genAllDisjointSetLists() const {
         statesLock.lock();
@@ -728,22 +768,47 @@ private:
             return;
         }
 
-        // btree version
-        emptyPartition();
+        const size_t dSetSize = this->sds.ds.a_blocks.size();
+        const size_t numCached = cachedRep.size();
+        if (numCached == 0 || 2 * (touched.size() + dSetSize - numCached) > dSetSize) {
+            // regenerate from scratch
+            emptyPartition();
+            cachedRep.resize(dSetSize);
+            for (size_t i = 0; i < dSetSize; ++i) {
+                cacheNode(this->sds.toSparse(i));
+            }
+        } else {
+            // collect the nodes of the merged sets, and the nodes added since the last generation
+            std::vector<value_type> oldReps;
+            for (size_t i = 0; i < touched.size(); ++i) {
+                const parent_t dense = this->sds.toDense(touched.get(i));
+                if (dense < numCached) {
+                    oldReps.push_back(cachedRep[dense]);
+                }
+            }
+            std::sort(oldReps.begin(), oldReps.end());
+            oldReps.erase(std::unique(oldReps.begin(), oldReps.end()), oldReps.end());
+
+            std::vector<value_type> nodes;
+            for (value_type rep : oldReps) {
+                auto found = equivalencePartition.find(rep);
+                assert(found != equivalencePartition.end() && "cached set of node does not exist");
+                for (const auto& node : *found->second) {
+                    nodes.push_back(node);
+                }
+                delete found->second;
+                equivalencePartition.erase(found);
+            }
+            for (size_t i = numCached; i < dSetSize; ++i) {
+                nodes.push_back(this->sds.toSparse(i));
+            }
 
-        size_t dSetSize = this->sds.ds.a_blocks.size();
-        for (size_t i = 0; i < dSetSize; ++i) {
-            typename TupleType::value_type sparseVal = this->sds.toSparse(i);
-            parent_t rep = this->sds.findNode(sparseVal);
-
-            StorePair p = {static_cast<value_type>(rep), nullptr};
-            StatesList* mapList = equivalencePartition.insert(p, [&](StorePair& sp) {
-                auto* r = new StatesList(1);
-                sp.second = r;
-                return r;
-            });
-            mapList->append(sparseVal);
+            cachedRep.resize(dSetSize);
+            for (value_type node : nodes) {
+                cacheNode(node);
+            }
         }
+        touched.clear();
 
         statesMapStale.store(false, std::memory_order_release);
         statesLock.unlock();
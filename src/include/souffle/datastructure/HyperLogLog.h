@@ -0,0 +1,96 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file HyperLogLog.h
+ *
+ * Defines a HyperLogLog sketch for estimating the number of distinct values
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace souffle {
+
+/**
+ * A HyperLogLog sketch (Flajolet et al.) estimating the number of distinct 64-bit
+ * hash values inserted into it. The sketch uses 2^Precision one-byte registers,
+ * which gives a standard error of about 1.04 / sqrt(2^Precision).
+ */
+template <unsigned Precision = 12>
+class HyperLogLog {
+    static_assert(4 <= Precision && Precision <= 16, "unsupported precision");
+
+public:
+    /** Number of registers */
+    static constexpr std::size_t numRegisters = std::size_t(1) << Precision;
+
+    /** Mix the bits of a value, so that similar values end up with unrelated hashes */
+    static uint64_t hash(uint64_t value) {
+        // finaliser of splitmix64
+        value += 0x9e3779b97f4a7c15ULL;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    /** Combine a hash with the next value of a sequence */
+    static uint64_t combine(uint64_t seed, uint64_t value) {
+        return hash(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+    }
+
+    /** Insert a hash value */
+    void insert(uint64_t hashValue) {
+        const std::size_t idx = hashValue >> (64 - Precision);
+        // position of the first set bit of the remaining bits, with a sentinel bit to bound it
+        const uint64_t rest = (hashValue << Precision) | (uint64_t(1) << (Precision - 1));
+        const auto rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+        if (rank > registers[idx]) {
+            registers[idx] = rank;
+        }
+    }
+
+    /** Merge another sketch into this sketch */
+    void merge(const HyperLogLog& other) {
+        for (std::size_t i = 0; i < numRegisters; i++) {
+            if (other.registers[i] > registers[i]) {
+                registers[i] = other.registers[i];
+            }
+        }
+    }
+
+    /** Estimate the number of distinct hash values inserted */
+    double estimate() const {
+        const double m = numRegisters;
+        double sum = 0;
+        std::size_t zeros = 0;
+        for (uint8_t reg : registers) {
+            sum += std::ldexp(1.0, -reg);
+            zeros += (reg == 0) ? 1 : 0;
+        }
+        const double alpha = 0.7213 / (1.0 + 1.079 / m);
+        const double raw = alpha * m * m / sum;
+
+        // small cardinalities are estimated more precisely by linear counting
+        if (raw <= 2.5 * m && zeros > 0) {
+            return m * std::log(m / zeros);
+        }
+        return raw;
+    }
+
+private:
+    std::array<uint8_t, numRegisters> registers{};
+};
+
+}  // namespace souffle
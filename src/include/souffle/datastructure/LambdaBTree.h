@@ -83,7 +83,7 @@ public:
             }
 
             // create new node
-            this->leftmost = new typename parenttype::leaf_node();
+            this->leftmost = this->nodes.template create<typename parenttype::leaf_node>();
             this->leftmost->numElements = 1;
             // call the functor as we've successfully inserted
             typename Functor::result_type res = f(k);
@@ -313,7 +313,7 @@ public:
 
                 // split this node
                 auto old_root = this->root;
-                idx -= cur->rebalance_or_split(
+                idx -= cur->rebalance_or_split(this->nodes,
                         const_cast<typename parenttype::node**>(&this->root), this->root_lock, idx, parents);
 
                 // release parent lock
@@ -367,7 +367,7 @@ public:
         // special handling for inserting first element
         if (this->empty()) {
             // create new node
-            this->leftmost = new typename parenttype::leaf_node();
+            this->leftmost = this->nodes.template create<typename parenttype::leaf_node>();
             this->leftmost->numElements = 1;
             // call the functor as we've successfully inserted
             typename Functor::result_type res = f(k);
@@ -444,7 +444,7 @@ public:
 
             if (cur->numElements >= parenttype::node::maxKeys) {
                 // split this node
-                idx -= cur->rebalance_or_split(
+                idx -= cur->rebalance_or_split(this->nodes,
                         const_cast<typename parenttype::node**>(&this->root), this->root_lock, idx);
 
                 // insert element in right fragment
@@ -498,6 +498,7 @@ public:
         // swap the content
         std::swap(this->root, other.root);
         std::swap(this->leftmost, other.leftmost);
+        this->nodes.swap(other.nodes);
     }
 
     // Implementation of the assignment operation for trees.
@@ -514,7 +515,7 @@ public:
         }
 
         // clone content (deep copy)
-        this->root = other.root->clone();
+        this->root = other.root->clone(this->nodes);
 
         // update leftmost reference
         auto tmp = this->root;
@@ -0,0 +1,300 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file NodePool.h
+ *
+ * Pooled allocation of the nodes of b-trees and sparse arrays
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/HugePageUtil.h"
+#include "souffle/utility/NumaUtil.h"
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * An arena for the nodes of a single container. Nodes are carved out of slabs, and
+ * every thread draws from slabs of its own, so that concurrent insertions neither
+ * contend on the heap nor interleave their nodes. Nodes are never freed one at a
+ * time; clear() drops all nodes at once.
+ *
+ * Containers cleared in every iteration of a fixpoint refill their pool right away,
+ * so clear() keeps the slabs for reuse. Slabs that stay unused until the following
+ * clear() are returned to the heap then, and release() returns all of them.
+ */
+class NodePool {
+public:
+    /** The number of per-thread slab cursors; threads beyond share cursors */
+    static constexpr std::size_t numSlots = 32;
+
+    /**
+     * The size of the first slab of a thread, doubling up to maxSlabSize. With huge pages,
+     * slabs grow further to the size of a huge page and are mapped as such.
+     */
+    static constexpr std::size_t minSlabSize = std::size_t(1) << 11;
+    static constexpr std::size_t maxSlabSize = std::size_t(1) << 20;
+
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        release();
+        delete[] slots.load();
+    }
+
+    /** Allocate memory of the given size and alignment; thread-safe */
+    void* allocate(std::size_t size, std::size_t alignment) {
+        Slot& slot = getSlot();
+        std::lock_guard<SpinLock> guard(slot.lock);
+        std::uintptr_t pos = align(slot.cur, alignment);
+        if (slot.cur == nullptr || pos + size > reinterpret_cast<std::uintptr_t>(slot.end)) {
+            const Slab slab = newSlab(std::max(slot.nextSize, size + alignment));
+            slot.nextSize = std::min(slot.nextSize * 2, getMaxSlabSize());
+            slot.cur = slab.memory;
+            slot.end = slab.memory + slab.size;
+            pos = align(slot.cur, alignment);
+        }
+        slot.cur = reinterpret_cast<char*>(pos + size);
+        return reinterpret_cast<void*>(pos);
+    }
+
+    /** Drop all allocations, keeping the slabs for reuse; not thread-safe */
+    void clear() {
+        free(spare);
+        spare.swap(slabs);
+        resetSlots();
+    }
+
+    /** Drop all allocations and free all memory of the pool; not thread-safe */
+    void release() {
+        free(spare);
+        free(slabs);
+        resetSlots();
+    }
+
+    /** Get the number of bytes held by the pool */
+    std::size_t getMemoryUsage() const {
+        return allocated;
+    }
+
+    void swap(NodePool& other) {
+        slabs.swap(other.slabs);
+        spare.swap(other.spare);
+        std::swap(allocated, other.allocated);
+        Slot* cur = slots.load();
+        slots.store(other.slots.load());
+        other.slots.store(cur);
+    }
+
+private:
+    struct Slab {
+        char* memory;
+        std::size_t size;
+        /** whether the slab is mapped by HugePages */
+        bool mapped;
+    };
+
+    struct alignas(64) Slot {
+        SpinLock lock;
+        char* cur = nullptr;
+        char* end = nullptr;
+        std::size_t nextSize = minSlabSize;
+    };
+
+    static std::size_t getMaxSlabSize() {
+        return HugePages::instance().isEnabled() ? HugePages::pageSize : maxSlabSize;
+    }
+
+    static std::uintptr_t align(const char* ptr, std::size_t alignment) {
+        const auto pos = reinterpret_cast<std::uintptr_t>(ptr);
+        return (pos + alignment - 1) & ~std::uintptr_t(alignment - 1);
+    }
+
+    /** Get the slab cursor of the calling thread, creating the cursors on first use */
+    Slot& getSlot() {
+        static std::atomic<std::size_t> numThreads{0};
+        static thread_local const std::size_t thread = numThreads++;
+        Slot* cur = slots.load(std::memory_order_acquire);
+        if (cur == nullptr) {
+            Slot* fresh = new Slot[numSlots];
+            if (slots.compare_exchange_strong(cur, fresh, std::memory_order_acq_rel)) {
+                cur = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        return cur[thread % numSlots];
+    }
+
+    /** Obtain a slab of at least the given size, reusing a spare slab if possible */
+    Slab newSlab(std::size_t size) {
+        std::lock_guard<Lock> guard(slabLock);
+        auto reusable = std::find_if(
+                spare.rbegin(), spare.rend(), [&](const Slab& slab) { return slab.size >= size; });
+        if (reusable != spare.rend()) {
+            const Slab slab = *reusable;
+            spare.erase(std::next(reusable).base());
+            slabs.push_back(slab);
+            return slab;
+        }
+        char* memory;
+        bool mapped = false;
+        const Numa& numa = Numa::instance();
+        if (HugePages::instance().isEnabled() && size >= HugePages::pageSize) {
+            size = HugePages::roundUp(size);
+            memory = static_cast<char*>(HugePages::instance().map(size));
+            mapped = true;
+            numa.place(memory, size);
+        } else if (numa.isEnabled()) {
+            // whole pages, placed on their nodes before the first touch
+            const std::size_t pageSize = Numa::getPageSize();
+            size = (size + pageSize - 1) & ~(pageSize - 1);
+            void* pages = nullptr;
+            memory = posix_memalign(&pages, pageSize, size) == 0 ? static_cast<char*>(pages) : nullptr;
+            if (memory != nullptr) {
+                numa.place(memory, size);
+            }
+        } else {
+            memory = static_cast<char*>(std::malloc(size));
+        }
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        slabs.push_back({memory, size, mapped});
+        allocated += size;
+        return slabs.back();
+    }
+
+    void free(std::vector<Slab>& list) {
+        for (const Slab& slab : list) {
+            if (slab.mapped) {
+                HugePages::instance().unmap(slab.memory, slab.size);
+            } else {
+                std::free(slab.memory);
+            }
+            allocated -= slab.size;
+        }
+        list.clear();
+    }
+
+    void resetSlots() {
+        if (Slot* cur = slots.load()) {
+            for (std::size_t i = 0; i < numSlots; i++) {
+                cur[i].cur = nullptr;
+                cur[i].end = nullptr;
+                cur[i].nextSize = minSlabSize;
+            }
+        }
+    }
+
+    std::atomic<Slot*> slots{nullptr};
+    Lock slabLock;
+    /** slabs holding the current allocations */
+    std::vector<Slab> slabs;
+    /** slabs kept by the last clear() */
+    std::vector<Slab> spare;
+    /** number of bytes of all slabs */
+    std::size_t allocated = 0;
+};
+
+/**
+ * An allocator selecting pooled nodes for the containers that accept it as their
+ * Allocator parameter (btree and SparseArray). Each container instance then owns a
+ * NodePool, whose nodes are dropped as a whole when the container is cleared.
+ */
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+};
+
+namespace detail {
+
+/**
+ * Creates and destroys the nodes of a container according to its allocator. By default,
+ * nodes are allocated individually on the heap.
+ */
+template <typename Allocator>
+struct node_allocator {
+    /** whether memory of destroyed nodes is only returned by clear() */
+    static constexpr bool pooled = false;
+
+    template <typename Node>
+    Node* create() {
+        return new Node();
+    }
+
+    template <typename Node>
+    void destroy(Node* node) {
+        delete node;
+    }
+
+    void clear() {}
+
+    std::size_t getMemoryUsage() const {
+        return 0;
+    }
+
+    void swap(node_allocator&) {}
+};
+
+template <typename T>
+struct node_allocator<PoolAllocator<T>> {
+    static constexpr bool pooled = true;
+
+    node_allocator() = default;
+
+    // copies of a container own separate pools
+    node_allocator(const node_allocator&) {}
+
+    node_allocator& operator=(const node_allocator&) {
+        return *this;
+    }
+
+    template <typename Node>
+    Node* create() {
+        return new (pool.allocate(sizeof(Node), alignof(Node))) Node();
+    }
+
+    template <typename Node>
+    void destroy(Node* node) {
+        node->~Node();
+    }
+
+    void clear() {
+        pool.clear();
+    }
+
+    std::size_t getMemoryUsage() const {
+        return pool.getMemoryUsage();
+    }
+
+    void swap(node_allocator& other) {
+        pool.swap(other.pool);
+    }
+
+    NodePool pool;
+};
+
+}  // namespace detail
+
+}  // namespace souffle
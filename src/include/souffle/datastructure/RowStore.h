@@ -0,0 +1,119 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RowStore.h
+ *
+ * Storage of tuples addressed by row ids, shared by the indexes of a relation
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/PiggyList.h"
+#include <cstddef>
+#include <iterator>
+
+namespace souffle {
+
+/**
+ * An append-only store of tuples, which are addressed by their row ids. Row ids are
+ * assigned in the order of insertion and are stored as RamDomain values, so that
+ * indexes can keep them as an extra column of their keys instead of whole tuples.
+ * Appending is thread-safe, and stored tuples do not move.
+ */
+template <std::size_t Arity>
+class RowStore {
+public:
+    using t_tuple = Tuple<RamDomain, Arity>;
+
+    /**
+     * An iterator over index entries whose last column is a row id, producing the
+     * tuples of these rows.
+     */
+    template <typename Iter>
+    class iterator {
+        Iter iter;
+        const RowStore* store = nullptr;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = t_tuple;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const t_tuple*;
+        using reference = const t_tuple&;
+
+        iterator() = default;
+
+        iterator(Iter iter, const RowStore* store) : iter(std::move(iter)), store(store) {}
+
+        bool operator==(const iterator& other) const {
+            return iter == other.iter;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return iter != other.iter;
+        }
+
+        const t_tuple& operator*() const {
+            const auto& entry = *iter;
+            return (*store)[entry[entry.size() - 1]];
+        }
+
+        const t_tuple* operator->() const {
+            return &**this;
+        }
+
+        iterator& operator++() {
+            ++iter;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto res = *this;
+            ++iter;
+            return res;
+        }
+    };
+
+    /** Append a tuple, returning its row id */
+    RamDomain append(const t_tuple& t) {
+        return ramBitCast(static_cast<RamUnsigned>(rows.append(t)));
+    }
+
+    /** Get the tuple of a row id */
+    const t_tuple& operator[](RamDomain row) const {
+        return rows.get(ramBitCast<RamUnsigned>(row));
+    }
+
+    /** Wrap an iterator over index entries */
+    template <typename Iter>
+    iterator<Iter> wrap(Iter iter) const {
+        return iterator<Iter>(std::move(iter), this);
+    }
+
+    std::size_t size() const {
+        return rows.size();
+    }
+
+    void clear() {
+        rows.clear();
+    }
+
+    std::size_t getMemoryUsage() const {
+        return rows.size() * sizeof(t_tuple);
+    }
+
+private:
+    /** rows, starting with blocks of 256 tuples */
+    PiggyList<t_tuple> rows{8};
+};
+
+}  // namespace souffle
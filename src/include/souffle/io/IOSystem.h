@@ -19,9 +19,12 @@
 #include "souffle/io/ReadStream.h"
 #include "souffle/io/ReadStreamCSV.h"
 #include "souffle/io/ReadStreamJSON.h"
+#include "souffle/io/ReadStreamSpill.h"
 #include "souffle/io/WriteStream.h"
 #include "souffle/io/WriteStreamCSV.h"
 #include "souffle/io/WriteStreamJSON.h"
+#include "souffle/io/WriteStreamSpill.h"
+#include "souffle/io/WriteStreamStatistics.h"
 
 #ifdef USE_SQLITE
 #include "souffle/io/ReadStreamSQLite.h"
@@ -86,6 +89,9 @@ private:
         registerWriteStreamFactory(std::make_shared<WriteCoutPrintSizeFactory>());
         registerWriteStreamFactory(std::make_shared<WriteFileJSONFactory>());
         registerWriteStreamFactory(std::make_shared<WriteCoutJSONFactory>());
+        registerWriteStreamFactory(std::make_shared<WriteStatisticsFactory>());
+        registerReadStreamFactory(std::make_shared<ReadFileSpillFactory>());
+        registerWriteStreamFactory(std::make_shared<WriteFileSpillFactory>());
 #ifdef USE_SQLITE
         registerReadStreamFactory(std::make_shared<ReadSQLiteFactory>());
         registerWriteStreamFactory(std::make_shared<WriteSQLiteFactory>());
@@ -0,0 +1,139 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ReadQueue.h
+ *
+ * Reads input relations ahead of their use
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Queue of loads of input relations, in the order in which the relations are used.
+ * The loads run ahead on their own threads, but at most `budget` relations are loaded
+ * ahead of their use at any time, which bounds the memory held by relations that are not
+ * used yet. Waiting for a relation whose load has not started yet runs it right away.
+ *
+ * A relation must not be used until its loads have been waited for. Sequential builds
+ * load relations when they are waited for.
+ */
+class ReadQueue {
+public:
+    explicit ReadQueue(std::size_t budget) : budget(std::max<std::size_t>(budget, 1)) {}
+
+    ~ReadQueue() {
+        std::vector<std::future<void>> started;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (auto& load : loads) {
+                if (load.started) {
+                    started.push_back(std::move(load.result));
+                }
+            }
+            loads.clear();
+        }
+        for (auto& load : started) {
+            load.wait();
+        }
+    }
+
+    /** Add a load of a relation; loads have to be added in the order of their use */
+    void add(const void* relation, std::function<void()> read) {
+        std::lock_guard<std::mutex> guard(lock);
+        loads.push_back({relation, std::move(read), {}, false});
+    }
+
+    /** Start loading ahead */
+    void start() {
+        std::lock_guard<std::mutex> guard(lock);
+        startLoads();
+    }
+
+    /** Wait for the loads of a relation */
+    void wait(const void* relation) {
+        std::vector<std::future<void>> started;
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (auto it = loads.begin(); it != loads.end();) {
+                if (it->relation != relation) {
+                    ++it;
+                    continue;
+                }
+                if (it->started) {
+                    started.push_back(std::move(it->result));
+                    --running;
+                } else {
+                    pending.push_back(std::move(it->read));
+                }
+                it = loads.erase(it);
+            }
+        }
+        for (auto& read : pending) {
+            read();
+        }
+        for (auto& load : started) {
+            load.get();
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        startLoads();
+    }
+
+private:
+    struct Load {
+        const void* relation;
+        std::function<void()> read;
+        std::future<void> result;
+        bool started;
+    };
+
+    /** Start the next loads within the budget */
+    void startLoads() {
+#ifdef IS_PARALLEL
+        for (auto& load : loads) {
+            if (running >= budget) {
+                break;
+            }
+            if (!load.started) {
+                load.result = std::async(std::launch::async, std::move(load.read));
+                load.started = true;
+                ++running;
+            }
+        }
+#endif
+    }
+
+    /** maximal number of relations loaded ahead of their use */
+    const std::size_t budget;
+
+    /** number of started loads that have not been waited for */
+    std::size_t running = 0;
+
+    /** loads that have not been waited for, in the order of their use */
+    std::list<Load> loads;
+
+    std::mutex lock;
+};
+
+}  // namespace souffle
@@ -26,6 +26,7 @@
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <stdexcept>
 #include <string>
@@ -42,11 +43,17 @@ protected:
 public:
     template <typename T>
     void readAll(T& relation) {
-        auto lease = symbolTable.acquireLock();
-        (void)lease;
+        // the symbol table is released now and then, so that a relation read in the
+        // background does not stall the evaluation inserting new symbols
+        std::optional<Lock::Lease> lease(symbolTable.acquireLock());
+        size_t count = 0;
         while (const auto next = readNextTuple()) {
             const RamDomain* ramDomain = next.get();
             relation.insert(ramDomain);
+            if (++count % 4096 == 0) {
+                lease.reset();
+                lease.emplace(symbolTable.acquireLock());
+            }
         }
     }
 
@@ -0,0 +1,107 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ReadStreamSpill.h
+ *
+ * Reads the raw tuples of a relation spilled to disk
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/io/ReadStream.h"
+#include "souffle/utility/MiscUtil.h"
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace souffle {
+
+/**
+ * Reads the raw tuples written by WriteFileSpill. The file is mapped into memory, so
+ * that the tuples are copied straight from the page cache into the relation.
+ */
+class ReadFileSpill : public ReadStream {
+public:
+    ReadFileSpill(const std::map<std::string, std::string>& rwOperation, SymbolTable& symbolTable,
+            RecordTable& recordTable)
+            : ReadStream(rwOperation, symbolTable, recordTable), fileName(rwOperation.at("filename")),
+              width(arity + auxiliaryArity) {
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::invalid_argument("Cannot open spill file " + fileName);
+        }
+        struct stat status;
+        if (::fstat(fd, &status) == 0) {
+            length = static_cast<std::size_t>(status.st_size);
+        }
+        if (length > 0) {
+            data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("Cannot map spill file " + fileName);
+        }
+        if (length > 0) {
+            ::madvise(data, length, MADV_SEQUENTIAL);
+        }
+    }
+
+    ~ReadFileSpill() override {
+        if (length > 0) {
+            ::munmap(data, length);
+        }
+    }
+
+protected:
+    Own<RamDomain[]> readNextTuple() override {
+        if (position >= length) {
+            return nullptr;
+        }
+        Own<RamDomain[]> tuple = mk<RamDomain[]>(width);
+        const std::size_t bytes = width * sizeof(RamDomain);
+        if (position + bytes > length) {
+            throw std::runtime_error("Truncated spill file " + fileName);
+        }
+        std::memcpy(tuple.get(), static_cast<const char*>(data) + position, bytes);
+        position += bytes;
+        return tuple;
+    }
+
+    const std::string fileName;
+    const std::size_t width;
+    void* data = nullptr;
+    std::size_t length = 0;
+    std::size_t position = 0;
+};
+
+class ReadFileSpillFactory : public ReadStreamFactory {
+public:
+    Own<ReadStream> getReader(const std::map<std::string, std::string>& rwOperation, SymbolTable& symbolTable,
+            RecordTable& recordTable) override {
+        return mk<ReadFileSpill>(rwOperation, symbolTable, recordTable);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "spill";
+        return name;
+    }
+    ~ReadFileSpillFactory() override = default;
+};
+
+} /* namespace souffle */
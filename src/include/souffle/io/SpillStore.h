@@ -0,0 +1,186 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SpillStore.h
+ *
+ * Keeps relations on disk, or compressed in memory, while they are not needed
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/datastructure/CompressedTuples.h"
+#include "souffle/io/IOSystem.h"
+#include "souffle/io/WriteStream.h"
+#include "souffle/utility/MiscUtil.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace souffle {
+
+/**
+ * Store of the spilled relations. A relation that is not needed by the next
+ * strata is spilled while the memory used by all relations exceeds the limit, and it is
+ * restored before a later stratum uses it. Spilled relations are written in a raw binary
+ * format to a temporary directory, which is created with the first spill and removed
+ * with the store.
+ *
+ * A store compressing spills keeps spilled relations in memory instead, compressed in
+ * the order of their iteration by CompressedTuples. The compressed tuples cannot be
+ * searched; like a spill file, they are decoded into the relation before it is used.
+ */
+class SpillStore {
+public:
+    /** Create a store for the given limit in bytes */
+    explicit SpillStore(std::size_t limit, bool compress = false) : limit(limit), compress(compress) {}
+
+    ~SpillStore() {
+        for (const auto& cur : files) {
+            std::remove(cur.second.c_str());
+        }
+        if (!directory.empty()) {
+            ::rmdir(directory.c_str());
+        }
+    }
+
+    /** Whether the given memory usage in bytes exceeds the limit */
+    bool exceeds(std::size_t usage) const {
+        return usage > limit;
+    }
+
+    /** Whether a relation is spilled */
+    bool isSpilled(const std::string& name) {
+        std::lock_guard<std::mutex> guard(lock);
+        return files.count(name) > 0 || compressed.count(name) > 0;
+    }
+
+    /** Whether spilled relations are compressed in memory */
+    bool isCompressing() const {
+        return compress;
+    }
+
+    /** Get the number of bytes used by a compressed spilled relation */
+    std::size_t getCompressedMemoryUsage(const std::string& name) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto cur = compressed.find(name);
+        return cur == compressed.end() ? 0 : cur->second.getMemoryUsage();
+    }
+
+    /** Write a relation to disk, or compress it in memory, and purge it */
+    template <typename Relation>
+    void spill(Relation& relation, std::map<std::string, std::string> directives,
+            const SymbolTable& symbolTable, const RecordTable& recordTable) {
+        const std::string name = directives.at("name");
+        std::lock_guard<std::mutex> guard(lock);
+        if (files.count(name) > 0 || compressed.count(name) > 0) {
+            return;
+        }
+        if (compress) {
+            CompressingWriter writer(directives, symbolTable, recordTable);
+            writer.writeAll(relation);
+            writer.tuples.flush();
+            relation.purge();
+            compressed.emplace(name, std::move(writer.tuples));
+            return;
+        }
+        directives["IO"] = "spill";
+        directives["filename"] = getDirectory() + "/" + name;
+        IOSystem::getInstance().getWriter(directives, symbolTable, recordTable)->writeAll(relation);
+        relation.purge();
+        files[name] = directives["filename"];
+    }
+
+    /** Read a spilled relation back from disk, or decode it; relations that are not spilled are kept */
+    template <typename Relation>
+    void restore(Relation& relation, std::map<std::string, std::string> directives, SymbolTable& symbolTable,
+            RecordTable& recordTable) {
+        const std::string name = directives.at("name");
+        std::lock_guard<std::mutex> guard(lock);
+        auto tuples = compressed.find(name);
+        if (tuples != compressed.end()) {
+            tuples->second.forEach([&](const RamDomain* tuple) { relation.insert(tuple); });
+            compressed.erase(tuples);
+            return;
+        }
+        auto file = files.find(name);
+        if (file == files.end()) {
+            return;
+        }
+        directives["IO"] = "spill";
+        directives["filename"] = file->second;
+        IOSystem::getInstance().getReader(directives, symbolTable, recordTable)->readAll(relation);
+        std::remove(file->second.c_str());
+        files.erase(file);
+    }
+
+private:
+    /** Compresses the tuples of a relation, including their auxiliary columns */
+    class CompressingWriter : public WriteStream {
+    public:
+        CompressingWriter(const std::map<std::string, std::string>& rwOperation,
+                const SymbolTable& symbolTable, const RecordTable& recordTable)
+                : WriteStream(rwOperation, symbolTable, recordTable), tuples(arity + auxiliaryArity) {}
+
+        CompressedTuples tuples;
+
+    protected:
+        void writeNullary() override {
+            fatal("nullary relations are not spilled");
+        }
+
+        void writeNextTuple(const RamDomain* tuple) override {
+            tuples.append(tuple);
+        }
+    };
+
+    /** Get the directory of the spill files, creating it on first use */
+    const std::string& getDirectory() {
+        if (directory.empty()) {
+            const char* tmp = std::getenv("TMPDIR");
+            std::string pattern = std::string(tmp != nullptr ? tmp : "/tmp") + "/souffle-spill-XXXXXX";
+            std::vector<char> buffer(pattern.begin(), pattern.end());
+            buffer.push_back('\0');
+            if (::mkdtemp(buffer.data()) == nullptr) {
+                throw std::runtime_error("Cannot create spill directory " + pattern);
+            }
+            directory = buffer.data();
+        }
+        return directory;
+    }
+
+    /** memory limit in bytes */
+    const std::size_t limit;
+
+    /** whether spilled relations are compressed in memory rather than written to disk */
+    const bool compress;
+
+    /** directory of the spill files */
+    std::string directory;
+
+    /** spill files of the spilled relations */
+    std::map<std::string, std::string> files;
+
+    /** compressed tuples of the relations spilled in memory */
+    std::map<std::string, CompressedTuples> compressed;
+
+    std::mutex lock;
+};
+
+}  // namespace souffle
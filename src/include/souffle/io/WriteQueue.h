@@ -0,0 +1,127 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file WriteQueue.h
+ *
+ * Writes output relations in the background
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Queue of pending writes of output relations. Each write runs on its own thread, and
+ * at most `budget` writes are pending at any time, i.e., a new write first waits for the
+ * oldest pending write once the budget is exhausted.
+ *
+ * A relation must not be modified while it is written, so the writes of a relation
+ * have to be waited for before the relation is cleared. Sequential builds write
+ * relations immediately.
+ */
+class WriteQueue {
+public:
+    explicit WriteQueue(std::size_t budget) : budget(std::max<std::size_t>(budget, 1)) {}
+
+    ~WriteQueue() {
+        waitAll();
+    }
+
+    /** Start writing a relation in the background */
+    void submit(const void* relation, std::function<void()> write) {
+#ifdef IS_PARALLEL
+        std::vector<std::future<void>> overdue;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            while (pending.size() >= budget) {
+                overdue.push_back(std::move(pending.front().second));
+                pending.pop_front();
+            }
+        }
+        finish(overdue);
+
+        std::lock_guard<std::mutex> guard(lock);
+        pending.emplace_back(relation, std::async(std::launch::async, std::move(write)));
+#else
+        // without locks the symbol table cannot be shared with a background thread
+        (void)relation;
+        std::vector<std::future<void>> now;
+        now.push_back(std::async(std::launch::deferred, std::move(write)));
+        finish(now);
+#endif
+    }
+
+    /** Wait for the pending writes of a relation */
+    void wait(const void* relation) {
+        std::vector<std::future<void>> writes;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (auto it = pending.begin(); it != pending.end();) {
+                if (it->first == relation) {
+                    writes.push_back(std::move(it->second));
+                    it = pending.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        finish(writes);
+    }
+
+    /** Wait for all pending writes */
+    void waitAll() {
+        std::vector<std::future<void>> writes;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (auto& cur : pending) {
+                writes.push_back(std::move(cur.second));
+            }
+            pending.clear();
+        }
+        finish(writes);
+    }
+
+private:
+    /** Wait for writes, failing as a synchronous write would */
+    static void finish(std::vector<std::future<void>>& writes) {
+        for (auto& write : writes) {
+            try {
+                write.get();
+            } catch (std::exception& e) {
+                std::cerr << e.what();
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    /** maximal number of pending writes */
+    const std::size_t budget;
+
+    /** pending writes with their relation, oldest first */
+    std::deque<std::pair<const void*, std::future<void>>> pending;
+
+    std::mutex lock;
+};
+
+}  // namespace souffle
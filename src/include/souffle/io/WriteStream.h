@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 
@@ -43,16 +44,22 @@ public:
         if (summary) {
             return writeSize(relation.size());
         }
-        auto lease = symbolTable.acquireLock();
-        (void)lease;  // silence "unused variable" warning
+        // the symbol table is released now and then, so that a relation written in the
+        // background does not stall the evaluation inserting new symbols
+        std::optional<Lock::Lease> lease(symbolTable.acquireLock());
         if (arity == 0) {
             if (relation.begin() != relation.end()) {
                 writeNullary();
             }
             return;
         }
+        size_t count = 0;
         for (const auto& current : relation) {
             writeNext(current);
+            if (++count % 4096 == 0) {
+                lease.reset();
+                lease.emplace(symbolTable.acquireLock());
+            }
         }
     }
 
@@ -0,0 +1,84 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file WriteStreamSpill.h
+ *
+ * Writes the raw tuples of a relation spilled to disk
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/io/WriteStream.h"
+#include "souffle/utility/MiscUtil.h"
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace souffle {
+
+/**
+ * Writes the tuples of a relation, including their auxiliary columns, as raw values
+ * to a binary file. Symbols and records are kept as their indexes into the tables of
+ * the running program, so that the file can only be read back by the same program run.
+ * Nullary relations are never spilled.
+ */
+class WriteFileSpill : public WriteStream {
+public:
+    WriteFileSpill(const std::map<std::string, std::string>& rwOperation, const SymbolTable& symbolTable,
+            const RecordTable& recordTable)
+            : WriteStream(rwOperation, symbolTable, recordTable), fileName(rwOperation.at("filename")),
+              file(fileName, std::ios::out | std::ios::binary | std::ios::trunc) {
+        if (!file) {
+            throw std::invalid_argument("Cannot open spill file " + fileName);
+        }
+    }
+
+    ~WriteFileSpill() override = default;
+
+protected:
+    void writeNullary() override {
+        fatal("attempting to spill a nullary relation");
+    }
+
+    void writeNextTuple(const RamDomain* tuple) override {
+        file.write(reinterpret_cast<const char*>(tuple), (arity + auxiliaryArity) * sizeof(RamDomain));
+        check();
+    }
+
+    void check() {
+        if (!file) {
+            throw std::runtime_error("Cannot write spill file " + fileName);
+        }
+    }
+
+    const std::string fileName;
+    std::ofstream file;
+};
+
+class WriteFileSpillFactory : public WriteStreamFactory {
+public:
+    Own<WriteStream> getWriter(const std::map<std::string, std::string>& rwOperation,
+            const SymbolTable& symbolTable, const RecordTable& recordTable) override {
+        return mk<WriteFileSpill>(rwOperation, symbolTable, recordTable);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "spill";
+        return name;
+    }
+    ~WriteFileSpillFactory() override = default;
+};
+
+} /* namespace souffle */
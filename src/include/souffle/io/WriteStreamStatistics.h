@@ -0,0 +1,121 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file WriteStreamStatistics.h
+ *
+ * Collects column statistics of a relation and records them in the profile
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/datastructure/HyperLogLog.h"
+#include "souffle/io/WriteStream.h"
+#include "souffle/profile/ProfileEvent.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Statistics "writer" of a relation. It estimates the number of distinct values of
+ * each column and of each prefix of the columns, and counts how many tuples share a
+ * prefix (the fan-out of the prefix) in a log2-scaled histogram. The results are
+ * recorded as profile events when the stream is destroyed.
+ */
+class WriteStreamStatistics : public WriteStream {
+public:
+    WriteStreamStatistics(const std::map<std::string, std::string>& rwOperation,
+            const SymbolTable& symbolTable, const RecordTable& recordTable)
+            : WriteStream(rwOperation, symbolTable, recordTable), relationName(rwOperation.at("name")),
+              columns(arity), prefixes(arity), fanOut(arity) {}
+
+    ~WriteStreamStatistics() override {
+        auto& profile = ProfileEventSingleton::instance();
+        const std::string prefix = "@relation-statistics;" + relationName + ";";
+        profile.makeQuantityEvent(prefix + "tuples", tuples, 0);
+        for (size_t i = 0; i < arity; ++i) {
+            profile.makeQuantityEvent(prefix + "column;" + std::to_string(i), round(columns[i]), 0);
+        }
+        for (size_t len = 1; len < arity; ++len) {
+            profile.makeQuantityEvent(prefix + "prefix;" + std::to_string(len), round(prefixes[len]), 0);
+            if (fanOut[len].size() > maxGroups) {
+                continue;
+            }
+            std::map<size_t, size_t> histogram;
+            for (const auto& group : fanOut[len]) {
+                histogram[static_cast<size_t>(std::log2(group.second))]++;
+            }
+            for (const auto& bucket : histogram) {
+                profile.makeQuantityEvent(
+                        prefix + "fanout;" + std::to_string(len) + ";" + std::to_string(bucket.first),
+                        bucket.second, 0);
+            }
+        }
+    }
+
+protected:
+    /** Number of prefixes counted exactly per prefix length; larger histograms are dropped */
+    static constexpr size_t maxGroups = size_t(1) << 16;
+
+    void writeNullary() override {
+        tuples = 1;
+    }
+
+    void writeNextTuple(const RamDomain* tuple) override {
+        ++tuples;
+        uint64_t seed = 0;
+        for (size_t i = 0; i < arity; ++i) {
+            const auto value = static_cast<uint64_t>(static_cast<RamUnsigned>(tuple[i]));
+            columns[i].insert(HyperLogLog<>::hash(value));
+            if (i > 0) {
+                // seed is the hash of the prefix of length i
+                prefixes[i].insert(seed);
+                if (fanOut[i].size() <= maxGroups) {
+                    fanOut[i][seed]++;
+                }
+            }
+            seed = HyperLogLog<>::combine(seed, value);
+        }
+    }
+
+    static size_t round(const HyperLogLog<>& sketch) {
+        return static_cast<size_t>(std::llround(sketch.estimate()));
+    }
+
+    const std::string relationName;
+    size_t tuples = 0;
+    std::vector<HyperLogLog<>> columns;
+    std::vector<HyperLogLog<>> prefixes;
+    std::vector<std::unordered_map<uint64_t, size_t>> fanOut;
+};
+
+class WriteStatisticsFactory : public WriteStreamFactory {
+public:
+    Own<WriteStream> getWriter(const std::map<std::string, std::string>& rwOperation,
+            const SymbolTable& symbolTable, const RecordTable& recordTable) override {
+        return mk<WriteStreamStatistics>(rwOperation, symbolTable, recordTable);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "statistics";
+        return name;
+    }
+    ~WriteStatisticsFactory() override = default;
+};
+
+} /* namespace souffle */
@@ -260,6 +260,38 @@ public:
     }
 } recursiveRuleTimingProcessor;
 
+/**
+ * Recursive Rule Join Order Profile Event Processor
+ *
+ * Records the join order chosen at runtime for an iteration of a recursive rule,
+ * and the runtime of the rule under that order. The order itself is chosen from
+ * the relation sizes, not from these timings.
+ */
+const class RecursiveRuleOrderProcessor : public EventProcessor {
+public:
+    RecursiveRuleOrderProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@t-recursive-rule-order", this);
+    }
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& version = signature[2];
+        const std::string& atomOrder = signature[3];
+        const std::string& rule = signature[5];
+        microseconds start = va_arg(args, microseconds);
+        microseconds end = va_arg(args, microseconds);
+        va_arg(args, size_t);
+        va_arg(args, size_t);
+        va_arg(args, size_t);
+        std::string iteration = std::to_string(va_arg(args, size_t));
+        db.addTextEntry({"program", "relation", relation, "iteration", iteration, "recursive-rule", rule,
+                                version, "join-order"},
+                atomOrder);
+        db.addDurationEntry({"program", "relation", relation, "iteration", iteration, "recursive-rule", rule,
+                                    version, "join-order-runtime"},
+                start, end);
+    }
+} recursiveRuleOrderProcessor;
+
 /**
  * Recursive Rule Number Profile Event Processor
  */
@@ -472,10 +504,14 @@ public:
         uint64_t systemTime = va_arg(args, uint64_t);
         uint64_t userTime = va_arg(args, uint64_t);
         size_t maxRSS = va_arg(args, size_t);
+        size_t hugePages = va_arg(args, size_t);
         std::string timeString = std::to_string(time.count());
         db.addSizeEntry({"program", "usage", "timepoint", timeString, "systemtime"}, systemTime);
         db.addSizeEntry({"program", "usage", "timepoint", timeString, "usertime"}, userTime);
         db.addSizeEntry({"program", "usage", "timepoint", timeString, "maxRSS"}, maxRSS);
+        if (hugePages > 0) {
+            db.addSizeEntry({"program", "usage", "timepoint", timeString, "hugePages"}, hugePages);
+        }
     }
 } programResourceUtilisationProcessor;
 
@@ -535,6 +571,78 @@ public:
 
 } relationReadsProcessor;
 
+/**
+ * Searches Processor
+ */
+const class RelationSearchesProcessor : public EventProcessor {
+public:
+    RelationSearchesProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@relation-searches", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& search = signature[2];
+        size_t searches = va_arg(args, size_t);
+        db.addSizeEntry({"program", "searches", relation, search}, searches);
+    }
+
+} relationSearchesProcessor;
+
+/**
+ * Relation Spill Processor
+ */
+const class RelationSpillProcessor : public EventProcessor {
+public:
+    RelationSpillProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@relation-spill", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& kind = signature[2];
+        size_t bytes = va_arg(args, size_t);
+        db.addSizeEntry({"program", "spill", relation, kind}, bytes);
+    }
+
+} relationSpillProcessor;
+
+/**
+ * Relation Freeze Processor
+ */
+const class RelationFreezeProcessor : public EventProcessor {
+public:
+    RelationFreezeProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@relation-freeze", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& kind = signature[2];
+        size_t bytes = va_arg(args, size_t);
+        db.addSizeEntry({"program", "freeze", relation, kind}, bytes);
+    }
+
+} relationFreezeProcessor;
+
+/**
+ * Relation Statistics Processor
+ */
+const class RelationStatisticsProcessor : public EventProcessor {
+public:
+    RelationStatisticsProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@relation-statistics", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        std::vector<std::string> path{"program", "statistics"};
+        path.insert(path.end(), signature.begin() + 1, signature.end());
+        size_t number = va_arg(args, size_t);
+        db.addSizeEntry(path, number);
+    }
+
+} relationStatisticsProcessor;
+
 /**
  * Config entry processor
  */
@@ -18,6 +18,7 @@
 
 #include "souffle/profile/EventProcessor.h"
 #include "souffle/profile/ProfileDatabase.h"
+#include "souffle/utility/HugePageUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include <atomic>
 #include <chrono>
@@ -120,9 +121,11 @@ public:
         /* Maximum resident set size (kb) */
         size_t maxRSS = ru.ru_maxrss;
 #endif  // WIN32
+        /* Memory resident in huge pages (kb), only read if huge pages are in use */
+        size_t hugePages = HugePages::instance().isEnabled() ? HugePages::getResidentKB() : 0;
 
         profile::EventProcessorSingleton::instance().process(
-                database, txt.c_str(), time, systemTime, userTime, maxRSS);
+                database, txt.c_str(), time, systemTime, userTime, maxRSS, hugePages);
     }
 
     void setOutputFile(std::string outputFilename) {
@@ -74,6 +74,8 @@ private:
         uint64_t maxRSS;
         std::chrono::microseconds systemtime;
         std::chrono::microseconds usertime;
+        /** memory resident in huge pages (kb) */
+        uint64_t hugePages;
         bool operator<(const Usage& other) const {
             return time < other.time;
         }
@@ -208,6 +210,10 @@ public:
             }
         } else if (c[0] == "configuration") {
             configuration();
+        } else if (c[0] == "spill") {
+            spill();
+        } else if (c[0] == "freeze") {
+            freeze();
         } else {
             std::cout << "Unknown command. Use \"help\" for a list of commands.\n";
         }
@@ -702,6 +708,8 @@ public:
         std::printf("  %-30s%-5s %s\n", "usage [relation id|rule id]", "-",
                 "display CPU usage graphs for a relation or rule.");
         std::printf("  %-30s%-5s %s\n", "memory", "-", "display memory usage.");
+        std::printf("  %-30s%-5s %s\n", "spill", "-", "display memory saved by compressed spills.");
+        std::printf("  %-30s%-5s %s\n", "freeze", "-", "display memory saved by frozen relations.");
         std::printf("  %-30s%-5s %s\n", "help", "-", "print this.");
 
         std::cout << "\nInteractive mode only commands:" << std::endl;
@@ -788,6 +796,11 @@ public:
             currentUsage.usertime = std::chrono::duration<uint64_t, std::micro>(cur);
             currentUsage.maxRSS =
                     as<SizeEntry>(usageStats->readDirectoryEntry(currentKey)->readEntry("maxRSS"))->getSize();
+            // only recorded while huge pages are in use
+            if (auto* hugePages = as<SizeEntry>(
+                        usageStats->readDirectoryEntry(currentKey)->readEntry("hugePages"))) {
+                currentUsage.hugePages = hugePages->getSize();
+            }
 
             // Duplicate times are possible
             if (allUsages.find(currentUsage) != allUsages.end()) {
@@ -795,6 +808,7 @@ public:
                 currentUsage.systemtime = std::max(existing.systemtime, currentUsage.systemtime);
                 currentUsage.usertime = std::max(existing.usertime, currentUsage.usertime);
                 currentUsage.maxRSS = std::max(existing.maxRSS, currentUsage.maxRSS);
+                currentUsage.hugePages = std::max(existing.hugePages, currentUsage.hugePages);
                 allUsages.erase(currentUsage);
             }
             allUsages.insert(currentUsage);
@@ -823,7 +837,7 @@ public:
 
         // Store the timepoints we need for the graph
         for (uint32_t i = 1; i <= width; ++i) {
-            auto it = allUsages.upper_bound(Usage{startTime + timeStep * i, 0, {}, {}});
+            auto it = allUsages.upper_bound(Usage{startTime + timeStep * i, 0, {}, {}, 0});
             if (it != allUsages.begin()) {
                 --it;
             }
@@ -865,7 +879,7 @@ public:
         }
 
         // Find maximum so we can normalise the graph
-        Usage previousUsage{{}, 0, {}, {}};
+        Usage previousUsage{{}, 0, {}, {}, 0};
         for (auto& currentUsage : usages) {
             double usageDiff = (currentUsage.systemtime - previousUsage.systemtime + currentUsage.usertime -
                                 previousUsage.usertime)
@@ -890,7 +904,7 @@ public:
             }
         }
 
-        previousUsage = {{}, 0, {}, {}};
+        previousUsage = {{}, 0, {}, {}, 0};
         uint32_t col = 0;
         for (const Usage& currentUsage : usages) {
             uint64_t curHeight = 0;
@@ -942,6 +956,7 @@ public:
             uint32_t height = 20) {
         uint32_t width = getTermWidth() - 8;
         uint64_t maxMaxRSS = 0;
+        uint64_t maxHugePages = 0;
 
         std::set<Usage> usages = getUsageStats(width);
         char grid[height][width];
@@ -953,12 +968,15 @@ public:
 
         for (auto& usage : usages) {
             maxMaxRSS = std::max(maxMaxRSS, usage.maxRSS);
+            maxHugePages = std::max(maxHugePages, usage.hugePages);
         }
         size_t col = 0;
         for (const Usage& currentUsage : usages) {
             uint64_t curHeight = height * currentUsage.maxRSS / maxMaxRSS;
+            // the part resident in huge pages is drawn at the bottom
+            uint64_t hugeHeight = std::min(curHeight, height * currentUsage.hugePages / maxMaxRSS);
             for (uint32_t row = 0; row < curHeight; ++row) {
-                grid[row][col] = '*';
+                grid[row][col] = row < hugeHeight ? 'H' : '*';
             }
             ++col;
         }
@@ -978,6 +996,9 @@ public:
             std::cout << '-';
         }
         std::cout << std::endl;
+        if (maxHugePages > 0) {
+            printf("H: resident in huge pages, at most %s\n", Tools::formatMemory(maxHugePages).c_str());
+        }
     }
     void setupTabCompletion() {
         linereader.clearTabCompletion();
@@ -992,6 +1013,8 @@ public:
         linereader.appendTabCompletion("limit ");
         linereader.appendTabCompletion("memory");
         linereader.appendTabCompletion("configuration");
+        linereader.appendTabCompletion("spill");
+        linereader.appendTabCompletion("freeze");
 
         // add rel tab completes after the rest so users can see all commands first
         for (auto& row : Tools::formatTable(relationTable, precision)) {
@@ -1017,6 +1040,39 @@ public:
         std::cout << std::endl;
     }
 
+    void spill() {
+        compression("spill", "compressed", "No relations were spilled compressed.");
+    }
+
+    void freeze() {
+        compression("freeze", "frozen", "No relations were frozen.");
+    }
+
+    /** Print the memory of each relation before and after its compression of the given kind */
+    void compression(const std::string& kind, const std::string& compressedKey, const std::string& none) {
+        auto* entry =
+                as<DirectoryEntry>(ProfileEventSingleton::instance().getDB().lookupEntry({"program", kind}));
+        if (entry == nullptr) {
+            std::cout << none << "\n";
+            return;
+        }
+        std::printf("%30s %12s %12s %8s\n\n", "Relation", "Raw", "Compressed", "Saved");
+        for (const auto& relation : entry->getKeys()) {
+            auto* sizes = entry->readDirectoryEntry(relation);
+            auto* raw = as<SizeEntry>(sizes->readEntry("raw"));
+            auto* compressed = as<SizeEntry>(sizes->readEntry(compressedKey));
+            if (raw == nullptr || compressed == nullptr) {
+                continue;
+            }
+            const double rawSize = raw->getSize();
+            double saved = rawSize == 0 ? 0 : 100.0 - 100.0 * compressed->getSize() / rawSize;
+            std::printf("%30s %12s %12s %7.1f%%\n", relation.c_str(),
+                    Tools::formatMemory(raw->getSize() / 1024).c_str(),
+                    Tools::formatMemory(compressed->getSize() / 1024).c_str(), saved);
+        }
+        std::cout << std::endl;
+    }
+
     void top() {
         const std::shared_ptr<ProgramRun>& run = out.getProgramRun();
         auto* totalRelationsEntry = as<TextEntry>(ProfileEventSingleton::instance().getDB().lookupEntry(
@@ -19,6 +19,9 @@
 #include "souffle/provenance/ExplainProvenance.h"
 #include "souffle/provenance/ExplainProvenanceImpl.h"
 #include "souffle/provenance/ExplainTree.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/ParallelUtil.h"
+#include "souffle/utility/StringUtil.h"
 #include <algorithm>
 #include <csignal>
 #include <cstdio>
@@ -291,6 +294,7 @@ private:
     /* Print an error, such as a wrong command */
     virtual void printError(const std::string& error) = 0;
 
+protected:
     /**
      * Parse tuple, split into relation name and values
      * @param str The string to parse, should be something like "R(x1, x2, x3, ...)"
@@ -377,6 +381,121 @@ private:
     }
 };
 
+/**
+ * Non-interactive explain interface: reads a file of commands, computes the proof trees of
+ * all queries in parallel with a shared subproof cache, and prints them as JSON.
+ *
+ * Each line of the file is one of:
+ *   explain relation_name(<element1>, <element2>, ...)
+ *   setdepth <depth>
+ *   setsize <number of derivations>
+ * The depth and size limits apply to the queries that follow them.
+ */
+class ExplainBatch : public Explain {
+public:
+    ExplainBatch(ExplainProvenanceImpl& provenance, std::string queryFile)
+            : Explain(provenance), impl(provenance), queryFile(std::move(queryFile)) {}
+
+    /* The main explain call */
+    void explain() override {
+        std::ifstream input(queryFile);
+        if (!input) {
+            fatal("cannot open query file %s", queryFile);
+        }
+
+        // collect the queries with the limits that apply to them
+        size_t depthLimit = ExplainConfig::getExplainConfig().depthLimit;
+        size_t sizeLimit = 0;
+        std::vector<Query> queries;
+        size_t lineNumber = 0;
+        for (std::string line; getline(input, line);) {
+            ++lineNumber;
+            std::vector<std::string> command = split(line, ' ', 1);
+            if (command.empty() || command[0].empty() || command[0][0] == '#') {
+                continue;
+            }
+            try {
+                if (command.size() == 2 && command[0] == "explain") {
+                    queries.push_back({command[1], parseTuple(command[1]), depthLimit, sizeLimit});
+                } else if (command.size() == 2 && command[0] == "setdepth") {
+                    depthLimit = std::stoi(command[1]);
+                } else if (command.size() == 2 && command[0] == "setsize") {
+                    sizeLimit = std::stoi(command[1]);
+                } else {
+                    printError(tfm::format("%s:%d: unknown command <%s>\n", queryFile, lineNumber, line));
+                }
+            } catch (std::exception& e) {
+                printError(tfm::format("%s:%d: <%s> is not a valid limit\n", queryFile, lineNumber, line));
+            }
+        }
+
+        // compute the proof trees in parallel
+        const size_t numQueries = queries.size();
+        std::vector<Own<TreeNode>> proofs(numQueries);
+        PARALLEL_START
+        pfor(size_t i = 0; i < numQueries; i++) {
+            const Query& query = queries[i];
+            const size_t limit = query.sizeLimit == 0 ? std::numeric_limits<size_t>::max() : query.sizeLimit;
+            proofs[i] = impl.explain(query.tuple.first, query.tuple.second, query.depthLimit, limit);
+        }
+        PARALLEL_END
+
+        // print the proof trees in the order of the queries
+        std::ostream& output = getOutput();
+        output << "{ \"proofs\": [\n";
+        for (size_t i = 0; i < numQueries; i++) {
+            output << "{ \"query\": \"" << stringify(queries[i].text) << "\", \"proof\":\n";
+            proofs[i]->printJSON(output, 1);
+            output << (i + 1 < numQueries ? "},\n" : "}\n");
+        }
+        output << "],\n";
+        prov.printRulesJSON(output);
+        output << "}\n";
+    }
+
+private:
+    /** A query with the limits of its proof tree */
+    struct Query {
+        std::string text;
+        std::pair<std::string, std::vector<std::string>> tuple;
+        size_t depthLimit;
+        size_t sizeLimit;
+    };
+
+    ExplainProvenanceImpl& impl;
+    std::string queryFile;
+
+    std::ostream& getOutput() {
+        if (ExplainConfig::getExplainConfig().outputStream == nullptr) {
+            return std::cout;
+        }
+        return *ExplainConfig::getExplainConfig().outputStream;
+    }
+
+    /* Get input, unused as the queries are read from the query file */
+    std::string getInput() override {
+        return "q";
+    }
+
+    /* Print a command prompt, disabled for batch queries */
+    void printPrompt(const std::string&) override {}
+
+    /* Print a tree */
+    void printTree(Own<TreeNode> tree) override {
+        if (tree) {
+            tree->printJSON(getOutput(), 1);
+        }
+    }
+
+    /* Print any other information, disabled for batch queries */
+    void printInfo(const std::string&) override {}
+
+    /* Print an error, such as a wrong command */
+    void printError(const std::string& error) override {
+        std::cerr << error;
+    }
+};
+
 class ExplainConsole : public Explain {
 public:
     explicit ExplainConsole(ExplainProvenance& provenance) : Explain(provenance) {}
@@ -640,6 +759,13 @@ inline void explain(SouffleProgram& prog, bool ncurses) {
     }
 }
 
+/** Answer the explain queries of a query file, see ExplainBatch */
+inline void explainBatch(SouffleProgram& prog, const std::string& queryFile) {
+    ExplainProvenanceImpl prov(prog);
+    ExplainBatch exp(prov, queryFile);
+    exp.explain();
+}
+
 // this is necessary because ncurses.h defines TRUE and FALSE macros, and they otherwise clash with our parser
 #ifdef USE_NCURSES
 #undef TRUE
@@ -32,7 +32,9 @@
 #include <cstdio>
 #include <iostream>
 #include <map>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <regex>
 #include <sstream>
 #include <string>
@@ -91,6 +93,16 @@ public:
 
     Own<TreeNode> explain(
             std::string relName, std::vector<RamDomain> tuple, int ruleNum, int levelNum, size_t depthLimit) {
+        size_t sizeLimit = std::numeric_limits<size_t>::max();
+        return explain(std::move(relName), std::move(tuple), ruleNum, levelNum, depthLimit, sizeLimit);
+    }
+
+    /**
+     * Explain a tuple, expanding at most sizeLimit derivations; the derivations beyond the
+     * depth or size limit are shown as subproofs. The remaining size is updated.
+     */
+    Own<TreeNode> explain(std::string relName, std::vector<RamDomain> tuple, int ruleNum, int levelNum,
+            size_t depthLimit, size_t& sizeLimit) {
         std::stringstream joinedArgs;
         joinedArgs << join(decodeArguments(relName, tuple), ", ");
         auto joinedArgsStr = joinedArgs.str();
@@ -102,34 +114,31 @@ public:
 
         assert(contains(info, std::make_pair(relName, ruleNum)) && "invalid rule for tuple");
 
-        // if depth limit exceeded
-        if (depthLimit <= 1) {
+        // if depth or size limit exceeded
+        if (depthLimit <= 1 || sizeLimit == 0) {
             tuple.push_back(ruleNum);
             tuple.push_back(levelNum);
 
             // find if subproof exists already
-            size_t idx = 0;
-            auto it = std::find(subproofs.begin(), subproofs.end(), tuple);
-            if (it != subproofs.end()) {
-                idx = it - subproofs.begin();
-            } else {
+            std::lock_guard<std::mutex> guard(cacheLock);
+            auto it = subproofIndex.find(tuple);
+            if (it == subproofIndex.end()) {
+                it = subproofIndex.insert({tuple, subproofs.size()}).first;
                 subproofs.push_back(tuple);
-                idx = subproofs.size() - 1;
             }
+            size_t idx = it->second;
 
             return mk<LeafNode>("subproof " + relName + "(" + std::to_string(idx) + ")");
         }
 
         tuple.push_back(levelNum);
+        --sizeLimit;
 
         auto internalNode =
                 mk<InnerNode>(relName + "(" + joinedArgsStr + ")", "(R" + std::to_string(ruleNum) + ")");
 
-        // make return vector pointer
-        std::vector<RamDomain> ret;
-
-        // execute subroutine to get subproofs
-        prog.executeSubroutine(relName + "_" + std::to_string(ruleNum) + "_subproof", tuple, ret);
+        // get subproofs, executing the subroutine only on the first request
+        const std::vector<RamDomain>& ret = getSubproof(relName, ruleNum, tuple);
 
         // recursively get nodes for subproofs
         size_t tupleCurInd = 0;
@@ -202,7 +211,8 @@ public:
                 // otherwise, for a normal tuple, recurse
             } else {
                 auto child =
-                        explain(bodyRel, subproofTuple, subproofRuleNum, subproofLevelNum, depthLimit - 1);
+                        explain(bodyRel, subproofTuple, subproofRuleNum, subproofLevelNum, depthLimit - 1,
+                                sizeLimit);
                 internalNode->setSize(internalNode->getSize() + child->getSize());
                 internalNode->add_child(std::move(child));
             }
@@ -214,6 +224,15 @@ public:
     }
 
     Own<TreeNode> explain(std::string relName, std::vector<std::string> args, size_t depthLimit) override {
+        return explain(std::move(relName), std::move(args), depthLimit, std::numeric_limits<size_t>::max());
+    }
+
+    /**
+     * Explain a tuple, expanding at most sizeLimit derivations.
+     * May be called concurrently, the caches are shared between the calls.
+     */
+    Own<TreeNode> explain(
+            std::string relName, const std::vector<std::string>& args, size_t depthLimit, size_t sizeLimit) {
         auto tuple = argsToNums(relName, args);
         if (tuple.empty()) {
             return mk<LeafNode>("Relation not found");
@@ -228,7 +247,7 @@ public:
             return mk<LeafNode>("Tuple not found");
         }
 
-        return explain(relName, tuple, ruleNum, levelNum, depthLimit);
+        return explain(relName, tuple, ruleNum, levelNum, depthLimit, sizeLimit);
     }
 
     Own<TreeNode> explainSubproof(std::string relName, RamDomain subproofNum, size_t depthLimit) override {
@@ -734,9 +753,37 @@ private:
     std::map<std::pair<std::string, size_t>, std::vector<std::string>> info;
     std::map<std::pair<std::string, size_t>, std::string> rules;
     std::vector<std::vector<RamDomain>> subproofs;
+    std::map<std::vector<RamDomain>, size_t> subproofIndex;
+
+    /** results of the subproof subroutines, kept across explain queries */
+    std::map<std::pair<std::string, std::vector<RamDomain>>, std::vector<RamDomain>> subproofCache;
+
+    /** lock on the subproofs and caches, for concurrent explain queries */
+    std::mutex cacheLock;
     std::vector<std::string> constraintList = {
             "=", "!=", "<", "<=", ">=", ">", "match", "contains", "not_match", "not_contains"};
 
+    /**
+     * Get the body tuples of the derivation of a tuple by the given rule.
+     * The subroutine computing them is executed on the first request only.
+     */
+    const std::vector<RamDomain>& getSubproof(
+            const std::string& relName, int ruleNum, const std::vector<RamDomain>& tuple) {
+        auto key = std::make_pair(relName + "_" + std::to_string(ruleNum) + "_subproof", tuple);
+        {
+            std::lock_guard<std::mutex> guard(cacheLock);
+            auto found = subproofCache.find(key);
+            if (found != subproofCache.end()) {
+                return found->second;
+            }
+        }
+        // the subroutine is executed without holding the lock, so that proofs are searched in parallel
+        std::vector<RamDomain> ret;
+        prog.executeSubroutine(key.first, tuple, ret);
+        std::lock_guard<std::mutex> guard(cacheLock);
+        return subproofCache.insert({std::move(key), std::move(ret)}).first->second;
+    }
+
     std::tuple<int, int> findTuple(const std::string& relName, std::vector<RamDomain> tup) {
         auto rel = prog.getRelation(relName);
 
@@ -744,46 +791,11 @@ private:
             return std::make_tuple(-1, -1);
         }
 
-        // find correct tuple
-        for (auto& tuple : *rel) {
-            bool match = true;
-            std::vector<RamDomain> currentTuple;
-
-            for (arity_type i = 0; i < rel->getPrimaryArity(); i++) {
-                RamDomain n;
-                if (*rel->getAttrType(i) == 's') {
-                    std::string s;
-                    tuple >> s;
-                    n = symTable.lookupExisting(s);
-                } else if (*rel->getAttrType(i) == 'f') {
-                    RamFloat element;
-                    tuple >> element;
-                    n = ramBitCast(element);
-                } else if (*rel->getAttrType(i) == 'u') {
-                    RamUnsigned element;
-                    tuple >> element;
-                    n = ramBitCast(element);
-                } else {
-                    tuple >> n;
-                }
-
-                currentTuple.push_back(n);
-
-                if (n != tup[i]) {
-                    match = false;
-                    break;
-                }
-            }
-
-            if (match) {
-                RamDomain ruleNum;
-                tuple >> ruleNum;
-
-                RamDomain levelNum;
-                tuple >> levelNum;
-
-                return std::make_tuple(ruleNum, levelNum);
-            }
+        // look up the provenance annotations (rule number, level number) through the index of the relation
+        tup.resize(rel->getPrimaryArity());
+        RamDomain annotations[2];
+        if (rel->getAuxiliaryArity() == 2 && rel->findAuxiliary(tup.data(), annotations)) {
+            return std::make_tuple(annotations[0], annotations[1]);
         }
 
         // if no tuple exists
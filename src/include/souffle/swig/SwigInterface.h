@@ -19,6 +19,7 @@
 #include "souffle/SouffleInterface.h"
 #include <iostream>
 #include <string>
+#include <utility>
 
 /**
  * Abstract base class for generated Datalog programs
@@ -79,6 +80,24 @@ public:
     }
 };
 
+/**
+ * Base database shared by queries, see souffle::BaseDatabase in SouffleInterface.h
+ */
+class SWIGBaseDatabase {
+    souffle::BaseDatabase base;
+
+public:
+    SWIGBaseDatabase(souffle::BaseDatabase base) : base(std::move(base)) {}
+
+    /**
+     * Creates an instance of the program layered over the evaluated base instance; the facts of the query
+     * can be added with loadAll before running it
+     */
+    SWIGSouffleProgram* newQuery() {
+        return new SWIGSouffleProgram(base.newQuery().release());
+    }
+};
+
 /**
  * Creates an instance of a SWIG souffle::SouffleProgram that can be called within a program of a supported
  * language for the SWIG option specified in main.cpp. This enables the program to use this instance and call
@@ -89,3 +108,26 @@ SWIGSouffleProgram* newInstance(const std::string& name) {
     auto* prog = souffle::ProgramFactory::newInstance(name);
     return new SWIGSouffleProgram(prog);
 }
+
+/**
+ * Creates a base database by evaluating a program on the facts of the given directory, which is shared by
+ * the queries created from it.
+ * @param name Name of the datalog file/ instance to be created
+ * @param inputDirectory Directory of the base facts
+ * @return The base database, or null if the program is not found, has relations holding records or input
+ * relations that are not monotone, see souffle::BaseDatabase
+ */
+SWIGBaseDatabase* newBaseDatabase(const std::string& name, const std::string& inputDirectory) {
+    souffle::Own<souffle::SouffleProgram> prog(souffle::ProgramFactory::newInstance(name));
+    if (prog == nullptr) {
+        std::cerr << "error: program " << name << " not found" << std::endl;
+        return nullptr;
+    }
+    prog->loadAll(inputDirectory);
+    auto base = souffle::BaseDatabase::evaluate(name, std::move(prog));
+    if (base == nullptr) {
+        std::cerr << "error: relations of program " << name << " hold records" << std::endl;
+        return nullptr;
+    }
+    return new SWIGBaseDatabase(*base);
+}
@@ -35,6 +35,9 @@ souffle::Relation* rel;
 souffle::Relation* rel_out;
 %}
 
+%newobject SWIGBaseDatabase::newQuery;
 %include "SwigInterface.h" 
 %newobject newInstance;
 SWIGSouffleProgram* newInstance(const std::string& name);
+%newobject newBaseDatabase;
+SWIGBaseDatabase* newBaseDatabase(const std::string& name, const std::string& inputDirectory);
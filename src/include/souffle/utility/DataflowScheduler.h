@@ -0,0 +1,136 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file DataflowScheduler.h
+ *
+ * Executes steps as soon as the steps they depend on have finished
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Scheduler of steps with dependencies, where a step only depends on earlier steps.
+ * A step starts as soon as all steps it depends on have finished, and at most
+ * `concurrencyLimit` steps execute at the same time; among the steps that are ready,
+ * earlier steps start first. Once a step fails, no further steps are started.
+ *
+ * Sequential builds execute the steps in their order.
+ */
+class DataflowScheduler {
+public:
+    DataflowScheduler(std::vector<std::vector<std::size_t>> predecessors, std::size_t concurrencyLimit)
+            : predecessors(std::move(predecessors)),
+              concurrencyLimit(std::max<std::size_t>(concurrencyLimit, 1)) {}
+
+    /** Execute all steps; returns false if a step failed */
+    bool run(const std::function<bool(std::size_t)>& step) const {
+        const std::size_t numSteps = predecessors.size();
+#ifdef IS_PARALLEL
+        std::vector<std::size_t> waiting(numSteps);
+        std::vector<std::vector<std::size_t>> successors(numSteps);
+        std::set<std::size_t> ready;
+        for (std::size_t i = 0; i < numSteps; i++) {
+            for (std::size_t pred : predecessors[i]) {
+                assert(pred < i && "a step may only depend on earlier steps");
+                successors[pred].push_back(i);
+            }
+            waiting[i] = predecessors[i].size();
+            if (waiting[i] == 0) {
+                ready.insert(i);
+            }
+        }
+
+        std::mutex lock;
+        std::condition_variable changed;
+        std::size_t finished = 0;
+        std::size_t running = 0;
+        bool success = true;
+
+#ifdef _OPENMP
+        // the parallel regions of a step use as many threads as those of the caller
+        const int numThreads = omp_get_max_threads();
+#endif
+
+        auto worker = [&]() {
+#ifdef _OPENMP
+            omp_set_num_threads(numThreads);
+#endif
+            std::unique_lock<std::mutex> guard(lock);
+            for (;;) {
+                changed.wait(guard, [&]() {
+                    return !ready.empty() || finished == numSteps || (!success && running == 0);
+                });
+                if (ready.empty()) {
+                    return;
+                }
+                const std::size_t cur = *ready.begin();
+                ready.erase(ready.begin());
+                ++running;
+                guard.unlock();
+                const bool result = step(cur);
+                guard.lock();
+                --running;
+                ++finished;
+                if (!result) {
+                    success = false;
+                    ready.clear();
+                } else if (success) {
+                    for (std::size_t succ : successors[cur]) {
+                        if (--waiting[succ] == 0) {
+                            ready.insert(succ);
+                        }
+                    }
+                }
+                changed.notify_all();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < std::min(concurrencyLimit, numSteps); i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& cur : workers) {
+            cur.join();
+        }
+        return success;
+#else
+        for (std::size_t i = 0; i < numSteps; i++) {
+            if (!step(i)) {
+                return false;
+            }
+        }
+        return true;
+#endif
+    }
+
+private:
+    /** steps that have to finish before each step */
+    const std::vector<std::vector<std::size_t>> predecessors;
+
+    /** maximal number of concurrently executing steps */
+    const std::size_t concurrencyLimit;
+};
+
+}  // namespace souffle
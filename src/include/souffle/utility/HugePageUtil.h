@@ -0,0 +1,187 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file HugePageUtil.h
+ *
+ * Allocation of large memory blocks backed by huge pages
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace souffle {
+
+/**
+ * Maps blocks of memory in multiples of the huge page size (2 MiB).
+ *
+ * If huge pages are enabled, a block is taken from the reserved huge pages of the
+ * system (MAP_HUGETLB) when there are any left, and otherwise mapped aligned to
+ * huge pages and marked for transparent huge pages (MADV_HUGEPAGE). Without huge
+ * pages, or on systems lacking them, blocks are mapped with normal pages.
+ */
+class HugePages {
+public:
+    /** The size of a huge page */
+    static constexpr std::size_t pageSize = std::size_t(1) << 21;
+
+    static HugePages& instance() {
+        static HugePages singleton;
+        return singleton;
+    }
+
+    void setEnabled(bool enable) {
+        enabled = enable;
+    }
+
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    /** Round a size up to a multiple of the huge page size */
+    static std::size_t roundUp(std::size_t size) {
+        return (size + pageSize - 1) & ~(pageSize - 1);
+    }
+
+    /** Map a block of the given size, a multiple of the huge page size */
+    void* map(std::size_t size) const {
+#ifdef __linux__
+#ifdef MAP_HUGETLB
+        if (enabled) {
+            void* block = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (block != MAP_FAILED) {
+                return block;
+            }
+        }
+#endif
+        if (!enabled) {
+            void* block = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (block == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return block;
+        }
+        // over-allocate and trim to an aligned block, so that it consists of whole huge pages
+        void* mapping =
+                mmap(nullptr, size + pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const auto start = reinterpret_cast<std::uintptr_t>(mapping);
+        const auto aligned = (start + pageSize - 1) & ~std::uintptr_t(pageSize - 1);
+        if (aligned != start) {
+            munmap(mapping, aligned - start);
+        }
+        if (aligned + size != start + size + pageSize) {
+            munmap(reinterpret_cast<void*>(aligned + size), start + pageSize - aligned);
+        }
+        void* block = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        madvise(block, size, MADV_HUGEPAGE);
+#endif
+        return block;
+#else
+        void* block = std::malloc(size);
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        return block;
+#endif
+    }
+
+    /** Unmap a block obtained from map() */
+    void unmap(void* block, std::size_t size) const {
+#ifdef __linux__
+        munmap(block, size);
+#else
+        (void)size;
+        std::free(block);
+#endif
+    }
+
+    /** The number of kilobytes of the process resident in huge pages, transparent or reserved */
+    static std::size_t getResidentKB() {
+        std::size_t total = 0;
+#ifdef __linux__
+        // lines such as "AnonHugePages:     4096 kB", following a header line
+        std::ifstream file("/proc/self/smaps_rollup");
+        std::string line;
+        while (std::getline(file, line)) {
+            for (const char* key : {"AnonHugePages:", "Shared_Hugetlb:", "Private_Hugetlb:"}) {
+                if (line.compare(0, std::strlen(key), key) == 0) {
+                    total += std::strtoull(line.c_str() + std::strlen(key), nullptr, 10);
+                }
+            }
+        }
+#endif
+        return total;
+    }
+
+private:
+    HugePages() = default;
+
+    bool enabled = false;
+};
+
+/**
+ * An allocator for containers with large arrays, such as the buckets of hash maps.
+ * Arrays of at least a huge page are mapped by HugePages, smaller ones are allocated
+ * on the heap.
+ */
+template <typename T>
+struct HugePageAllocator {
+    using value_type = T;
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        const std::size_t size = n * sizeof(T);
+        if (size < HugePages::pageSize) {
+            return static_cast<T*>(::operator new(size));
+        }
+        return static_cast<T*>(HugePages::instance().map(HugePages::roundUp(size)));
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        const std::size_t size = n * sizeof(T);
+        if (size < HugePages::pageSize) {
+            ::operator delete(p);
+        } else {
+            HugePages::instance().unmap(p, HugePages::roundUp(size));
+        }
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const {
+        return false;
+    }
+};
+
+}  // namespace souffle
@@ -187,6 +187,147 @@ auto transformIter(Iter&& iter, F&& f) {
             std::forward<Iter>(iter), std::forward<F>(f));
 }
 
+/**
+ * An iterator visiting a range of a first container followed by a range of a second
+ * container of the same type, e.g. the tuples of a relation layered over a base relation.
+ *
+ * @tparam Iter ... the type of the iterators of both ranges
+ */
+template <typename Iter>
+class ChainIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::iterator_traits<Iter>::value_type;
+    using difference_type = typename std::iterator_traits<Iter>::difference_type;
+    using pointer = typename std::iterator_traits<Iter>::pointer;
+    using reference = decltype(*std::declval<const Iter&>());
+
+    ChainIterator() = default;
+
+    /* An iterator positioned in the second range only */
+    explicit ChainIterator(Iter second) : cur(std::move(second)) {}
+
+    /* An iterator visiting [first, firstEnd) and then the second range starting at second */
+    ChainIterator(Iter first, Iter firstEnd, Iter second)
+            : cur(std::move(first)), firstEnd(std::move(firstEnd)), second(std::move(second)), inFirst(true) {
+        skip();
+    }
+
+    /* The equality operator as required by the iterator concept. */
+    bool operator==(const ChainIterator& other) const {
+        return inFirst == other.inFirst && cur == other.cur;
+    }
+
+    /* The not-equality operator as required by the iterator concept. */
+    bool operator!=(const ChainIterator& other) const {
+        return !(*this == other);
+    }
+
+    /* The deref operator as required by the iterator concept. */
+    reference operator*() const {
+        return *cur;
+    }
+
+    /* Support for the pointer operator. */
+    auto operator->() const {
+        return &**this;
+    }
+
+    /* The increment operator as required by the iterator concept. */
+    ChainIterator& operator++() {
+        ++cur;
+        skip();
+        return *this;
+    }
+
+    ChainIterator operator++(int) {
+        auto res = *this;
+        ++(*this);
+        return res;
+    }
+
+private:
+    /* Move on to the second range at the end of the first range */
+    void skip() {
+        if (inFirst && cur == firstEnd) {
+            cur = second;
+            inFirst = false;
+        }
+    }
+
+    Iter cur;
+    Iter firstEnd;
+    Iter second;
+    bool inFirst = false;
+};
+
+/**
+ * An iterator over a range of either of two containers of the same values, e.g. the
+ * tuples of a relation held in b-trees or, once the relation is frozen, in compressed
+ * indexes.
+ *
+ * @tparam Live ... the type of the iterators of the first container
+ * @tparam Frozen ... the type of the iterators of the second container
+ */
+template <typename Live, typename Frozen>
+class FreezableIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::iterator_traits<Live>::value_type;
+    using difference_type = typename std::iterator_traits<Live>::difference_type;
+    using pointer = typename std::iterator_traits<Live>::pointer;
+    using reference = decltype(*std::declval<const Live&>());
+
+    FreezableIterator() = default;
+
+    /* An iterator of the first container */
+    FreezableIterator(Live live) : live(std::move(live)) {}
+
+    /* An iterator of the second container */
+    FreezableIterator(Frozen frozen) : frozen(std::move(frozen)), isFrozen(true) {}
+
+    /* The equality operator as required by the iterator concept. */
+    bool operator==(const FreezableIterator& other) const {
+        return isFrozen == other.isFrozen && (isFrozen ? frozen == other.frozen : live == other.live);
+    }
+
+    /* The not-equality operator as required by the iterator concept. */
+    bool operator!=(const FreezableIterator& other) const {
+        return !(*this == other);
+    }
+
+    /* The deref operator as required by the iterator concept. */
+    reference operator*() const {
+        return isFrozen ? *frozen : *live;
+    }
+
+    /* Support for the pointer operator. */
+    auto operator->() const {
+        return &**this;
+    }
+
+    /* The increment operator as required by the iterator concept. */
+    FreezableIterator& operator++() {
+        if (isFrozen) {
+            ++frozen;
+        } else {
+            ++live;
+        }
+        return *this;
+    }
+
+    FreezableIterator operator++(int) {
+        auto res = *this;
+        ++(*this);
+        return res;
+    }
+
+private:
+    Live live;
+    Frozen frozen;
+    bool isFrozen = false;
+};
+
 /**
  * A wrapper for an iterator obtaining pointers of a certain type,
  * dereferencing values before forwarding them to the consumer.
@@ -0,0 +1,311 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file NumaUtil.h
+ *
+ * Placement of threads and relation memory on the nodes of NUMA systems
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace souffle {
+
+/**
+ * The placement of threads and relation nodes.
+ *
+ * With INTERLEAVE, the pages of relation nodes are spread over all NUMA nodes. With
+ * PARTITION, the pages of relation nodes are placed on the node of the thread creating
+ * them. In both modes, the OpenMP threads are pinned to the nodes in contiguous blocks,
+ * and parallel scans hand out the chunks of a relation to threads on the node holding
+ * them first.
+ */
+enum class NumaMode { NONE, INTERLEAVE, PARTITION };
+
+/**
+ * The NUMA topology of the machine, and the placement following the selected mode.
+ *
+ * Uses the mbind and get_mempolicy system calls and the node topology of sysfs, so no
+ * library is needed. On other systems, or machines with a single node, all operations
+ * do nothing.
+ */
+class Numa {
+public:
+    static Numa& instance() {
+        static Numa singleton;
+        return singleton;
+    }
+
+    /** Select the mode; it only takes effect on machines with several nodes */
+    void setMode(NumaMode newMode) {
+        mode = nodes.size() > 1 ? newMode : NumaMode::NONE;
+    }
+
+    /** Select the mode by its name (none, interleave or partition) */
+    void setMode(const std::string& name) {
+        if (name == "interleave") {
+            setMode(NumaMode::INTERLEAVE);
+        } else if (name == "partition") {
+            setMode(NumaMode::PARTITION);
+        } else {
+            setMode(NumaMode::NONE);
+        }
+    }
+
+    NumaMode getMode() const {
+        return mode;
+    }
+
+    bool isEnabled() const {
+        return mode != NumaMode::NONE;
+    }
+
+    /** The name of the mode in effect */
+    std::string getModeName() const {
+        switch (mode) {
+            case NumaMode::INTERLEAVE: return "interleave";
+            case NumaMode::PARTITION: return "partition";
+            default: return "none";
+        }
+    }
+
+    /** The number of NUMA nodes, at least one */
+    std::size_t getNumNodes() const {
+        return std::max<std::size_t>(1, nodes.size());
+    }
+
+    /** The node of the CPU running the calling thread */
+    std::size_t getCurrentNode() const {
+#ifdef __linux__
+        const int cpu = sched_getcpu();
+        if (cpu >= 0 && static_cast<std::size_t>(cpu) < cpuNodes.size()) {
+            return cpuNodes[cpu];
+        }
+#endif
+        return 0;
+    }
+
+    /**
+     * Pin the threads of the OpenMP team in contiguous blocks to the nodes, so that
+     * the threads of a node share its memory. Workers keep their pinning for later
+     * parallel regions of the same size.
+     */
+    void pinThreads() const {
+#if defined(__linux__) && defined(_OPENMP)
+        if (!isEnabled()) {
+            return;
+        }
+#pragma omp parallel
+        {
+            const std::size_t node = omp_get_thread_num() * nodes.size() / omp_get_num_threads();
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : nodes[node]) {
+                CPU_SET(cpu, &set);
+            }
+            sched_setaffinity(0, sizeof(set), &set);
+        }
+#endif
+    }
+
+    /**
+     * Apply the placement of the mode to memory of the calling thread that has not
+     * been touched yet. The memory is expected to start on a page boundary.
+     */
+    void place(void* memory, std::size_t size) const {
+#ifdef __linux__
+        if (!isEnabled()) {
+            return;
+        }
+        std::vector<unsigned long> mask((nodes.size() + bitsPerWord - 1) / bitsPerWord, 0);
+        int policy;
+        if (mode == NumaMode::INTERLEAVE) {
+            policy = MPOL_INTERLEAVE;
+            for (std::size_t node = 0; node < nodes.size(); node++) {
+                mask[node / bitsPerWord] |= 1ul << (node % bitsPerWord);
+            }
+        } else {
+            // preferred rather than bound, so that a full node spills to the others
+            policy = MPOL_PREFERRED;
+            const std::size_t node = getCurrentNode();
+            mask[node / bitsPerWord] |= 1ul << (node % bitsPerWord);
+        }
+        // failures leave the default placement in place
+        syscall(SYS_mbind, memory, size, policy, mask.data(), nodes.size() + 1, 0);
+#endif
+    }
+
+    /** The node holding the page of the given address, or the current node if unknown */
+    std::size_t getNodeOf(const void* address) const {
+#ifdef __linux__
+        if (isEnabled()) {
+            int node = -1;
+            if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address, MPOL_F_NODE | MPOL_F_ADDR) == 0 &&
+                    node >= 0 && static_cast<std::size_t>(node) < nodes.size()) {
+                return node;
+            }
+        }
+#endif
+        return getCurrentNode();
+    }
+
+    /** The size of memory pages */
+    static std::size_t getPageSize() {
+#ifdef __linux__
+        return sysconf(_SC_PAGESIZE);
+#else
+        return 4096;
+#endif
+    }
+
+private:
+    // memory policies and flags of the mbind and get_mempolicy system calls (see numaif.h)
+    static constexpr int MPOL_PREFERRED = 1;
+    static constexpr int MPOL_INTERLEAVE = 3;
+    static constexpr int MPOL_F_NODE = 1;
+    static constexpr int MPOL_F_ADDR = 2;
+    static constexpr std::size_t bitsPerWord = sizeof(unsigned long) * 8;
+
+    Numa() {
+#ifdef __linux__
+        // the CPUs of each node, e.g. 0-7,16-23
+        for (std::size_t node = 0;; node++) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file) {
+                break;
+            }
+            std::vector<int> cpus;
+            std::string range;
+            while (std::getline(file, range, ',')) {
+                const auto dash = range.find('-');
+                try {
+                    const int first = std::stoi(range.substr(0, dash));
+                    const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                    for (int cpu = first; cpu <= last; cpu++) {
+                        cpus.push_back(cpu);
+                    }
+                } catch (...) {
+                    // skip malformed ranges
+                }
+            }
+            for (int cpu : cpus) {
+                if (cpuNodes.size() <= static_cast<std::size_t>(cpu)) {
+                    cpuNodes.resize(cpu + 1, 0);
+                }
+                cpuNodes[cpu] = node;
+            }
+            nodes.push_back(std::move(cpus));
+        }
+#endif
+    }
+
+    /** the CPUs of each node */
+    std::vector<std::vector<int>> nodes;
+
+    /** the node of each CPU */
+    std::vector<std::size_t> cpuNodes;
+
+    NumaMode mode = NumaMode::NONE;
+};
+
+namespace detail {
+
+/**
+ * The address of the tuple an iterator points to, or nullptr if it has no lasting address:
+ * iterators of brie and eqrel produce their tuples by value, and others hold the tuple
+ * they produce themselves, so that the address would be that of a temporary.
+ */
+template <typename Iter>
+const void* getTupleAddress(Iter& iter) {
+    if constexpr (std::is_lvalue_reference_v<decltype(*iter)>) {
+        const auto address = reinterpret_cast<std::uintptr_t>(&*iter);
+        const auto self = reinterpret_cast<std::uintptr_t>(&iter);
+        if (address < self || address >= self + sizeof(Iter)) {
+            return &*iter;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace detail
+
+/**
+ * Hands out the chunks of a partitioned relation to the threads of a parallel region.
+ * A thread takes the chunks held by its own node first, and then helps with the chunks
+ * of the other nodes. Without NUMA, chunks are handed out in order, like a dynamic
+ * schedule.
+ */
+template <typename Chunks>
+class NumaChunkQueue {
+public:
+    using chunk_type = typename Chunks::value_type;
+
+    explicit NumaChunkQueue(const Chunks& chunks)
+            : chunks(chunks), lists(Numa::instance().isEnabled() ? Numa::instance().getNumNodes() : 1),
+              cursors(new std::atomic<std::size_t>[lists.size()]) {
+        for (std::size_t i = 0; i < chunks.size(); i++) {
+            // a chunk belongs to the node holding its first tuple; the chunks of containers
+            // producing their tuples by value are dealt out to the nodes in turn
+            std::size_t node = 0;
+            auto first = chunks[i].begin();
+            if (lists.size() > 1 && first != chunks[i].end()) {
+                const void* address = detail::getTupleAddress(first);
+                node = (address != nullptr ? Numa::instance().getNodeOf(address) : i) % lists.size();
+            }
+            lists[node].push_back(i);
+        }
+        for (std::size_t node = 0; node < lists.size(); node++) {
+            cursors[node] = 0;
+        }
+    }
+
+    /** Obtain the next chunk for the calling thread, or nullptr if all are taken */
+    const chunk_type* next() {
+        const std::size_t home = lists.size() > 1 ? Numa::instance().getCurrentNode() : 0;
+        for (std::size_t i = 0; i < lists.size(); i++) {
+            const std::size_t node = (home + i) % lists.size();
+            if (cursors[node].load(std::memory_order_relaxed) >= lists[node].size()) {
+                continue;
+            }
+            const std::size_t pos = cursors[node]++;
+            if (pos < lists[node].size()) {
+                return &chunks[lists[node][pos]];
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    const Chunks& chunks;
+
+    /** the chunks held by each node */
+    std::vector<std::vector<std::size_t>> lists;
+
+    /** the number of chunks taken from each list */
+    std::unique_ptr<std::atomic<std::size_t>[]> cursors;
+};
+
+}  // namespace souffle
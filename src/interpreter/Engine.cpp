@@ -22,6 +22,7 @@
 #include "interpreter/Node.h"
 #include "interpreter/Relation.h"
 #include "interpreter/ViewContext.h"
+#include "ram/Adaptive.h"
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
 #include "ram/Break.h"
@@ -31,16 +32,19 @@
 #include "ram/Conjunction.h"
 #include "ram/Constant.h"
 #include "ram/Constraint.h"
+#include "ram/Dataflow.h"
 #include "ram/DebugInfo.h"
 #include "ram/EmptinessCheck.h"
 #include "ram/ExistenceCheck.h"
 #include "ram/Exit.h"
 #include "ram/Extend.h"
+#include "ram/Facts.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
 #include "ram/IO.h"
 #include "ram/IndexAggregate.h"
 #include "ram/IndexChoice.h"
+#include "ram/IndexOperation.h"
 #include "ram/IndexScan.h"
 #include "ram/IntrinsicOperator.h"
 #include "ram/LogRelationTimer.h"
@@ -75,6 +79,7 @@
 #include "ram/TupleOperation.h"
 #include "ram/UnpackRecord.h"
 #include "ram/UserDefinedOperator.h"
+#include "ram/utility/ExecutionOrder.h"
 #include "ram/utility/Visitor.h"
 #include "souffle/BinaryConstraintOps.h"
 #include "souffle/RamTypes.h"
@@ -87,8 +92,11 @@
 #include "souffle/io/WriteStream.h"
 #include "souffle/profile/Logger.h"
 #include "souffle/profile/ProfileEvent.h"
+#include "souffle/utility/DataflowScheduler.h"
 #include "souffle/utility/EvaluatorUtil.h"
+#include "souffle/utility/HugePageUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/NumaUtil.h"
 #include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include <algorithm>
@@ -143,12 +151,37 @@ Engine::Engine(ram::TranslationUnit& tUnit)
           frequencyCounterEnabled(Global::config().has("profile-frequency")),
           isProvenance(Global::config().has("provenance")),
           numOfThreads(std::stoi(Global::config().get("jobs"))), tUnit(tUnit),
-          isa(tUnit.getAnalysis<ram::analysis::IndexAnalysis>()) {
+          isa(tUnit.getAnalysis<ram::analysis::IndexAnalysis>()),
+          writeQueue(Global::config().has("async-output")
+                             ? std::stoul(Global::config().get("async-output"))
+                             : 1),
+          readQueue(Global::config().has("prefetch-input")
+                            ? std::stoul(Global::config().get("prefetch-input"))
+                            : 1),
+          spillStore(Global::config().has("memory-limit")
+                             ? std::stoul(Global::config().get("memory-limit")) << 20
+                             : 0,
+                  Global::config().has("compress-spills")) {
 #ifdef _OPENMP
     if (numOfThreads > 0) {
         omp_set_num_threads(numOfThreads);
     }
 #endif
+    HugePages::instance().setEnabled(Global::config().has("huge-pages"));
+    if (Global::config().has("numa")) {
+        Numa::instance().setMode(Global::config().get("numa"));
+        Numa::instance().pinThreads();
+    }
+}
+
+size_t Engine::getMemoryUsage() const {
+    size_t usage = 0;
+    for (const auto& handle : relations) {
+        if (handle != nullptr && *handle != nullptr) {
+            usage += (*handle)->getMemoryUsage();
+        }
+    }
+    return usage;
 }
 
 Engine::RelationHandle& Engine::getRelationHandle(const size_t idx) {
@@ -274,12 +307,14 @@ void Engine::executeMain() {
 
     generateIR();
     assert(main != nullptr && "Executing an empty program");
+    prefetchInputs();
 
     Context ctxt;
 
     if (!profileEnabled) {
         Context ctxt;
         execute(main.get(), ctxt);
+        writeQueue.waitAll();
     } else {
         ProfileEventSingleton::instance().setOutputFile(Global::config().get("profile"));
         // Prepare the frequency table for threaded use
@@ -290,6 +325,11 @@ void Engine::executeMain() {
                 frequencies[node.getProfileText()].emplace_back(0);
             }
         });
+        // Prepare the search table for threaded use
+        if (frequencyCounterEnabled) {
+            visitDepthFirst(program, [&](const ram::IndexOperation& node) { searches[&node] = 0; });
+            visitDepthFirst(program, [&](const ram::ExistenceCheck& node) { searches[&node] = 0; });
+        }
         // Enable profiling for execution of main
         ProfileEventSingleton::instance().startTimer();
         ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");
@@ -306,6 +346,10 @@ void Engine::executeMain() {
             }
         }
         ProfileEventSingleton::instance().makeConfigRecord("relationCount", std::to_string(relationCount));
+        // Store the NUMA placement in effect
+        ProfileEventSingleton::instance().makeConfigRecord("numa-mode", Numa::instance().getModeName());
+        ProfileEventSingleton::instance().makeConfigRecord(
+                "numa-nodes", std::to_string(Numa::instance().getNumNodes()));
 
         // Store count of rules
         size_t ruleCount = 0;
@@ -314,6 +358,7 @@ void Engine::executeMain() {
 
         Context ctxt;
         execute(main.get(), ctxt);
+        writeQueue.waitAll();
         ProfileEventSingleton::instance().stopTimer();
         for (auto const& cur : frequencies) {
             for (size_t i = 0; i < cur.second.size(); ++i) {
@@ -324,6 +369,21 @@ void Engine::executeMain() {
             ProfileEventSingleton::instance().makeQuantityEvent(
                     "@relation-reads;" + cur.first, cur.second, 0);
         }
+        // Aggregate the searches of each relation by their search signature
+        std::map<std::string, size_t> searchCounts;
+        for (auto const& cur : searches) {
+            std::stringstream key;
+            if (const auto* indexOp = as<ram::IndexOperation>(cur.first)) {
+                key << indexOp->getRelation() << ";" << isa->getSearchSignature(indexOp);
+            } else if (const auto* existCheck = as<ram::ExistenceCheck>(cur.first)) {
+                key << existCheck->getRelation() << ";" << isa->getSearchSignature(existCheck);
+            }
+            searchCounts[key.str()] += cur.second;
+        }
+        for (auto const& cur : searchCounts) {
+            ProfileEventSingleton::instance().makeQuantityEvent(
+                    "@relation-searches;" + cur.first, cur.second, 0);
+        }
     }
     SignalHandler::instance()->reset();
 }
@@ -341,6 +401,31 @@ void Engine::generateIR() {
     }
 }
 
+void Engine::prefetchInputs() {
+    std::map<std::string, RelationWrapper*> relationsByName;
+    for (auto& handle : relations) {
+        if (handle != nullptr) {
+            relationsByName[(*handle)->getName()] = handle->get();
+        }
+    }
+    for (const ram::IO* io : ram::getLoadsInExecutionOrder(tUnit.getProgram())) {
+        if (io->getDirectives().count("prefetch") == 0) {
+            continue;
+        }
+        RelationWrapper* rel = relationsByName.at(io->getRelation());
+        readQueue.add(rel, [this, io, rel]() {
+            try {
+                IOSystem::getInstance()
+                        .getReader(io->getDirectives(), getSymbolTable(), getRecordTable())
+                        ->readAll(*rel);
+            } catch (std::exception& e) {
+                std::cerr << "Error loading data: " << e.what() << "\n";
+            }
+        });
+    }
+    readQueue.start();
+}
+
 void Engine::executeSubroutine(
         const std::string& name, const std::vector<RamDomain>& args, std::vector<RamDomain>& ret) {
     Context ctxt;
@@ -1109,6 +1194,32 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
             return true;
         ESAC(Parallel)
 
+        CASE(Adaptive)
+            // evaluate the costs and execute the cheapest alternative
+            const auto& children = shadow.getChildren();
+            const size_t numAlternatives = children.size() / 2;
+            size_t choice = 0;
+            RamDomain minCost = execute(children[0].get(), ctxt);
+            for (size_t i = 1; i < numAlternatives; i++) {
+                RamDomain cost = execute(children[i].get(), ctxt);
+                if (cost < minCost) {
+                    minCost = cost;
+                    choice = i;
+                }
+            }
+            return execute(children[numAlternatives + choice].get(), ctxt);
+        ESAC(Adaptive)
+
+        CASE(Dataflow)
+            // each step executes in a scope of its own
+            const auto& children = shadow.getChildren();
+            DataflowScheduler scheduler(cur.getPredecessors(), cur.getConcurrencyLimit());
+            return scheduler.run([&](size_t step) {
+                Context stepCtxt(ctxt);
+                return execute(children[step].get(), stepCtxt);
+            });
+        ESAC(Dataflow)
+
         CASE(Loop)
             resetIterationNumber();
             while (execute(shadow.getChild(), ctxt)) {
@@ -1140,6 +1251,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
 #define CLEAR(Structure, Arity, ...)                             \
     CASE(Clear, Structure, Arity)                                \
+        writeQueue.wait(node->getRelation());                    \
         auto& rel = *static_cast<RelType*>(node->getRelation()); \
         rel.__purge();                                           \
         return true;                                             \
@@ -1148,6 +1260,15 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         FOR_EACH(CLEAR)
 #undef CLEAR
 
+        CASE(Facts)
+            auto& rel = *node->getRelation();
+            const auto& values = cur.getValues();
+            for (size_t i = 0; i < values.size(); i += cur.getArity()) {
+                rel.insert(values.data() + i);
+            }
+            return true;
+        ESAC(Facts)
+
         CASE(Call)
             execute(subroutine[shadow.getSubroutineId()].get(), ctxt);
             return true;
@@ -1166,6 +1287,11 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
             auto& rel = *node->getRelation();
 
             if (op == "input") {
+                if (directive.count("prefetch") > 0) {
+                    // the relation has been read ahead
+                    readQueue.wait(&rel);
+                    return true;
+                }
                 try {
                     IOSystem::getInstance()
                             .getReader(directive, getSymbolTable(), getRecordTable())
@@ -1174,11 +1300,49 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
                     std::cerr << "Error loading data: " << e.what() << "\n";
                 }
                 return true;
-            } else if (op == "output" || op == "printsize") {
+            } else if (op == "output" || op == "printsize" || op == "statistics") {
                 try {
-                    IOSystem::getInstance()
-                            .getWriter(directive, getSymbolTable(), getRecordTable())
-                            ->writeAll(rel);
+                    auto write = [this, &directive, &rel]() {
+                        IOSystem::getInstance()
+                                .getWriter(directive, getSymbolTable(), getRecordTable())
+                                ->writeAll(rel);
+                    };
+                    if (directive.count("async") > 0) {
+                        // the relation is written in the background until it is cleared
+                        writeQueue.submit(&rel, write);
+                    } else {
+                        write();
+                    }
+                } catch (std::exception& e) {
+                    std::cerr << e.what();
+                    exit(EXIT_FAILURE);
+                }
+                return true;
+            } else if (op == "spill") {
+                // relations are only spilled while the memory limit is exceeded
+                if (!spillStore.isSpilled(cur.get("name")) && spillStore.exceeds(getMemoryUsage())) {
+                    writeQueue.wait(&rel);
+                    const std::size_t rawUsage = rel.getMemoryUsage();
+                    try {
+                        spillStore.spill(rel, directive, getSymbolTable(), getRecordTable());
+                    } catch (std::exception& e) {
+                        std::cerr << e.what();
+                        exit(EXIT_FAILURE);
+                    }
+                    // record the memory saved by compressing the spilled relation
+                    if (profileEnabled && spillStore.isCompressing()) {
+                        const std::string& name = cur.get("name");
+                        ProfileEventSingleton::instance().makeQuantityEvent(
+                                "@relation-spill;" + name + ";raw", rawUsage, 0);
+                        ProfileEventSingleton::instance().makeQuantityEvent(
+                                "@relation-spill;" + name + ";compressed",
+                                spillStore.getCompressedMemoryUsage(name), 0);
+                    }
+                }
+                return true;
+            } else if (op == "restore") {
+                try {
+                    spillStore.restore(rel, directive, getSymbolTable(), getRecordTable());
                 } catch (std::exception& e) {
                     std::cerr << e.what();
                     exit(EXIT_FAILURE);
@@ -1256,6 +1420,9 @@ RamDomain Engine::evalExistenceCheck(const ExistenceCheck& shadow, Context& ctxt
     if (profileEnabled && !shadow.isTemp()) {
         reads[shadow.getRelationName()]++;
     }
+    if (profileEnabled && frequencyCounterEnabled) {
+        searches[shadow.getShadow()]++;
+    }
 
     const auto& superInfo = shadow.getSuperInst();
     // for total we use the exists test
@@ -1355,6 +1522,7 @@ RamDomain Engine::evalParallelScan(
     auto viewContext = shadow.getViewContext();
 
     auto pStream = rel.partitionScan(numOfThreads);
+    NumaChunkQueue<decltype(pStream)> queue(pStream);
 
     PARALLEL_START
         Context newCtxt(ctxt);
@@ -1362,7 +1530,7 @@ RamDomain Engine::evalParallelScan(
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
-        pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+        for (auto* it = queue.next(); it != nullptr; it = queue.next()) {
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (!execute(shadow.getNestedOperation(), newCtxt)) {
@@ -1376,6 +1544,9 @@ RamDomain Engine::evalParallelScan(
 
 template <typename Rel>
 RamDomain Engine::evalIndexScan(const ram::IndexScan& cur, const IndexScan& shadow, Context& ctxt) {
+    if (profileEnabled && frequencyCounterEnabled) {
+        searches[&cur]++;
+    }
     constexpr size_t Arity = Rel::Arity;
     // create pattern tuple for range query
     const auto& superInfo = shadow.getSuperInst();
@@ -1398,6 +1569,9 @@ RamDomain Engine::evalIndexScan(const ram::IndexScan& cur, const IndexScan& shad
 template <typename Rel>
 RamDomain Engine::evalParallelIndexScan(
         const Rel& rel, const ram::ParallelIndexScan& cur, const ParallelIndexScan& shadow, Context& ctxt) {
+    if (profileEnabled && frequencyCounterEnabled) {
+        searches[&cur]++;
+    }
     auto viewContext = shadow.getViewContext();
 
     // create pattern tuple for range query
@@ -1409,13 +1583,14 @@ RamDomain Engine::evalParallelIndexScan(
 
     size_t indexPos = shadow.getViewId();
     auto pStream = rel.partitionRange(indexPos, low, high, numOfThreads);
+    NumaChunkQueue<decltype(pStream)> queue(pStream);
     PARALLEL_START
         Context newCtxt(ctxt);
         auto viewInfo = viewContext->getViewInfoForNested();
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
-        pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+        for (auto* it = queue.next(); it != nullptr; it = queue.next()) {
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (!execute(shadow.getNestedOperation(), newCtxt)) {
@@ -1446,13 +1621,14 @@ RamDomain Engine::evalParallelChoice(
     auto viewContext = shadow.getViewContext();
 
     auto pStream = rel.partitionScan(numOfThreads);
+    NumaChunkQueue<decltype(pStream)> queue(pStream);
     auto viewInfo = viewContext->getViewInfoForNested();
     PARALLEL_START
         Context newCtxt(ctxt);
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
-        pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+        for (auto* it = queue.next(); it != nullptr; it = queue.next()) {
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (execute(shadow.getCondition(), newCtxt)) {
@@ -1467,6 +1643,9 @@ RamDomain Engine::evalParallelChoice(
 
 template <typename Rel>
 RamDomain Engine::evalIndexChoice(const ram::IndexChoice& cur, const IndexChoice& shadow, Context& ctxt) {
+    if (profileEnabled && frequencyCounterEnabled) {
+        searches[&cur]++;
+    }
     constexpr size_t Arity = Rel::Arity;
     const auto& superInfo = shadow.getSuperInst();
     souffle::Tuple<RamDomain, Arity> low;
@@ -1489,6 +1668,9 @@ RamDomain Engine::evalIndexChoice(const ram::IndexChoice& cur, const IndexChoice
 template <typename Rel>
 RamDomain Engine::evalParallelIndexChoice(const Rel& rel, const ram::ParallelIndexChoice& cur,
         const ParallelIndexChoice& shadow, Context& ctxt) {
+    if (profileEnabled && frequencyCounterEnabled) {
+        searches[&cur]++;
+    }
     auto viewContext = shadow.getViewContext();
 
     auto viewInfo = viewContext->getViewInfoForNested();
@@ -1502,13 +1684,14 @@ RamDomain Engine::evalParallelIndexChoice(const Rel& rel, const ram::ParallelInd
 
     size_t indexPos = shadow.getViewId();
     auto pStream = rel.partitionRange(indexPos, low, high, numOfThreads);
+    NumaChunkQueue<decltype(pStream)> queue(pStream);
 
     PARALLEL_START
         Context newCtxt(ctxt);
         for (const auto& info : viewInfo) {
             newCtxt.createView(*getRelationHandle(info[0]), info[1], info[2]);
         }
-        pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
+        for (auto* it = queue.next(); it != nullptr; it = queue.next()) {
             for (const auto& tuple : *it) {
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (execute(shadow.getCondition(), newCtxt)) {
@@ -1652,6 +1835,9 @@ RamDomain Engine::evalParallelAggregate(
 template <typename Rel>
 RamDomain Engine::evalParallelIndexAggregate(
         const ram::ParallelIndexAggregate& cur, const ParallelIndexAggregate& shadow, Context& ctxt) {
+    if (profileEnabled && frequencyCounterEnabled) {
+        searches[&cur]++;
+    }
     // TODO (rdowavic): make parallel
     auto viewContext = shadow.getViewContext();
 
@@ -1678,6 +1864,9 @@ RamDomain Engine::evalParallelIndexAggregate(
 template <typename Rel>
 RamDomain Engine::evalIndexAggregate(
         const ram::IndexAggregate& cur, const IndexAggregate& shadow, Context& ctxt) {
+    if (profileEnabled && frequencyCounterEnabled) {
+        searches[&cur]++;
+    }
     // init temporary tuple for this level
     const size_t Arity = Rel::Arity;
     const auto& superInfo = shadow.getSuperInst();
@@ -27,6 +27,9 @@
 #include "souffle/RamTypes.h"
 #include "souffle/RecordTable.h"
 #include "souffle/SymbolTable.h"
+#include "souffle/io/ReadQueue.h"
+#include "souffle/io/SpillStore.h"
+#include "souffle/io/WriteQueue.h"
 #include "souffle/utility/ContainerUtil.h"
 #include <atomic>
 #include <cstddef>
@@ -64,10 +67,14 @@ public:
 private:
     /** @brief Generate intermediate representation from RAM */
     void generateIR();
+    /** @brief Start reading input relations ahead of their use */
+    void prefetchInputs();
     /** @brief Remove a relation from the environment */
     void dropRelation(const size_t relId);
     /** @brief Swap the content of two relations */
     void swapRelation(const size_t ramRel1, const size_t ramRel2);
+    /** @brief Return the number of bytes used by all relations */
+    size_t getMemoryUsage() const;
     /** @brief Return a reference to the relation on the given index */
     RelationHandle& getRelationHandle(const size_t idx);
     /** @brief Return the string symbol table */
@@ -165,11 +172,13 @@ private:
     /** Profile counter */
     std::atomic<RamDomain> counter{0};
     /** Loop iteration counter */
-    size_t iteration = 0;
+    std::atomic<size_t> iteration{0};
     /** Profile for rule frequencies */
     std::map<std::string, std::deque<std::atomic<size_t>>> frequencies;
     /** Profile for relation reads */
     std::map<std::string, std::atomic<size_t>> reads;
+    /** Profile for index searches */
+    std::map<const ram::Node*, std::atomic<size_t>> searches;
     /** DLL */
     std::vector<void*> dll;
     /** Program */
@@ -180,6 +189,12 @@ private:
     RecordTable recordTable;
     /** Symbol table for relations */
     VecOwn<RelationHandle> relations;
+    /** Output relations written in the background */
+    WriteQueue writeQueue;
+    /** Input relations read ahead of their use */
+    ReadQueue readQueue;
+    /** Relations spilled to disk */
+    SpillStore spillStore;
 };
 
 }  // namespace souffle::interpreter
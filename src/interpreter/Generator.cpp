@@ -374,6 +374,25 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Parallel>, const ram::Parallel&
     return mk<Parallel>(I_Parallel, &parallel, std::move(children));
 }
 
+NodePtr NodeGenerator::visit_(type_identity<ram::Adaptive>, const ram::Adaptive& adaptive) {
+    NodePtrVec children;
+    for (const auto& cost : adaptive.getCosts()) {
+        children.push_back(visit(*cost));
+    }
+    for (const auto& value : adaptive.getStatements()) {
+        children.push_back(visit(*value));
+    }
+    return mk<Adaptive>(I_Adaptive, &adaptive, std::move(children));
+}
+
+NodePtr NodeGenerator::visit_(type_identity<ram::Dataflow>, const ram::Dataflow& dataflow) {
+    NodePtrVec children;
+    for (const auto& value : dataflow.getStatements()) {
+        children.push_back(visit(*value));
+    }
+    return mk<Dataflow>(I_Dataflow, &dataflow, std::move(children));
+}
+
 NodePtr NodeGenerator::visit_(type_identity<ram::Loop>, const ram::Loop& loop) {
     return mk<Loop>(I_Loop, &loop, visit(loop.getBody()));
 }
@@ -414,6 +433,12 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Clear>, const ram::Clear& clear
     return mk<Clear>(type, &clear, rel);
 }
 
+NodePtr NodeGenerator::visit_(type_identity<ram::Facts>, const ram::Facts& facts) {
+    size_t relId = encodeRelation(facts.getRelation());
+    auto rel = getRelationHandle(relId);
+    return mk<Facts>(I_Facts, &facts, rel);
+}
+
 NodePtr NodeGenerator::visit_(type_identity<ram::LogSize>, const ram::LogSize& size) {
     size_t relId = encodeRelation(size.getRelation());
     auto rel = getRelationHandle(relId);
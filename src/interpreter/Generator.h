@@ -24,6 +24,7 @@
 #include "interpreter/ViewContext.h"
 #include "ram/AbstractExistenceCheck.h"
 #include "ram/AbstractParallel.h"
+#include "ram/Adaptive.h"
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
 #include "ram/Break.h"
@@ -34,12 +35,14 @@
 #include "ram/Conjunction.h"
 #include "ram/Constant.h"
 #include "ram/Constraint.h"
+#include "ram/Dataflow.h"
 #include "ram/DebugInfo.h"
 #include "ram/EmptinessCheck.h"
 #include "ram/ExistenceCheck.h"
 #include "ram/Exit.h"
 #include "ram/Expression.h"
 #include "ram/Extend.h"
+#include "ram/Facts.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
 #include "ram/IO.h"
@@ -204,6 +207,8 @@ public:
     NodePtr visit_(type_identity<ram::Sequence>, const ram::Sequence& seq) override;
 
     NodePtr visit_(type_identity<ram::Parallel>, const ram::Parallel& parallel) override;
+    NodePtr visit_(type_identity<ram::Adaptive>, const ram::Adaptive& adaptive) override;
+    NodePtr visit_(type_identity<ram::Dataflow>, const ram::Dataflow& dataflow) override;
 
     NodePtr visit_(type_identity<ram::Loop>, const ram::Loop& loop) override;
 
@@ -219,6 +224,8 @@ public:
 
     NodePtr visit_(type_identity<ram::Clear>, const ram::Clear& clear) override;
 
+    NodePtr visit_(type_identity<ram::Facts>, const ram::Facts& facts) override;
+
     NodePtr visit_(type_identity<ram::LogSize>, const ram::LogSize& size) override;
 
     NodePtr visit_(type_identity<ram::IO>, const ram::IO& io) override;
@@ -229,6 +229,13 @@ public:
         return data.size();
     }
 
+    /**
+     * Obtains the number of bytes used by this index.
+     */
+    size_t getMemoryUsage() const {
+        return data.getMemoryUsage();
+    }
+
     /**
      * Inserts a tuple into this index.
      */
@@ -401,6 +408,10 @@ public:
         return data ? 1 : 0;
     }
 
+    size_t getMemoryUsage() const {
+        return sizeof(*this);
+    }
+
     bool insert(const Tuple& /* t */) {
         return data = true;
     }
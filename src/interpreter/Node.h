@@ -91,12 +91,15 @@ struct RelationWrapper;
     Forward(SubroutineReturn)\
     Forward(Sequence)\
     Forward(Parallel)\
+    Forward(Adaptive)\
+    Forward(Dataflow)\
     Forward(Loop)\
     Forward(Exit)\
     Forward(LogRelationTimer)\
     Forward(LogTimer)\
     Forward(DebugInfo)\
     FOR_EACH(Expand, Clear)\
+    Forward(Facts)\
     Forward(LogSize)\
     Forward(IO)\
     Forward(Query)\
@@ -755,6 +758,22 @@ class Parallel : public CompoundNode {
     using CompoundNode::CompoundNode;
 };
 
+/**
+ * @class Adaptive
+ * @brief The first half of the children are the costs, the second half the alternatives.
+ */
+class Adaptive : public CompoundNode {
+    using CompoundNode::CompoundNode;
+};
+
+/**
+ * @class Dataflow
+ * @brief The children are the steps, the dependencies are those of the RAM node.
+ */
+class Dataflow : public CompoundNode {
+    using CompoundNode::CompoundNode;
+};
+
 /**
  * @class Loop
  */
@@ -797,6 +816,13 @@ class Clear : public Node {
     using Node::Node;
 };
 
+/**
+ * @class Facts
+ */
+class Facts : public Node {
+    using Node::Node;
+};
+
 /**
  * @class Call
  */
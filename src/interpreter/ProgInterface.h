@@ -29,9 +29,11 @@
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
 #include "souffle/utility/MiscUtil.h"
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -58,11 +60,24 @@ public:
         relation.insert(t.data);
     }
 
+    /** Insert tuples stored contiguously */
+    void insertAll(const RamDomain* data, std::size_t count) override {
+        const arity_type arity = getArity();
+        for (std::size_t i = 0; i < count; i++) {
+            relation.insert(data + i * arity);
+        }
+    }
+
     /** Check whether tuple exists */
     bool contains(const tuple& t) const override {
         return relation.contains(t.data);
     }
 
+    /** Find the auxiliary attributes of a tuple through the main index */
+    bool findAuxiliary(const RamDomain* primary, RamDomain* auxiliary) const override {
+        return relation.findAuxiliary(primary, auxiliary);
+    }
+
     /** Iterator to first tuple */
     iterator begin() const override {
         return RelInterface::iterator(mk<RelInterface::iterator_base>(id, this, relation.begin()));
@@ -110,12 +125,24 @@ public:
         return relation.size();
     }
 
+    /** Check whether the relation is empty */
+    bool empty() const override {
+        return relation.empty();
+    }
+
     /** Eliminate all the tuples in relation*/
     void purge() override {
         relation.purge();
     }
 
 protected:
+    /** Visit the tuples of the wrapped relation */
+    void forEachTuple(const std::function<void(const RamDomain*)>& visitor) const override {
+        for (auto it = relation.begin(), end = relation.end(); it != end; ++it) {
+            visitor(*it);
+        }
+    }
+
     /**
      * Iterator wrapper class
      */
@@ -21,6 +21,7 @@
 #include "souffle/RamTypes.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/utility/MiscUtil.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
@@ -109,8 +110,14 @@ public:
 
     virtual bool contains(const RamDomain*) const = 0;
 
+    virtual bool findAuxiliary(const RamDomain* primary, RamDomain* auxiliary) const = 0;
+
     virtual size_t size() const = 0;
 
+    virtual bool empty() const = 0;
+
+    virtual size_t getMemoryUsage() const = 0;
+
     virtual void purge() = 0;
 
     const std::string& getName() const {
@@ -221,6 +228,27 @@ public:
         return contains(constructTuple(data));
     }
 
+    bool findAuxiliary(const RamDomain* primary, RamDomain* auxiliary) const override {
+        // bound the primary attributes and leave the auxiliary attributes open, which come
+        // last in the orders of provenance relations so that the range holds the tuple only
+        const size_t primaryArity = getArity() - getAuxiliaryArity();
+        Tuple low{};
+        Tuple high{};
+        for (size_t i = 0; i < getArity(); ++i) {
+            low[i] = i < primaryArity ? primary[i] : MIN_RAM_SIGNED;
+            high[i] = i < primaryArity ? primary[i] : MAX_RAM_SIGNED;
+        }
+        const Order order = main->getOrder();
+        for (const auto& cur : main->range(order.encode(low), order.encode(high))) {
+            const Tuple tuple = order.decode(cur);
+            if (std::equal(tuple.begin(), tuple.begin() + primaryArity, low.begin())) {
+                std::copy(tuple.begin() + primaryArity, tuple.end(), auxiliary);
+                return true;
+            }
+        }
+        return false;
+    }
+
     IndexViewPtr createView(const size_t& indexPos) const override {
         return mk<View>(indexes[indexPos]->createView());
     }
@@ -229,6 +257,14 @@ public:
         return __size();
     }
 
+    size_t getMemoryUsage() const override {
+        size_t res = 0;
+        for (const auto& index : indexes) {
+            res += index->getMemoryUsage();
+        }
+        return res;
+    }
+
     Order getIndexOrder(size_t idx) const override {
         return indexes[idx]->getOrder();
     }
@@ -368,7 +404,7 @@ public:
     /**
      * Check if the relation is empty
      */
-    bool empty() const {
+    bool empty() const override {
         return main->empty();
     }
 
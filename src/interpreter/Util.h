@@ -20,6 +20,7 @@
 #include "souffle/datastructure/BTree.h"
 #include "souffle/datastructure/Brie.h"
 #include "souffle/datastructure/EquivalenceRelation.h"
+#include "souffle/datastructure/NodePool.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
 
@@ -128,6 +129,8 @@ struct comparator;
 
 template <unsigned First, unsigned... Rest>
 struct comparator<First, Rest...> {
+    static constexpr int leading_column = First;
+
     template <typename T>
     int operator()(const T& a, const T& b) const {
         return (a[First] < b[First]) ? -1 : ((a[First] > b[First]) ? 1 : comparator<Rest...>()(a, b));
@@ -210,9 +213,9 @@ using t_tuple = typename souffle::Tuple<RamDomain, Arity>;
 template <size_t Arity>
 using comparator = typename index_utils::get_full_index<Arity>::type::comparator;
 
-// Alias for btree_set
+// Alias for btree_set, whose nodes are pooled per index
 template <size_t Arity>
-using Btree = btree_set<t_tuple<Arity>, comparator<Arity>>;
+using Btree = btree_set<t_tuple<Arity>, comparator<Arity>, PoolAllocator<t_tuple<Arity>>>;
 
 // Alias for Trie
 template <size_t Arity>
@@ -229,7 +232,7 @@ struct ProvenanceUpdater {
 
 // Alias for Provenance
 template <size_t Arity>
-using Provenance = btree_set<t_tuple<Arity>, comparator<Arity>, std::allocator<t_tuple<Arity>>, 256,
+using Provenance = btree_set<t_tuple<Arity>, comparator<Arity>, PoolAllocator<t_tuple<Arity>>, 256,
         typename detail::default_strategy<t_tuple<Arity>>::type, comparator<Arity - 2>,
         ProvenanceUpdater<Arity>>;
 
@@ -287,4 +287,44 @@ TEST(Reordering, Iteration) {
     }
 }
 
+TEST(Provenance, FindAuxiliary) {
+    // create a provenance relation, whose annotations come last in the index order
+    SymbolTable symbolTable;
+
+    SignatureOrderMap mapping;
+    SearchSignature existenceCheck = SearchSignature::getFullSearchSignature(4);
+    SearchSet searches = {existenceCheck};
+    LexOrder fullOrder = {1, 0, 3, 2};
+    OrderCollection orders = {fullOrder};
+    mapping.insert({existenceCheck, fullOrder});
+    IndexCluster indexSelection(mapping, searches, orders);
+
+    Relation<4, interpreter::Provenance> rel(2, "test", indexSelection);
+    rel.insert(souffle::Tuple<RamDomain, 4>{1, 2, 0, 0});
+    rel.insert(souffle::Tuple<RamDomain, 4>{2, 3, 1, 4});
+    rel.insert(souffle::Tuple<RamDomain, 4>{5, 1, 2, 7});
+
+    RelInterface relInt(rel, symbolTable, "test", {"i", "i", "i", "i"}, {"x", "y", "r", "l"}, 4);
+
+    // the annotations of existing tuples are found
+    RamDomain primary[2] = {2, 3};
+    RamDomain annotations[2] = {-1, -1};
+    EXPECT_TRUE(relInt.findAuxiliary(primary, annotations));
+    EXPECT_EQ(1, annotations[0]);
+    EXPECT_EQ(4, annotations[1]);
+
+    primary[0] = 5;
+    primary[1] = 1;
+    EXPECT_TRUE(relInt.findAuxiliary(primary, annotations));
+    EXPECT_EQ(2, annotations[0]);
+    EXPECT_EQ(7, annotations[1]);
+
+    // tuples sharing only some of the primary attributes are not
+    primary[1] = 2;
+    EXPECT_FALSE(relInt.findAuxiliary(primary, annotations));
+    primary[0] = 0;
+    primary[1] = 0;
+    EXPECT_FALSE(relInt.findAuxiliary(primary, annotations));
+}
+
 }  // namespace souffle::interpreter::test
@@ -81,12 +81,14 @@
 #include "ram/transform/Loop.h"
 #include "ram/transform/MakeIndex.h"
 #include "ram/transform/Parallel.h"
+#include "ram/transform/RelaxIndex.h"
 #include "ram/transform/ReorderConditions.h"
 #include "ram/transform/ReorderFilterBreak.h"
 #include "ram/transform/ReportIndex.h"
 #include "ram/transform/Sequence.h"
 #include "ram/transform/Transformer.h"
 #include "ram/transform/TupleId.h"
+#include "ram/utility/ProgramCache.h"
 #include "reports/DebugReport.h"
 #include "reports/ErrorReport.h"
 #include "souffle/RamTypes.h"
@@ -95,6 +97,7 @@
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/FileUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include "synthesiser/Synthesiser.h"
@@ -118,9 +121,20 @@
 namespace souffle {
 
 /**
- * Executes a binary file.
+ * Quotes an argument of a shell command, so that it may contain spaces and quotes.
  */
-void executeBinary(const std::string& binaryFilename) {
+std::string shellQuote(const std::string& argument) {
+    std::string res = "'";
+    for (char c : argument) {
+        res += c == '\'' ? std::string("'\\''") : std::string(1, c);
+    }
+    return res + "'";
+}
+
+/**
+ * Executes a binary file, generated from the given number of split translation units (0 if not split).
+ */
+void executeBinary(const std::string& binaryFilename, std::size_t numSplitUnits) {
     assert(!binaryFilename.empty() && "binary filename cannot be blank");
 
     // check whether the executable exists
@@ -145,11 +159,23 @@ void executeBinary(const std::string& binaryFilename) {
 #endif
     exePath += binaryFilename;
 
+    // the explain queries are answered from the file given on the command line of the program
+    if (Global::config().has("explain-batch")) {
+        exePath += " --explain-batch=" + shellQuote(Global::config().get("explain-batch"));
+    }
+
     int exitCode = system(exePath.c_str());
 
     if (Global::config().get("dl-program").empty()) {
         remove(binaryFilename.c_str());
         remove((binaryFilename + ".cpp").c_str());
+        if (numSplitUnits > 0) {
+            remove((binaryFilename + ".h").c_str());
+            remove((binaryFilename + ".h.gch").c_str());
+            for (std::size_t i = 0; i < numSplitUnits; i++) {
+                remove((binaryFilename + "_" + std::to_string(i) + ".cpp").c_str());
+            }
+        }
     }
 
     // exit with same code as executable
@@ -158,6 +184,36 @@ void executeBinary(const std::string& binaryFilename) {
     }
 }
 
+/**
+ * Executes a RAM program with the interpreter.
+ */
+void executeInterpreter(ram::TranslationUnit& ramTranslationUnit) {
+    std::thread profiler;
+    // Start up profiler if needed
+    if (Global::config().has("live-profile") && !Global::config().has("compile")) {
+        profiler = std::thread([]() { profile::Tui().runProf(); });
+    }
+
+    // configure and execute interpreter
+    Own<interpreter::Engine> interpreter(mk<interpreter::Engine>(ramTranslationUnit));
+    interpreter->executeMain();
+    // If the profiler was started, join back here once it exits.
+    if (profiler.joinable()) {
+        profiler.join();
+    }
+    if (Global::config().has("provenance")) {
+        // only run explain interface if interpreted
+        interpreter::ProgInterface interface(*interpreter);
+        if (Global::config().has("explain-batch")) {
+            explainBatch(interface, Global::config().get("explain-batch"));
+        } else if (Global::config().get("provenance") == "explain") {
+            explain(interface, false);
+        } else if (Global::config().get("provenance") == "explore") {
+            explain(interface, true);
+        }
+    }
+}
+
 /**
  * Compiles the given source file to a binary file.
  */
@@ -191,6 +247,9 @@ int main(int argc, char** argv) {
     /* Time taking for overall runtime */
     auto souffle_start = std::chrono::high_resolution_clock::now();
 
+    /* number of translation units of a split generated program, 0 if it is not split */
+    std::size_t numSplitUnits = 0;
+
     /* have all to do with command line arguments in its own scope, as these are accessible through the global
      * configuration only */
     try {
@@ -242,15 +301,62 @@ int main(int argc, char** argv) {
                 {"dl-program", 'o', "FILE", "", false,
                         "Generate C++ source code, written to <FILE>, and compile this to a "
                         "binary executable (without executing it)."},
+                {"split-units", '\7', "N", "", false,
+                        "Split the generated C++ program into N translation units that are compiled in "
+                        "parallel."},
+                {"precompiled-header", '\10', "", "", false,
+                        "Precompile the shared header of split translation units."},
+                {"compile-cache", '\11', "DIR", "", false,
+                        "Reuse compiled translation units from the cache directory <DIR>."},
+                {"adaptive-joins", '\12', "", "", false,
+                        "Choose the join order of recursive rules in each iteration from the relation "
+                        "sizes."},
+                {"async-output", '\14', "N", "", false,
+                        "Write output files in the background, with at most N files pending."},
+                {"prefetch-input", '\15', "N", "", false,
+                        "Read input files in the background ahead of their use, with at most N relations "
+                        "read ahead."},
+                {"concurrent-strata", '\16', "N", "", false,
+                        "Run each stratum as soon as the strata it depends on have finished, with at most N "
+                        "strata running concurrently; N limits the number of strata, not their memory."},
+                {"memory-limit", '\17', "N", "", false,
+                        "Spill relations that are not needed by the next stratum to disk while the "
+                        "relations use more than N megabytes."},
+                {"compress-spills", '\21', "", "", false,
+                        "Spill relations that are not needed by the next stratum to compressed blocks in "
+                        "memory, which are decoded before their next use, instead of to disk."},
+                {"numa", '\22', "[ interleave | partition ]", "", false,
+                        "Pin the worker threads to the NUMA nodes, and interleave the relations over the "
+                        "nodes or place them on the nodes of the threads inserting into them."},
+                {"huge-pages", '\23', "", "", false,
+                        "Place the nodes of relations and the symbol and record tables on huge pages."},
+                {"ram-cache", '\24', "DIR", "", false,
+                        "Reuse the optimised RAM program of an unchanged source from the cache directory "
+                        "<DIR> when interpreting."},
+                {"layered-relations", '\25', "", "", false,
+                        "Generate b-tree relations that can be layered over the relations of an evaluated "
+                        "base database."},
+                {"compact-relations", '\26', "", "", false,
+                        "Store the tuples of b-tree relations once in a row store, and their indexes as "
+                        "pointers or as columns and row ids, where this saves memory."},
+                {"freeze-relations", '\27', "", "", false,
+                        "Generate b-tree relations that are compressed once computed, and searched in "
+                        "place while compressed."},
                 {"live-profile", '\1', "", "", false, "Enable live profiling."},
                 {"profile", 'p', "FILE", "", false, "Enable profiling, and write profile data to <FILE>."},
                 {"profile-use", 'u', "FILE", "", false,
                         "Use profile log-file <FILE> for profile-guided optimization."},
                 {"profile-frequency", '\2', "", "", false, "Enable the frequency counter in the profiler."},
+                {"profile-statistics", '\13', "[ input | all ]", "", false,
+                        "Record column statistics of the input relations, or of all relations, in the "
+                        "profile."},
                 {"debug-report", 'r', "FILE", "", false, "Write HTML debug report to <FILE>."},
                 {"pragma", 'P', "OPTIONS", "", false, "Set pragma options."},
                 {"provenance", 't', "[ none | explain | explore ]", "", false,
                         "Enable provenance instrumentation and interaction."},
+                {"explain-batch", '\20', "FILE", "", false,
+                        "Answer the explain queries of <FILE> in parallel and print the proof trees as "
+                        "JSON, instead of the interactive explain interface."},
                 {"verbose", 'v', "", "", false, "Verbose output."},
                 {"version", '\3', "", "", false, "Version."},
                 {"show", '\4',
@@ -315,6 +421,10 @@ int main(int argc, char** argv) {
             }
             Global::config().set("jobs", "0");
         }
+        // the per-clause analyses of the front end run on the same number of threads
+        if (std::stoi(Global::config().get("jobs")) > 0) {
+            omp_set_num_threads(std::stoi(Global::config().get("jobs")));
+        }
 #else
         // Check that -j option has not been changed from the default
         if (Global::config().get("jobs") != "1" && !Global::config().has("no-warn")) {
@@ -377,6 +487,98 @@ int main(int argc, char** argv) {
         if (Global::config().has("live-profile") && !Global::config().has("profile")) {
             Global::config().set("profile");
         }
+
+        /* the generated program is split into translation units */
+        if (Global::config().has("split-units")) {
+            // at most 9 digits, so that the value fits into an int
+            const std::string& units = Global::config().get("split-units");
+            if (units.empty() || units.size() > 9 || !isNumber(units.c_str()) || std::stoi(units) < 1) {
+                throw std::runtime_error("invalid value for --split-units: " + units);
+            }
+            if (Global::config().has("swig")) {
+                throw std::runtime_error("option --split-units cannot be used with --swig");
+            }
+            numSplitUnits = std::stoi(units);
+        }
+
+        /* the number of output files written in the background is bounded */
+        if (Global::config().has("async-output")) {
+            if (!isNumber(Global::config().get("async-output").c_str()) ||
+                    std::stoi(Global::config().get("async-output")) < 1) {
+                throw std::runtime_error("invalid value for --async-output: " +
+                                         Global::config().get("async-output"));
+            }
+        }
+
+        /* the number of input relations read ahead is bounded */
+        if (Global::config().has("prefetch-input")) {
+            if (!isNumber(Global::config().get("prefetch-input").c_str()) ||
+                    std::stoi(Global::config().get("prefetch-input")) < 1) {
+                throw std::runtime_error("invalid value for --prefetch-input: " +
+                                         Global::config().get("prefetch-input"));
+            }
+        }
+
+        /* the number of strata running concurrently is bounded */
+        if (Global::config().has("concurrent-strata")) {
+            if (!isNumber(Global::config().get("concurrent-strata").c_str()) ||
+                    std::stoi(Global::config().get("concurrent-strata")) < 1) {
+                throw std::runtime_error("invalid value for --concurrent-strata: " +
+                                         Global::config().get("concurrent-strata"));
+            }
+            // the profile attributes loop iterations to a single stratum at a time
+            if (Global::config().has("profile")) {
+                throw std::runtime_error("option --concurrent-strata cannot be used with --profile");
+            }
+        }
+
+        /* relations are spilled to disk above the memory limit */
+        if (Global::config().has("memory-limit")) {
+            if (!isNumber(Global::config().get("memory-limit").c_str()) ||
+                    std::stoi(Global::config().get("memory-limit")) < 0) {
+                throw std::runtime_error(
+                        "invalid value for --memory-limit: " + Global::config().get("memory-limit"));
+            }
+            // strata running concurrently have no next stratum
+            if (Global::config().has("concurrent-strata")) {
+                throw std::runtime_error("option --memory-limit cannot be used with --concurrent-strata");
+            }
+        }
+
+        /* computed relations are compressed in memory between their uses */
+        if (Global::config().has("compress-spills") && Global::config().has("concurrent-strata")) {
+            throw std::runtime_error("option --compress-spills cannot be used with --concurrent-strata");
+        }
+
+        /* a frozen relation cannot serve as the base of a layered relation */
+        if (Global::config().has("freeze-relations") && Global::config().has("layered-relations")) {
+            throw std::runtime_error("option --freeze-relations cannot be used with --layered-relations");
+        }
+
+        /* threads and relations are placed on the NUMA nodes */
+        if (Global::config().has("numa") && !Global::config().has("numa", "interleave") &&
+                !Global::config().has("numa", "partition")) {
+            throw std::runtime_error("invalid value for --numa: " + Global::config().get("numa"));
+        }
+
+        /* explain queries are answered from a file */
+        if (Global::config().has("explain-batch")) {
+            if (!Global::config().has("provenance") || Global::config().get("provenance") == "none") {
+                throw std::runtime_error("option --explain-batch requires --provenance");
+            }
+        }
+
+        /* column statistics are recorded in the profile */
+        if (Global::config().has("profile-statistics")) {
+            if (!Global::config().has("profile")) {
+                throw std::runtime_error("option --profile-statistics requires --profile");
+            }
+            if (!Global::config().has("profile-statistics", "input") &&
+                    !Global::config().has("profile-statistics", "all")) {
+                throw std::runtime_error("invalid value for --profile-statistics: " +
+                                         Global::config().get("profile-statistics"));
+            }
+        }
     } catch (std::exception& e) {
         std::cerr << e.what() << std::endl;
         exit(EXIT_FAILURE);
@@ -418,11 +620,27 @@ int main(int argc, char** argv) {
 
     // ------- parse program -------------
 
+    // the RAM program cache is keyed on the pre-processed source, and only used by the interpreter
+    Own<ram::ProgramCache> ramCache;
+    std::string source;
+    if (Global::config().has("ram-cache") && !Global::config().has("compile") &&
+            !Global::config().has("dl-program") && !Global::config().has("generate") &&
+            !Global::config().has("swig") && !Global::config().has("show") &&
+            !Global::config().has("debug-report")) {
+        char buffer[4096];
+        for (std::size_t size; (size = fread(buffer, 1, sizeof(buffer), in)) > 0;) {
+            source.append(buffer, size);
+        }
+        ramCache = mk<ram::ProgramCache>(Global::config().get("ram-cache"), source);
+    }
+
     // parse file
     ErrorReport errReport(Global::config().has("no-warn"));
     DebugReport debugReport;
-    Own<ast::TranslationUnit> astTranslationUnit =
-            ParserDriver::parseTranslationUnit("<stdin>", in, errReport, debugReport);
+    Own<ast::TranslationUnit> astTranslationUnit;
+    if (ramCache == nullptr) {
+        astTranslationUnit = ParserDriver::parseTranslationUnit("<stdin>", in, errReport, debugReport);
+    }
 
     // close input pipe
     int preprocessor_status = pclose(in);
@@ -431,6 +649,31 @@ int main(int argc, char** argv) {
         throw std::runtime_error("failed to close pre-processor pipe");
     }
 
+    if (ramCache != nullptr) {
+        // ------- load the optimised RAM program of an unchanged source -------------
+        if (auto ramTranslationUnit = ramCache->load(errReport, debugReport)) {
+            if (Global::config().has("verbose")) {
+                auto load_end = std::chrono::high_resolution_clock::now();
+                std::cout << "RAM Cache Load Time: "
+                          << std::chrono::duration<double>(load_end - parser_start).count() << "sec ("
+                          << ramCache->getFilename() << ")\n";
+            }
+            try {
+                executeInterpreter(*ramTranslationUnit);
+            } catch (std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+            if (Global::config().has("verbose")) {
+                auto souffle_end = std::chrono::high_resolution_clock::now();
+                std::cout << "Total Time: "
+                          << std::chrono::duration<double>(souffle_end - souffle_start).count() << "sec\n";
+            }
+            return 0;
+        }
+        astTranslationUnit = ParserDriver::parseTranslationUnit(source, errReport, debugReport);
+    }
+
     /* Report run-time of the parser if verbose flag is set */
     if (Global::config().has("verbose")) {
         auto parser_end = std::chrono::high_resolution_clock::now();
@@ -610,6 +853,8 @@ int main(int argc, char** argv) {
                 mk<ExpandFilterTransformer>(), mk<HoistConditionsTransformer>(),
                 mk<CollapseFiltersTransformer>(), mk<EliminateDuplicatesTransformer>(),
                 mk<ReorderConditionsTransformer>(), mk<LoopTransformer>(mk<ReorderFilterBreak>()),
+                mk<ConditionalTransformer>([]() -> bool { return Global::config().has("profile-use"); },
+                        mk<RelaxIndexTransformer>()),
                 mk<ConditionalTransformer>(
                         // job count of 0 means all cores are used.
                         []() -> bool { return std::stoi(Global::config().get("jobs")) != 1; },
@@ -623,6 +868,10 @@ int main(int argc, char** argv) {
         std::cerr << ramTranslationUnit->getErrorReport();
     }
 
+    if (ramCache != nullptr) {
+        ramCache->store(*ramTranslationUnit);
+    }
+
     // Output the transformed RAM program and return
     if (Global::config().get("show") == "transformed-ram") {
         std::cout << ramTranslationUnit->getProgram();
@@ -633,29 +882,7 @@ int main(int argc, char** argv) {
         if (!Global::config().has("compile") && !Global::config().has("dl-program") &&
                 !Global::config().has("generate") && !Global::config().has("swig")) {
             // ------- interpreter -------------
-
-            std::thread profiler;
-            // Start up profiler if needed
-            if (Global::config().has("live-profile") && !Global::config().has("compile")) {
-                profiler = std::thread([]() { profile::Tui().runProf(); });
-            }
-
-            // configure and execute interpreter
-            Own<interpreter::Engine> interpreter(mk<interpreter::Engine>(*ramTranslationUnit));
-            interpreter->executeMain();
-            // If the profiler was started, join back here once it exits.
-            if (profiler.joinable()) {
-                profiler.join();
-            }
-            if (Global::config().has("provenance")) {
-                // only run explain interface if interpreted
-                interpreter::ProgInterface interface(*interpreter);
-                if (Global::config().get("provenance") == "explain") {
-                    explain(interface, false);
-                } else if (Global::config().get("provenance") == "explore") {
-                    explain(interface, true);
-                }
-            }
+            executeInterpreter(*ramTranslationUnit);
         } else {
             // ------- compiler -------------
             auto synthesiser = mk<synthesiser::Synthesiser>(*ramTranslationUnit);
@@ -685,7 +912,19 @@ int main(int argc, char** argv) {
             const bool emitToStdOut = Global::config().has("generate", "-");
             if (emitToStdOut)
                 synthesiser->generateCode(std::cout, baseIdentifier, withSharedLibrary);
-            else {
+            else if (numSplitUnits > 0) {
+                // header with relation types and program class, entry points, and strata units
+                std::vector<std::stringstream> units(numSplitUnits);
+                std::ofstream hs{baseFilename + ".h"};
+                std::ofstream os{sourceFilename};
+                synthesiser->generateCode(
+                        hs, os, units, baseName(baseFilename) + ".h", baseIdentifier, withSharedLibrary);
+                for (size_t i = 0; i < units.size(); i++) {
+                    std::string unitFilename = baseFilename + "_" + std::to_string(i) + ".cpp";
+                    std::ofstream{unitFilename} << units[i].rdbuf();
+                    sourceFilename += " " + unitFilename;
+                }
+            } else {
                 std::ofstream os{sourceFilename};
                 synthesiser->generateCode(os, baseIdentifier, withSharedLibrary);
             }
@@ -713,7 +952,14 @@ int main(int argc, char** argv) {
                 compileToBinary(compileCmd, sourceFilename);
             } else if (Global::config().has("compile")) {
                 auto start = std::chrono::high_resolution_clock::now();
-                compileToBinary(findCompileCmd(), sourceFilename);
+                auto compileCmd = findCompileCmd();
+                if (Global::config().has("precompiled-header")) {
+                    compileCmd += " -H";
+                }
+                if (Global::config().has("compile-cache")) {
+                    compileCmd += " -C " + shellQuote(Global::config().get("compile-cache"));
+                }
+                compileToBinary(compileCmd, sourceFilename);
                 /* Report overall run-time in verbose mode */
                 if (Global::config().has("verbose")) {
                     auto end = std::chrono::high_resolution_clock::now();
@@ -722,7 +968,7 @@ int main(int argc, char** argv) {
                 }
                 // run compiled C++ program if requested.
                 if (!Global::config().has("dl-program") && !Global::config().has("swig")) {
-                    executeBinary(baseFilename);
+                    executeBinary(baseFilename, numSplitUnits);
                 }
             }
         }
@@ -0,0 +1,105 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Adaptive.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Expression.h"
+#include "ram/ListStatement.h"
+#include "ram/Node.h"
+#include "ram/Statement.h"
+#include "ram/utility/NodeMapper.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
+#include <cassert>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+/**
+ * @class Adaptive
+ * @brief Alternative statements chosen at runtime by their estimated cost
+ *
+ * Each alternative statement has a cost expression. The cost expressions
+ * are evaluated every time the statement is executed, and only the
+ * alternative with the least cost is executed. Ties are broken in favour
+ * of the earlier alternative.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * ADAPTIVE
+ *  ALTERNATIVE (SIZE(@delta_A))
+ *   QUERY
+ *    ...
+ *  ALTERNATIVE (SIZE(B))
+ *   QUERY
+ *    ...
+ * END ADAPTIVE
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class Adaptive : public ListStatement {
+public:
+    Adaptive(VecOwn<Expression> costs, VecOwn<Statement> alternatives)
+            : ListStatement(std::move(alternatives)), costs(std::move(costs)) {
+        assert(allValidPtrs(this->costs) && "cost is a nullptr");
+        assert(this->costs.size() == statements.size() && "each alternative requires a cost");
+    }
+
+    /** @brief Get cost expressions of the alternatives */
+    std::vector<Expression*> getCosts() const {
+        return toPtrVector(costs);
+    }
+
+    std::vector<const Node*> getChildNodes() const override {
+        std::vector<const Node*> res = ListStatement::getChildNodes();
+        for (const auto& cost : costs) {
+            res.push_back(cost.get());
+        }
+        return res;
+    }
+
+    Adaptive* clone() const override {
+        return new Adaptive(souffle::clone(costs), souffle::clone(statements));
+    }
+
+    void apply(const NodeMapper& map) override {
+        ListStatement::apply(map);
+        for (auto& cost : costs) {
+            cost = map(std::move(cost));
+        }
+    }
+
+protected:
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos) << "ADAPTIVE" << std::endl;
+        for (size_t i = 0; i < statements.size(); i++) {
+            os << times(" ", tabpos + 1) << "ALTERNATIVE (" << *costs[i] << ")" << std::endl;
+            Statement::print(statements[i].get(), os, tabpos + 2);
+        }
+        os << times(" ", tabpos) << "END ADAPTIVE" << std::endl;
+    }
+
+    bool equal(const Node& node) const override {
+        const auto& other = asAssert<Adaptive>(node);
+        return ListStatement::equal(other) && equal_targets(costs, other.costs);
+    }
+
+    /** Cost expressions of the alternatives */
+    VecOwn<Expression> costs;
+};
+
+}  // namespace souffle::ram
@@ -0,0 +1,113 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Dataflow.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/ListStatement.h"
+#include "ram/Node.h"
+#include "ram/Statement.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+/**
+ * @class Dataflow
+ * @brief Steps executed as soon as the steps they depend on have finished
+ *
+ * Each step lists the earlier steps that have to finish before it starts.
+ * Steps that do not depend on each other may execute concurrently, at most
+ * `concurrencyLimit` of them at a time. The limit only bounds the number of running
+ * steps, not the memory they use. Executing the steps in their order is always a
+ * valid schedule.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * DATAFLOW (2)
+ *  STEP 0
+ *   CALL stratum_0
+ *  STEP 1
+ *   CALL stratum_1
+ *  STEP 2 AFTER (0,1)
+ *   CALL stratum_2
+ *  STEP 3 AFTER (2)
+ *   CLEAR A
+ * END DATAFLOW
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class Dataflow : public ListStatement {
+public:
+    Dataflow(VecOwn<Statement> steps, std::vector<std::vector<std::size_t>> predecessors,
+            std::size_t concurrencyLimit)
+            : ListStatement(std::move(steps)), predecessors(std::move(predecessors)),
+              concurrencyLimit(concurrencyLimit) {
+        assert(allValidPtrs(statements) && "step is a nullptr");
+        assert(this->predecessors.size() == statements.size() && "each step requires its predecessors");
+        assert(concurrencyLimit > 0 && "concurrencyLimit must be positive");
+        for (std::size_t i = 0; i < this->predecessors.size(); i++) {
+            for (std::size_t pred : this->predecessors[i]) {
+                assert(pred < i && "a step may only depend on earlier steps");
+            }
+        }
+    }
+
+    /** @brief Get the steps that have to finish before each step */
+    const std::vector<std::vector<std::size_t>>& getPredecessors() const {
+        return predecessors;
+    }
+
+    /** @brief Get the maximal number of concurrently executing steps */
+    std::size_t getConcurrencyLimit() const {
+        return concurrencyLimit;
+    }
+
+    Dataflow* clone() const override {
+        return new Dataflow(souffle::clone(statements), predecessors, concurrencyLimit);
+    }
+
+protected:
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos) << "DATAFLOW (" << concurrencyLimit << ")" << std::endl;
+        for (std::size_t i = 0; i < statements.size(); i++) {
+            os << times(" ", tabpos + 1) << "STEP " << i;
+            if (!predecessors[i].empty()) {
+                os << " AFTER (" << join(predecessors[i], ",") << ")";
+            }
+            os << std::endl;
+            Statement::print(statements[i].get(), os, tabpos + 2);
+        }
+        os << times(" ", tabpos) << "END DATAFLOW" << std::endl;
+    }
+
+    bool equal(const Node& node) const override {
+        const auto& other = asAssert<Dataflow>(node);
+        return ListStatement::equal(other) && predecessors == other.predecessors &&
+               concurrencyLimit == other.concurrencyLimit;
+    }
+
+    /** Steps that have to finish before each step */
+    std::vector<std::vector<std::size_t>> predecessors;
+
+    /** Maximal number of concurrently executing steps */
+    std::size_t concurrencyLimit;
+};
+
+}  // namespace souffle::ram
@@ -0,0 +1,92 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Facts.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Node.h"
+#include "ram/RelationStatement.h"
+#include "souffle/RamTypes.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StreamUtil.h"
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram {
+
+/**
+ * @class Facts
+ * @brief Insert a table of constant tuples into a relation
+ *
+ * The facts of a relation whose arguments are all constants are inserted at once,
+ * rather than by a query per fact. The tuples are stored row by row.
+ *
+ * For example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * FACTS A
+ *  (1,2)
+ *  (3,4)
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class Facts : public RelationStatement {
+public:
+    Facts(std::string rel, std::size_t arity, std::vector<RamDomain> values)
+            : RelationStatement(rel), arity(arity), values(std::move(values)) {
+        assert(arity > 0 && this->values.size() % arity == 0 && "values do not form tuples");
+    }
+
+    /** @brief Get the number of values of a tuple */
+    std::size_t getArity() const {
+        return arity;
+    }
+
+    /** @brief Get the values of all tuples, row by row */
+    const std::vector<RamDomain>& getValues() const {
+        return values;
+    }
+
+    /** @brief Get the number of tuples */
+    std::size_t size() const {
+        return values.size() / arity;
+    }
+
+    Facts* clone() const override {
+        return new Facts(relation, arity, values);
+    }
+
+protected:
+    void print(std::ostream& os, int tabpos) const override {
+        os << times(" ", tabpos) << "FACTS " << relation << std::endl;
+        for (std::size_t i = 0; i < values.size(); i += arity) {
+            os << times(" ", tabpos + 1) << "("
+               << join(values.begin() + i, values.begin() + i + arity, ",") << ")" << std::endl;
+        }
+    }
+
+    bool equal(const Node& node) const override {
+        const auto& other = asAssert<Facts>(node);
+        return RelationStatement::equal(other) && arity == other.arity && values == other.values;
+    }
+
+    /** Number of values of a tuple */
+    const std::size_t arity;
+
+    /** Values of the tuples */
+    const std::vector<RamDomain> values;
+};
+
+}  // namespace souffle::ram
@@ -86,9 +86,15 @@ public:
         return result;
     }
 
-    /** @brief Invalidate all alive analyses of the translation unit */
+    /** @brief Invalidate all alive analyses of the translation unit that depend on the program */
     void invalidateAnalyses() {
-        analyses.clear();
+        for (auto it = analyses.begin(); it != analyses.end();) {
+            if (it->second->isProgramDependent()) {
+                it = analyses.erase(it);
+            } else {
+                ++it;
+            }
+        }
     }
 
     /** @brief Get the RAM Program of the translation unit  */
@@ -42,6 +42,11 @@ public:
     /** @brief Run analysis for a RAM translation unit */
     virtual void run(const TranslationUnit& translationUnit) = 0;
 
+    /** @brief Whether the analysis result depends on the RAM program, i.e., is invalidated by transformers */
+    virtual bool isProgramDependent() const {
+        return true;
+    }
+
     /** @brief Print the analysis result in HTML format */
     virtual void print(std::ostream& /* os */) const {}
 
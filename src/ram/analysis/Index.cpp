@@ -18,16 +18,19 @@
 #include "Global.h"
 #include "RelationTag.h"
 #include "ram/Expression.h"
+#include "ram/IndexOperation.h"
 #include "ram/Node.h"
 #include "ram/Program.h"
 #include "ram/Relation.h"
 #include "ram/Swap.h"
 #include "ram/TranslationUnit.h"
+#include "ram/analysis/ProfileUse.h"
 #include "ram/analysis/Relation.h"
 #include "ram/utility/Utils.h"
 #include "ram/utility/Visitor.h"
 #include "souffle/utility/StreamUtil.h"
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
@@ -397,10 +400,13 @@ void IndexAnalysis::run(const TranslationUnit& translationUnit) {
             relationToSearches[indexSearch->getRelation()].insert(getSearchSignature(indexSearch));
         } else if (const auto* exists = as<ExistenceCheck>(node)) {
             relationToSearches[exists->getRelation()].insert(getSearchSignature(exists));
+            fixedSearches[exists->getRelation()].insert(getSearchSignature(exists));
         } else if (const auto* provExists = as<ProvenanceExistenceCheck>(node)) {
             relationToSearches[provExists->getRelation()].insert(getSearchSignature(provExists));
+            fixedSearches[provExists->getRelation()].insert(getSearchSignature(provExists));
         } else if (const auto* ramRel = as<Relation>(node)) {
             relationToSearches[ramRel->getName()].insert(getSearchSignature(ramRel));
+            fixedSearches[ramRel->getName()].insert(getSearchSignature(ramRel));
         }
     });
 
@@ -420,6 +426,15 @@ void IndexAnalysis::run(const TranslationUnit& translationUnit) {
 
         relationToSearches[relA].insert(searchesB.begin(), searchesB.end());
         relationToSearches[relB].insert(searchesA.begin(), searchesA.end());
+
+        const auto fixedA = fixedSearches[relA];
+        const auto fixedB = fixedSearches[relB];
+
+        fixedSearches[relA].insert(fixedB.begin(), fixedB.end());
+        fixedSearches[relB].insert(fixedA.begin(), fixedA.end());
+
+        swapPartners[relA] = relB;
+        swapPartners[relB] = relA;
     });
 
     // remove all empty searches
@@ -434,6 +449,24 @@ void IndexAnalysis::run(const TranslationUnit& translationUnit) {
         }
     }
 
+    // relax searches whose indexes are not worth maintaining according to the profile
+    if (Global::config().has("profile-use")) {
+        loadProfile(translationUnit);
+        for (auto& relToSearch : relationToSearches) {
+            const std::string& relation = relToSearch.first;
+            auto partner = swapPartners.find(relation);
+            if (partner != swapPartners.end() && relaxations.count(partner->second) > 0) {
+                // swapped relations must keep the same indexes
+                relaxations[relation] = relaxations[partner->second];
+                for (const auto& relaxed : relaxations[relation]) {
+                    relToSearch.second.erase(relaxed.first);
+                }
+            } else {
+                relaxSearches(relation, relToSearch.second);
+            }
+        }
+    }
+
     // find optimal indexes for relations
     for (auto& relToSearch : relationToSearches) {
         const std::string& relation = relToSearch.first;
@@ -442,6 +475,212 @@ void IndexAnalysis::run(const TranslationUnit& translationUnit) {
     }
 }
 
+namespace {
+/** number of constrained attributes of a search */
+size_t countConstraints(const SearchSignature& search) {
+    return std::count_if(
+            search.begin(), search.end(), [](auto c) { return c != AttributeConstraint::None; });
+}
+
+/** cost of a lookup with the given number of bound attributes of the index prefix */
+double lookupCost(double size, size_t arity, size_t bound) {
+    // the scanned range shrinks geometrically with every bound attribute of the prefix
+    double scanned = arity == 0 ? 1.0 : std::pow(size, 1.0 - static_cast<double>(bound) / arity);
+    return std::log2(size + 1) + scanned;
+}
+
+/** cost of maintaining an index, i.e., inserting each tuple once and storing a copy of it */
+double maintenanceCost(double size, size_t arity) {
+    return size * (std::log2(size + 1) + arity);
+}
+}  // namespace
+
+void IndexAnalysis::loadProfile(const TranslationUnit& translationUnit) {
+    // the profile is read once per translation unit, this analysis is recomputed after each transformer
+    const auto* profile = translationUnit.getAnalysis<ProfileUseAnalysis>();
+    const auto& sizes = profile->getRelationSizes();
+    const auto& frequencies = profile->getSearchFrequencies();
+    const auto& distinct = profile->getDistinctValues();
+
+    for (const auto& relToSearch : relationToSearches) {
+        const std::string& relName = relToSearch.first;
+        const Relation& rel = relAnalysis->lookup(relName);
+
+        // auxiliary relations of the semi-naive evaluation are profiled under their base relation
+        std::string baseName = relName;
+        for (const std::string prefix : {"@delta_", "@new_"}) {
+            if (baseName.compare(0, prefix.size(), prefix) == 0) {
+                baseName = baseName.substr(prefix.size());
+            }
+        }
+        auto size = sizes.find(baseName);
+        if (size != sizes.end()) {
+            relationSizes[relName] = size->second;
+        }
+        auto columns = distinct.find(baseName);
+        if (columns != distinct.end() && columns->second.size() == rel.getArity()) {
+            distinctValues[relName] = columns->second;
+        }
+
+        auto freqs = frequencies.find(relName);
+        if (freqs == frequencies.end()) {
+            continue;
+        }
+        for (const auto& freq : freqs->second) {
+            if (freq.first.size() != rel.getArity()) {
+                continue;
+            }
+            SearchSignature search(rel.getArity());
+            for (size_t i = 0; i < rel.getArity(); i++) {
+                search[i] = static_cast<AttributeConstraint>(freq.first[i] - '0');
+            }
+            searchFrequencies[relName][search] += freq.second;
+        }
+    }
+}
+
+void IndexAnalysis::relaxSearches(const std::string& relName, SearchSet& searches) {
+    if (relationSizes.count(relName) == 0 || searches.empty()) {
+        return;
+    }
+    const Relation& rel = relAnalysis->lookup(relName);
+    const size_t arity = rel.getArity();
+    const double size = relationSizes[relName];
+
+    // frequencies of the searches, including those of a swapped relation sharing the indexes
+    auto profiled = [&](const SearchSignature& search, double& freq) {
+        bool found = false;
+        freq = 0;
+        for (const auto& name : {relName, swapPartners.count(relName) > 0 ? swapPartners[relName] : ""}) {
+            auto freqs = searchFrequencies.find(name);
+            if (freqs != searchFrequencies.end() && freqs->second.count(search) > 0) {
+                freq += freqs->second.at(search);
+                found = true;
+            }
+        }
+        return found;
+    };
+    auto frequency = [&](const SearchSignature& search) {
+        double freq;
+        profiled(search, freq);
+        return freq;
+    };
+
+    // can the search be answered by the index prefix of the weaker search plus a filter
+    auto answers = [](const SearchSignature& weaker, const SearchSignature& search) {
+        for (size_t i = 0; i < search.arity(); i++) {
+            if (weaker[i] == AttributeConstraint::Inequal) {
+                return false;
+            }
+            if (weaker[i] == AttributeConstraint::Equal && search[i] != AttributeConstraint::Equal) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const SearchSet& fixed = fixedSearches[relName];
+    SignatureMap& relaxed = relaxations[relName];
+    bool changed = true;
+    while (changed && searches.size() > 1) {
+        changed = false;
+        IndexCluster cluster = solver->solve(searches);
+
+        // try to drop the index of the coldest chain first
+        std::vector<std::pair<double, LexOrder>> orders;
+        for (const auto& order : cluster.getAllOrders()) {
+            double freq = 0;
+            for (const auto& search : searches) {
+                if (cluster.getLexOrder(search) == order) {
+                    freq += frequency(search);
+                }
+            }
+            orders.emplace_back(freq, order);
+        }
+        std::sort(orders.begin(), orders.end());
+
+        for (const auto& candidate : orders) {
+            SearchSet chain;
+            SearchSet remaining;
+            for (const auto& search : searches) {
+                (cluster.getLexOrder(search) == candidate.second ? chain : remaining).insert(search);
+            }
+
+            // existence checks, searches with inequalities, and searches missing in the profile keep
+            // their index
+            bool relaxable = std::none_of(chain.begin(), chain.end(), [&](const SearchSignature& search) {
+                double freq;
+                return fixed.count(search) > 0 || !profiled(search, freq) ||
+                       std::find(search.begin(), search.end(), AttributeConstraint::Inequal) != search.end();
+            });
+            if (!relaxable) {
+                continue;
+            }
+
+            // map each search of the chain to the strongest remaining search answering it
+            SignatureMap replacement;
+            double extraCost = 0;
+            for (const auto& search : chain) {
+                SearchSignature best(arity);
+                for (const auto& other : remaining) {
+                    if (answers(other, search) && countConstraints(other) > countConstraints(best)) {
+                        best = other;
+                    }
+                }
+                replacement.insert({search, best});
+                extraCost += frequency(search) * (estimateLookupCost(relName, best) -
+                                                         estimateLookupCost(relName, search));
+            }
+
+            if (extraCost < maintenanceCost(size, arity)) {
+                for (auto& cur : relaxed) {
+                    if (replacement.count(cur.second) > 0) {
+                        cur.second = replacement.at(cur.second);
+                    }
+                }
+                relaxed.insert(replacement.begin(), replacement.end());
+                searches = remaining;
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+std::pair<double, double> IndexAnalysis::projectCost(
+        const std::string& relName, const IndexCluster& cluster) const {
+    auto size = relationSizes.find(relName);
+    auto freqs = searchFrequencies.find(relName);
+    if (size == relationSizes.end() || freqs == searchFrequencies.end()) {
+        return {0, 0};
+    }
+    const size_t arity = relAnalysis->lookup(relName).getArity();
+    double lookups = 0;
+    for (const auto& freq : freqs->second) {
+        lookups += freq.second * estimateLookupCost(relName, getRelaxedSearch(relName, freq.first));
+    }
+    return {lookups, cluster.getAllOrders().size() * maintenanceCost(size->second, arity)};
+}
+
+double IndexAnalysis::estimateLookupCost(const std::string& relName, const SearchSignature& search) const {
+    const double size = relationSizes.at(relName);
+    auto columns = distinctValues.find(relName);
+    if (columns == distinctValues.end()) {
+        return lookupCost(size, search.arity(), countConstraints(search));
+    }
+
+    // the columns bound by equalities select one of their distinct combinations of values,
+    // assuming that the columns are independent
+    double distinct = 1;
+    for (size_t i = 0; i < search.arity(); i++) {
+        if (search[i] == AttributeConstraint::Equal) {
+            distinct *= std::max<size_t>(columns->second[i], 1);
+        }
+    }
+    distinct = std::min(distinct, std::max(size, 1.0));
+    return std::log2(size + 1) + size / distinct;
+}
+
 void IndexAnalysis::print(std::ostream& os) const {
     for (auto& cur : indexCover) {
         const std::string& relName = cur.first;
@@ -464,6 +703,21 @@ void IndexAnalysis::print(std::ostream& os) const {
             os << join(order, "<") << "\n";
             os << "\n";
         }
+
+        /* print profile-guided selection */
+        if (searchFrequencies.count(relName) > 0) {
+            os << "\tProfiled Searches:\n";
+            for (auto& freq : searchFrequencies.at(relName)) {
+                os << "\t\t" << freq.first << " executed " << freq.second << " times";
+                if (getRelaxedSearch(relName, freq.first) != freq.first) {
+                    os << ", relaxed to " << getRelaxedSearch(relName, freq.first);
+                }
+                os << "\n";
+            }
+            auto cost = projectCost(relName, selection);
+            os << "\tProjected Cost: lookups " << cost.first << ", index maintenance " << cost.second
+               << "\n";
+        }
     }
 }
 
@@ -535,10 +535,73 @@ public:
      */
     bool isTotalSignature(const AbstractExistenceCheck* existCheck) const;
 
+    /**
+     * @Brief Get the search answering a search of a relation under profile-guided index selection
+     * @param relName relation name
+     * @param search search signature of an index operation
+     * @result the search itself, or a weaker search that shares the index of another search
+     *
+     * With --profile-use, a search may be relaxed if the index it needs costs more to maintain
+     * than the scans it saves; the remaining constraints must then be checked by a filter.
+     */
+    SearchSignature getRelaxedSearch(const std::string& relName, const SearchSignature& search) const {
+        auto rel = relaxations.find(relName);
+        if (rel != relaxations.end()) {
+            auto it = rel->second.find(search);
+            if (it != rel->second.end()) {
+                return it->second;
+            }
+        }
+        return search;
+    }
+
 private:
+    /**
+     * @Brief Load the profiled search frequencies and relation sizes of --profile-use
+     * @param translationUnit translation unit holding the profile
+     */
+    void loadProfile(const TranslationUnit& translationUnit);
+
+    /**
+     * @Brief Relax cold searches of a relation whose indexes are not worth maintaining
+     * @param relName relation name
+     * @param searches searches of the relation, the relaxed searches are removed
+     */
+    void relaxSearches(const std::string& relName, SearchSet& searches);
+
+    /**
+     * @Brief Projected cost of answering the profiled searches of a relation with an index cover
+     * @result pair of lookup cost and index maintenance cost
+     */
+    std::pair<double, double> projectCost(const std::string& relName, const IndexCluster& cluster) const;
+
+    /**
+     * @Brief Estimated cost of a lookup in a relation, using the profiled column statistics if any
+     */
+    double estimateLookupCost(const std::string& relName, const SearchSignature& search) const;
+
     /** relation analysis for looking up relations by name */
     RelationAnalysis* relAnalysis;
 
+    /** profiled number of executions of each search of a relation */
+    std::map<std::string, std::unordered_map<SearchSignature, size_t, SearchSignature::Hasher>>
+            searchFrequencies;
+
+    /** profiled relation sizes */
+    std::map<std::string, size_t> relationSizes;
+
+    /** profiled number of distinct values of each column of a relation */
+    std::map<std::string, std::vector<size_t>> distinctValues;
+
+    /** searches that have been relaxed, i.e., maps a search to the search answering it */
+    std::map<std::string, SignatureMap> relaxations;
+
+    /** searches that cannot be relaxed, i.e., existence checks and total-order searches */
+    std::map<std::string, SearchSet> fixedSearches;
+
+    /** relations whose indexes are swapped with another relation */
+    std::map<std::string, std::string> swapPartners;
+
     /**
      * minimal index cover for relations, i.e., maps a relation to a set of indexes
      */
@@ -0,0 +1,71 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProfileUse.cpp
+ *
+ * Analysis loading the profile of --profile-use for the RAM translation unit
+ *
+ ***********************************************************************/
+
+#include "ram/analysis/ProfileUse.h"
+#include "Global.h"
+#include "ram/TranslationUnit.h"
+#include "souffle/profile/ProfileDatabase.h"
+#include "souffle/profile/ProfileEvent.h"
+#include "souffle/profile/ProgramRun.h"
+#include "souffle/profile/Reader.h"
+#include "souffle/profile/Relation.h"
+#include "souffle/utility/MiscUtil.h"
+#include <memory>
+
+namespace souffle::ram::analysis {
+
+void ProfileUseAnalysis::run(const TranslationUnit&) {
+    if (!Global::config().has("profile-use")) {
+        return;
+    }
+    auto run = std::make_shared<profile::ProgramRun>(profile::ProgramRun());
+    profile::Reader(Global::config().get("profile-use"), run).processFile();
+    for (const auto& rel : run->getRelationMap()) {
+        sizes[rel.first] = rel.second->size();
+    }
+
+    const auto& db = ProfileEventSingleton::instance().getDB();
+    if (const auto* dir = as<profile::DirectoryEntry>(db.lookupEntry({"program", "searches"}))) {
+        for (const auto& relName : dir->getKeys()) {
+            const auto* relDir = as<profile::DirectoryEntry>(dir->readEntry(relName));
+            for (const auto& key : relDir->getKeys()) {
+                if (const auto* entry = as<profile::SizeEntry>(relDir->readEntry(key))) {
+                    frequencies[relName][key] = entry->getSize();
+                }
+            }
+        }
+    }
+    if (const auto* dir = as<profile::DirectoryEntry>(db.lookupEntry({"program", "statistics"}))) {
+        for (const auto& relName : dir->getKeys()) {
+            auto& columns = distinct[relName];
+            auto column = [&](size_t i) {
+                return as<profile::SizeEntry>(
+                        db.lookupEntry({"program", "statistics", relName, "column", std::to_string(i)}));
+            };
+            while (const auto* entry = column(columns.size())) {
+                columns.push_back(entry->getSize());
+            }
+        }
+    }
+}
+
+void ProfileUseAnalysis::print(std::ostream& os) const {
+    for (const auto& size : sizes) {
+        os << size.first << ": " << size.second << " tuples\n";
+    }
+}
+
+}  // namespace souffle::ram::analysis
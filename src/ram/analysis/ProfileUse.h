@@ -0,0 +1,81 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProfileUse.h
+ *
+ * Analysis loading the profile of --profile-use for the RAM translation unit
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/analysis/Analysis.h"
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace souffle::ram {
+class TranslationUnit;
+
+namespace analysis {
+
+/**
+ * @class ProfileUseAnalysis
+ * @brief Analysis holding the relation sizes, search frequencies and column statistics of a profile
+ *
+ * The profile is read from a file and does not depend on the RAM program, hence the
+ * analysis is kept when the other analyses are invalidated by a transformer, and the
+ * profile is only read once per translation unit.
+ */
+class ProfileUseAnalysis : public Analysis {
+public:
+    ProfileUseAnalysis(const char* id) : Analysis(id) {}
+
+    static constexpr const char* name = "profile-use";
+
+    void run(const TranslationUnit& translationUnit) override;
+
+    void print(std::ostream& os) const override;
+
+    /** The profile is read from a file, not the program */
+    bool isProgramDependent() const override {
+        return false;
+    }
+
+    /** @brief Get the profiled relation sizes */
+    const std::map<std::string, size_t>& getRelationSizes() const {
+        return sizes;
+    }
+
+    /** @brief Get the profiled number of executions of each search, encoded as a string, of a relation */
+    const std::map<std::string, std::map<std::string, size_t>>& getSearchFrequencies() const {
+        return frequencies;
+    }
+
+    /** @brief Get the profiled number of distinct values of each column of a relation */
+    const std::map<std::string, std::vector<size_t>>& getDistinctValues() const {
+        return distinct;
+    }
+
+private:
+    /** profiled relation sizes */
+    std::map<std::string, size_t> sizes;
+
+    /** profiled number of executions of each search of a relation */
+    std::map<std::string, std::map<std::string, size_t>> frequencies;
+
+    /** profiled number of distinct values of each column of a relation */
+    std::map<std::string, std::vector<size_t>> distinct;
+};
+
+}  // namespace analysis
+}  // namespace souffle::ram
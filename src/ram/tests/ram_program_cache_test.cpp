@@ -0,0 +1,306 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ram_program_cache_test.cpp
+ *
+ * Tests the binary form of RAM programs used by the program cache.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "AggregateOp.h"
+#include "FunctorOps.h"
+#include "Global.h"
+#include "RelationTag.h"
+#include "ram/Adaptive.h"
+#include "ram/Aggregate.h"
+#include "ram/AutoIncrement.h"
+#include "ram/Break.h"
+#include "ram/Call.h"
+#include "ram/Clear.h"
+#include "ram/Conjunction.h"
+#include "ram/Constraint.h"
+#include "ram/Dataflow.h"
+#include "ram/DebugInfo.h"
+#include "ram/EmptinessCheck.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/Exit.h"
+#include "ram/Extend.h"
+#include "ram/Facts.h"
+#include "ram/Filter.h"
+#include "ram/FloatConstant.h"
+#include "ram/GuardedProject.h"
+#include "ram/IO.h"
+#include "ram/IndexAggregate.h"
+#include "ram/IndexScan.h"
+#include "ram/IntrinsicOperator.h"
+#include "ram/LogRelationTimer.h"
+#include "ram/LogSize.h"
+#include "ram/Loop.h"
+#include "ram/Negation.h"
+#include "ram/NestedIntrinsicOperator.h"
+#include "ram/PackRecord.h"
+#include "ram/Parallel.h"
+#include "ram/ParallelChoice.h"
+#include "ram/Program.h"
+#include "ram/Project.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/RelationSize.h"
+#include "ram/Scan.h"
+#include "ram/Sequence.h"
+#include "ram/SignedConstant.h"
+#include "ram/SubroutineArgument.h"
+#include "ram/SubroutineReturn.h"
+#include "ram/Swap.h"
+#include "ram/True.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/UnpackRecord.h"
+#include "ram/UnsignedConstant.h"
+#include "ram/UserDefinedOperator.h"
+#include "ram/utility/ProgramCache.h"
+#include "reports/DebugReport.h"
+#include "reports/ErrorReport.h"
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/TypeAttribute.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace souffle::ram::test {
+
+namespace {
+
+Own<Program> makeProgram() {
+    VecOwn<Relation> relations;
+    relations.push_back(mk<Relation>("A", 2, 0, std::vector<std::string>{"x", "y"},
+            std::vector<std::string>{"i:number", "i:number"}, RelationRepresentation::DEFAULT));
+    relations.push_back(mk<Relation>("B", 1, 0, std::vector<std::string>{"x"},
+            std::vector<std::string>{"s:symbol"}, RelationRepresentation::BTREE));
+    relations.push_back(mk<Relation>("@new_A", 2, 0, std::vector<std::string>{"x", "y"},
+            std::vector<std::string>{"i:number", "i:number"}, RelationRepresentation::DEFAULT));
+
+    // FOR t0 IN A ON INDEX t0.0 = 1
+    //  IF (t0.1 < 3.5) AND NOT (A) ∈ ∅ AND (t0.0,⊥) ∈ A
+    //   t1 = COUNT FOR ALL t1 IN A WHERE t1.1 > t0.0
+    //    UNPACK t2 ARITY 2 FROM PACK(t0.0, 2u)
+    //     RANGE(0, t2.1) INTO t3
+    //      BREAK TRUE
+    //       INSERT (t3.0 + f(t1.0), @uniq) INTO @new_A
+    RamPattern pattern;
+    pattern.first.push_back(mk<SignedConstant>(1));
+    pattern.first.push_back(mk<UndefValue>());
+    pattern.second.push_back(mk<SignedConstant>(1));
+    pattern.second.push_back(mk<UndefValue>());
+    VecOwn<Expression> udfArgs;
+    udfArgs.push_back(mk<TupleElement>(1, 0));
+    VecOwn<Expression> addArgs;
+    addArgs.push_back(mk<TupleElement>(3, 0));
+    addArgs.push_back(mk<UserDefinedOperator>("f", std::vector<TypeAttribute>{TypeAttribute::Signed},
+            TypeAttribute::Signed, true, std::move(udfArgs)));
+    VecOwn<Expression> projected;
+    projected.push_back(mk<IntrinsicOperator>(FunctorOp::ADD, std::move(addArgs)));
+    projected.push_back(mk<AutoIncrement>());
+    VecOwn<Expression> rangeArgs;
+    rangeArgs.push_back(mk<SignedConstant>(0));
+    rangeArgs.push_back(mk<TupleElement>(2, 1));
+    VecOwn<Expression> recordArgs;
+    recordArgs.push_back(mk<TupleElement>(0, 0));
+    recordArgs.push_back(mk<UnsignedConstant>(2));
+    VecOwn<Expression> existenceArgs;
+    existenceArgs.push_back(mk<TupleElement>(0, 0));
+    existenceArgs.push_back(mk<UndefValue>());
+
+    auto project = mk<Project>("@new_A", std::move(projected));
+    auto breakOp = mk<Break>(mk<True>(), std::move(project), "break");
+    auto range = mk<NestedIntrinsicOperator>(
+            NestedIntrinsicOp::RANGE, std::move(rangeArgs), std::move(breakOp), 3);
+    auto unpack = mk<UnpackRecord>(std::move(range), 2, mk<PackRecord>(std::move(recordArgs)), 2);
+    auto count = mk<Aggregate>(std::move(unpack), AggregateOp::COUNT, "A", mk<UndefValue>(),
+            mk<Constraint>(BinaryConstraintOp::GT, mk<TupleElement>(1, 1), mk<TupleElement>(0, 0)), 1);
+    auto lessThan = mk<Constraint>(BinaryConstraintOp::FLT, mk<TupleElement>(0, 1), mk<FloatConstant>(3.5));
+    auto cond = mk<Conjunction>(mk<Conjunction>(std::move(lessThan), mk<Negation>(mk<EmptinessCheck>("A"))),
+            mk<ExistenceCheck>("A", std::move(existenceArgs)));
+    auto filter = mk<Filter>(std::move(cond), std::move(count), "filter");
+    auto scan = mk<IndexScan>("A", 0, std::move(pattern), std::move(filter), "scan A");
+
+    // t0 = MAX t0.0 FOR ALL t0 IN A ON INDEX t0.0 = arg(0), RETURN (t0.0, number(-1))
+    RamPattern aggPattern;
+    aggPattern.first.push_back(mk<SubroutineArgument>(0));
+    aggPattern.first.push_back(mk<UndefValue>());
+    aggPattern.second.push_back(mk<SubroutineArgument>(0));
+    aggPattern.second.push_back(mk<UndefValue>());
+    VecOwn<Expression> returned;
+    returned.push_back(mk<TupleElement>(0, 0));
+    returned.push_back(mk<SignedConstant>(-1));
+    auto subroutine = mk<Query>(mk<IndexAggregate>(mk<SubroutineReturn>(std::move(returned)),
+            AggregateOp::MAX, "A", mk<TupleElement>(0, 0), mk<True>(), std::move(aggPattern), 0));
+
+    // a choice on B, guarded insertion of symbols
+    VecOwn<Expression> guarded;
+    guarded.push_back(mk<TupleElement>(0, 0));
+    auto choice = mk<ParallelChoice>("B", 0,
+            mk<Constraint>(BinaryConstraintOp::EQ, mk<TupleElement>(0, 0), mk<SignedConstant>(1)),
+            mk<GuardedProject>("B", std::move(guarded), mk<True>()), "choice");
+
+    VecOwn<Expression> costs;
+    costs.push_back(mk<RelationSize>("A"));
+    costs.push_back(mk<RelationSize>("B"));
+    VecOwn<Statement> alternatives;
+    alternatives.push_back(mk<Query>(std::move(scan)));
+    alternatives.push_back(mk<Query>(mk<Scan>("B", 0, mk<SubroutineReturn>(VecOwn<Expression>()), "")));
+
+    VecOwn<Statement> steps;
+    steps.push_back(mk<Clear>("@new_A"));
+    steps.push_back(mk<Call>("sub"));
+    steps.push_back(mk<Query>(std::move(choice)));
+    std::vector<std::vector<std::size_t>> predecessors = {{}, {0}, {0, 1}};
+
+    auto loop = mk<Loop>(mk<Sequence>(mk<Adaptive>(std::move(costs), std::move(alternatives)),
+            mk<Exit>(mk<EmptinessCheck>("@new_A")), mk<Extend>("A", "@new_A"), mk<Swap>("A", "@new_A")));
+
+    auto main = mk<Sequence>(mk<IO>("A", std::map<std::string, std::string>{{"operation", "input"}}),
+            mk<Facts>("B", 1, std::vector<RamDomain>{0, 1, 2}),
+            mk<LogRelationTimer>(std::move(loop), "@t-recursive;A", "A"), mk<LogSize>("A", "@n-A"),
+            mk<DebugInfo>(mk<Parallel>(mk<Dataflow>(std::move(steps), std::move(predecessors), 2)), "info"));
+
+    std::map<std::string, Own<Statement>> subroutines;
+    subroutines["sub"] = std::move(subroutine);
+    return mk<Program>(std::move(relations), std::move(main), std::move(subroutines));
+}
+
+/** Check whether reading the given binary form fails */
+bool isRejected(const std::string& data) {
+    std::stringstream ss(data);
+    try {
+        ProgramCache::read(ss);
+    } catch (std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(ProgramCache, RoundTrip) {
+    auto program = makeProgram();
+    SymbolTable symbolTable;
+    symbolTable.insert(std::vector<std::string>{"a", "", "a longer symbol\nwith a line break"});
+
+    std::stringstream ss;
+    ProgramCache::write(ss, *program, symbolTable);
+    auto [readProgram, readSymbolTable] = ProgramCache::read(ss);
+
+    EXPECT_EQ(*program, *readProgram);
+    EXPECT_EQ(toString(*program), toString(*readProgram));
+    EXPECT_EQ(symbolTable.size(), readSymbolTable.size());
+    for (std::size_t i = 0; i < symbolTable.size(); i++) {
+        EXPECT_EQ(symbolTable.resolve(i), readSymbolTable.resolve(i));
+    }
+}
+
+TEST(ProgramCache, Malformed) {
+    auto program = makeProgram();
+    std::stringstream ss;
+    ProgramCache::write(ss, *program, SymbolTable());
+    const std::string data = ss.str();
+
+    // every truncation of the program is rejected
+    bool truncationsRejected = true;
+    for (std::size_t size = 0; size < data.size(); size++) {
+        truncationsRejected = truncationsRejected && isRejected(data.substr(0, size));
+    }
+    EXPECT_TRUE(truncationsRejected);
+    EXPECT_FALSE(isRejected(data));
+
+    // as is an unknown kind of node
+    std::string corrupted = data;
+    corrupted[sizeof(std::uint64_t) * 2] = char(0xff);
+    EXPECT_TRUE(isRejected(corrupted));
+}
+
+TEST(ProgramCache, Entries) {
+    char directory[] = "/tmp/souffle-ram-cache-XXXXXX";
+    EXPECT_TRUE(::mkdtemp(directory) != nullptr);
+    const std::string profile = std::string(directory) + "/profile.log";
+    std::ofstream(profile) << "a";
+
+    ErrorReport errorReport;
+    DebugReport debugReport;
+    auto isCached = [&](const std::string& source) {
+        return ProgramCache(directory, source).load(errorReport, debugReport) != nullptr;
+    };
+    auto store = [&](const std::string& source) {
+        TranslationUnit translationUnit(makeProgram(), SymbolTable(), errorReport, debugReport);
+        ProgramCache(directory, source).store(translationUnit);
+    };
+
+    // the key covers the contents of the profile
+    Global::config().set("profile-use", profile);
+    store("source");
+    EXPECT_TRUE(isCached("source"));
+    EXPECT_FALSE(isCached("other source"));
+    std::ofstream(profile) << "b";
+    EXPECT_FALSE(isCached("source"));
+    std::ofstream(profile) << "a";
+    EXPECT_TRUE(isCached("source"));
+    const std::string profiled = ProgramCache(directory, "source").getFilename();
+
+    // a profile named by a pragma is checked on load
+    Global::config().unset("profile-use");
+    ProgramCache pragmaCache(directory, "pragma");
+    Global::config().set("profile-use", profile);
+    TranslationUnit translationUnit(makeProgram(), SymbolTable(), errorReport, debugReport);
+    pragmaCache.store(translationUnit);
+    Global::config().unset("profile-use");
+    EXPECT_TRUE(isCached("pragma"));
+    // loading restores the option set by the pragma
+    EXPECT_TRUE(Global::config().has("profile-use", profile));
+    Global::config().unset("profile-use");
+    std::ofstream(profile) << "b";
+    EXPECT_FALSE(isCached("pragma"));
+
+    // the entry of another source under a colliding key is rejected
+    store("x");
+    const std::string original = ProgramCache(directory, "x").getFilename();
+    const std::string collision = ProgramCache(directory, "y").getFilename();
+    std::ifstream entry(original, std::ios::binary);
+    std::ostringstream contents;
+    contents << entry.rdbuf();
+    std::string data = contents.str();
+    // the key is the name of the entry, and is stored in the entry
+    auto keyOf = [&](const std::string& filename) {
+        return filename.substr(std::string(directory).size() + 1, filename.size() - sizeof(directory) - 4);
+    };
+    const auto pos = data.find(keyOf(original));
+    EXPECT_TRUE(pos != std::string::npos);
+    data.replace(pos, keyOf(original).size(), keyOf(collision));
+    std::ofstream(collision, std::ios::binary) << data;
+    EXPECT_TRUE(isCached("x"));
+    EXPECT_FALSE(isCached("y"));
+
+    for (const auto& filename : {profiled, pragmaCache.getFilename(), original, collision, profile}) {
+        std::remove(filename.c_str());
+    }
+    ::rmdir(directory);
+}
+
+}  // namespace souffle::ram::test
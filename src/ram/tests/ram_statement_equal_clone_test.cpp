@@ -18,16 +18,20 @@
 
 #include "FunctorOps.h"
 #include "RelationTag.h"
+#include "ram/Adaptive.h"
 #include "ram/Break.h"
+#include "ram/Call.h"
 #include "ram/Clear.h"
 #include "ram/Condition.h"
 #include "ram/Constraint.h"
+#include "ram/Dataflow.h"
 #include "ram/DebugInfo.h"
 #include "ram/EmptinessCheck.h"
 #include "ram/ExistenceCheck.h"
 #include "ram/Exit.h"
 #include "ram/Expression.h"
 #include "ram/Extend.h"
+#include "ram/Facts.h"
 #include "ram/Filter.h"
 #include "ram/IO.h"
 #include "ram/IntrinsicOperator.h"
@@ -42,6 +46,7 @@
 #include "ram/Project.h"
 #include "ram/Query.h"
 #include "ram/Relation.h"
+#include "ram/RelationSize.h"
 #include "ram/Scan.h"
 #include "ram/Sequence.h"
 #include "ram/SignedConstant.h"
@@ -92,6 +97,26 @@ TEST(Clear, CloneAndEquals) {
     delete c;
 }
 
+TEST(Facts, CloneAndEquals) {
+    // FACTS A
+    //  (1,2)
+    //  (3,4)
+    Facts a("A", 2, {1, 2, 3, 4});
+    Facts b("A", 2, {1, 2, 3, 4});
+    EXPECT_EQ(a, b);
+    EXPECT_NE(&a, &b);
+    EXPECT_EQ(2, a.size());
+
+    Facts* c = a.clone();
+    EXPECT_EQ(a, *c);
+    EXPECT_NE(&a, c);
+    delete c;
+
+    // the same values as other tuples
+    Facts d("A", 1, {1, 2, 3, 4});
+    EXPECT_NE(a, d);
+}
+
 TEST(Extend, CloneAndEquals) {
     // MERGE B WITH A
     Relation A("A", 1, 1, {"x"}, {"i"}, RelationRepresentation::DEFAULT);
@@ -264,6 +289,92 @@ TEST(Parallel, CloneAndEquals) {
     EXPECT_NE(&a, c);
     delete c;
 }
+
+TEST(Adaptive, CloneAndEquals) {
+    Relation A("A", 1, 1, {"x"}, {"i"}, RelationRepresentation::DEFAULT);
+    Relation B("B", 1, 1, {"x"}, {"i"}, RelationRepresentation::DEFAULT);
+    Relation C("C", 1, 1, {"x"}, {"i"}, RelationRepresentation::DEFAULT);
+
+    /* ADAPTIVE
+     *  ALTERNATIVE (SIZE(A))
+     *   QUERY
+     *    FOR t0 IN A
+     *     PROJECT (t0.0) INTO C
+     *  ALTERNATIVE (SIZE(B))
+     *   QUERY
+     *    FOR t0 IN B
+     *     PROJECT (t0.0) INTO C
+     * END ADAPTIVE
+     * */
+    auto makeAlternatives = [](const std::string& second) {
+        VecOwn<Statement> alternatives;
+        for (const std::string& rel : {std::string("A"), second}) {
+            VecOwn<Expression> expressions;
+            expressions.emplace_back(new TupleElement(0, 0));
+            auto project = mk<Project>("C", std::move(expressions));
+            alternatives.push_back(mk<Query>(mk<Scan>(rel, 0, std::move(project), "")));
+        }
+        return alternatives;
+    };
+    auto makeCosts = [](const std::string& second) {
+        VecOwn<Expression> costs;
+        costs.push_back(mk<RelationSize>("A"));
+        costs.push_back(mk<RelationSize>(second));
+        return costs;
+    };
+
+    Adaptive a(makeCosts("B"), makeAlternatives("B"));
+    Adaptive b(makeCosts("B"), makeAlternatives("B"));
+    EXPECT_EQ(a, b);
+    EXPECT_NE(&a, &b);
+
+    Adaptive* c = a.clone();
+    EXPECT_EQ(a, *c);
+    EXPECT_NE(&a, c);
+    delete c;
+
+    // alternatives with different costs differ
+    Adaptive d(makeCosts("C"), makeAlternatives("B"));
+    EXPECT_NE(a, d);
+}
+
+TEST(Dataflow, CloneAndEquals) {
+    /* DATAFLOW (2)
+     *  STEP 0
+     *   CALL stratum_0
+     *  STEP 1
+     *   CALL stratum_1
+     *  STEP 2 AFTER (0,1)
+     *   CLEAR A
+     * END DATAFLOW
+     * */
+    auto makeSteps = []() {
+        VecOwn<Statement> steps;
+        steps.push_back(mk<Call>("stratum_0"));
+        steps.push_back(mk<Call>("stratum_1"));
+        steps.push_back(mk<Clear>("A"));
+        return steps;
+    };
+    std::vector<std::vector<std::size_t>> predecessors = {{}, {}, {0, 1}};
+
+    Dataflow a(makeSteps(), predecessors, 2);
+    Dataflow b(makeSteps(), predecessors, 2);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(&a, &b);
+
+    Dataflow* c = a.clone();
+    EXPECT_EQ(a, *c);
+    EXPECT_NE(&a, c);
+    delete c;
+
+    // steps with different dependencies differ
+    Dataflow d(makeSteps(), {{}, {0}, {0, 1}}, 2);
+    EXPECT_NE(a, d);
+
+    // a different concurrency limit differs
+    Dataflow e(makeSteps(), predecessors, 1);
+    EXPECT_NE(a, e);
+}
 TEST(Loop, CloneAndEquals) {
     Relation A("A", 1, 1, {"x"}, {"i"}, RelationRepresentation::DEFAULT);
     Relation B("B", 1, 1, {"x"}, {"i"}, RelationRepresentation::DEFAULT);
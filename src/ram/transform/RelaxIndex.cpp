@@ -0,0 +1,121 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RelaxIndex.cpp
+ *
+ ***********************************************************************/
+
+#include "ram/transform/RelaxIndex.h"
+#include "Global.h"
+#include "ram/Conjunction.h"
+#include "ram/Constraint.h"
+#include "ram/Filter.h"
+#include "ram/IndexAggregate.h"
+#include "ram/IndexChoice.h"
+#include "ram/IndexScan.h"
+#include "ram/Node.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/utility/NodeMapper.h"
+#include "ram/utility/Utils.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/utility/MiscUtil.h"
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram::transform {
+
+using namespace analysis;
+
+Own<Condition> RelaxIndexTransformer::relaxPattern(const IndexOperation& indexOp, RamPattern& pattern) {
+    const Relation& rel = relAnalysis->lookup(indexOp.getRelation());
+    SearchSignature search = indexAnalysis->getSearchSignature(&indexOp);
+    SearchSignature relaxed = indexAnalysis->getRelaxedSearch(rel.getName(), search);
+    if (relaxed == search) {
+        return nullptr;
+    }
+
+    if (Global::config().has("verbose")) {
+        std::cout << "Relaxing search " << search << " of relation " << rel.getName() << " to " << relaxed
+                  << std::endl;
+    }
+
+    // keep the bounds of the relaxed search, and check the dropped equalities in a filter
+    VecOwn<Condition> conditions;
+    const auto& lower = indexOp.getRangePattern().first;
+    const auto& upper = indexOp.getRangePattern().second;
+    for (size_t i = 0; i < rel.getArity(); i++) {
+        if (relaxed[i] != AttributeConstraint::None || isUndefValue(lower[i])) {
+            pattern.first.push_back(souffle::clone(lower[i]));
+            pattern.second.push_back(souffle::clone(upper[i]));
+            continue;
+        }
+        assert(search[i] == AttributeConstraint::Equal && "only equalities can be relaxed");
+        pattern.first.push_back(mk<UndefValue>());
+        pattern.second.push_back(mk<UndefValue>());
+
+        auto op = rel.getAttributeTypes()[i][0] == 'f' ? BinaryConstraintOp::FEQ : BinaryConstraintOp::EQ;
+        conditions.push_back(
+                mk<Constraint>(op, mk<TupleElement>(indexOp.getTupleId(), i), souffle::clone(lower[i])));
+    }
+    return toCondition(conditions);
+}
+
+bool RelaxIndexTransformer::relaxIndex(Program& program) {
+    bool changed = false;
+    visitDepthFirst(program, [&](const Query& query) {
+        std::function<Own<Node>(Own<Node>)> indexRewriter = [&](Own<Node> node) -> Own<Node> {
+            if (const auto* agg = as<IndexAggregate>(node)) {
+                RamPattern pattern;
+                if (Own<Condition> condition = relaxPattern(*agg, pattern)) {
+                    if (!isTrue(&agg->getCondition())) {
+                        condition =
+                                mk<Conjunction>(souffle::clone(agg->getCondition()), std::move(condition));
+                    }
+                    node = mk<IndexAggregate>(souffle::clone(agg->getOperation()), agg->getFunction(),
+                            agg->getRelation(), souffle::clone(agg->getExpression()), std::move(condition),
+                            std::move(pattern), agg->getTupleId());
+                    changed = true;
+                }
+            } else if (const auto* choice = as<IndexChoice>(node)) {
+                RamPattern pattern;
+                if (Own<Condition> condition = relaxPattern(*choice, pattern)) {
+                    if (!isTrue(&choice->getCondition())) {
+                        condition =
+                                mk<Conjunction>(souffle::clone(choice->getCondition()), std::move(condition));
+                    }
+                    node = mk<IndexChoice>(choice->getRelation(), choice->getTupleId(), std::move(condition),
+                            std::move(pattern), souffle::clone(choice->getOperation()),
+                            choice->getProfileText());
+                    changed = true;
+                }
+            } else if (const auto* iscan = as<IndexScan>(node)) {
+                RamPattern pattern;
+                if (Own<Condition> condition = relaxPattern(*iscan, pattern)) {
+                    auto op = mk<Filter>(std::move(condition), souffle::clone(iscan->getOperation()));
+                    node = mk<IndexScan>(iscan->getRelation(), iscan->getTupleId(), std::move(pattern),
+                            std::move(op), iscan->getProfileText());
+                    changed = true;
+                }
+            }
+            node->apply(makeLambdaRamMapper(indexRewriter));
+            return node;
+        };
+        const_cast<Query*>(&query)->apply(makeLambdaRamMapper(indexRewriter));
+    });
+    return changed;
+}
+
+}  // namespace souffle::ram::transform
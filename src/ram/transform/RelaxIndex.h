@@ -0,0 +1,88 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RelaxIndex.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Condition.h"
+#include "ram/IndexOperation.h"
+#include "ram/Operation.h"
+#include "ram/Program.h"
+#include "ram/TranslationUnit.h"
+#include "ram/analysis/Index.h"
+#include "ram/analysis/Relation.h"
+#include "ram/transform/Transformer.h"
+#include <memory>
+#include <string>
+
+namespace souffle::ram::transform {
+
+/**
+ * @class RelaxIndexTransformer
+ * @brief Relax cold index operations whose index is not worth maintaining.
+ *
+ * The index analysis decides, based on the search frequencies and relation
+ * sizes of a profile (--profile-use), which searches are answered by the
+ * index of a weaker search. The transformer weakens the range pattern of
+ * these operations accordingly and checks the dropped bounds in a filter.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   ...
+ *   FOR t1 IN A ON INDEX t1.x = 10 AND t1.y = 20
+ *     ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * will be rewritten to
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  QUERY
+ *   ...
+ *   FOR t1 IN A ON INDEX t1.x = 10
+ *    IF t1.y = 20
+ *     ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class RelaxIndexTransformer : public Transformer {
+public:
+    std::string getName() const override {
+        return "RelaxIndexTransformer";
+    }
+
+    /**
+     * @brief Weaken the range pattern of an index operation
+     * @param Index operation
+     * @param Weakened range pattern that is to be constructed
+     * @result The conditions checking the dropped bounds, or null if the operation is not relaxed
+     */
+    Own<Condition> relaxPattern(const IndexOperation& indexOp, RamPattern& pattern);
+
+    /**
+     * @brief Relax index operations of the program
+     * @param RAM program that is transformed
+     * @result Flag that indicates whether the input program has changed
+     */
+    bool relaxIndex(Program& program);
+
+protected:
+    bool transform(TranslationUnit& translationUnit) override {
+        indexAnalysis = translationUnit.getAnalysis<analysis::IndexAnalysis>();
+        relAnalysis = translationUnit.getAnalysis<analysis::RelationAnalysis>();
+        return relaxIndex(translationUnit.getProgram());
+    }
+
+    analysis::IndexAnalysis* indexAnalysis{nullptr};
+    analysis::RelationAnalysis* relAnalysis{nullptr};
+};
+
+}  // namespace souffle::ram::transform
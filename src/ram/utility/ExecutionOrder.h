@@ -0,0 +1,57 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ExecutionOrder.h
+ *
+ * Utilities ordering RAM statements by their execution
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Call.h"
+#include "ram/IO.h"
+#include "ram/Node.h"
+#include "ram/Program.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/utility/MiscUtil.h"
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace souffle::ram {
+
+/**
+ * @brief Get the input statements of the main program in the order of their execution
+ *
+ * Calls of subroutines are followed at their first call.
+ */
+inline std::vector<const IO*> getLoadsInExecutionOrder(const Program& program) {
+    std::vector<const IO*> loads;
+    std::set<std::string> called;
+    std::function<void(const Node&)> collect = [&](const Node& root) {
+        visitDepthFirst(root, [&](const Node& node) {
+            if (const auto* io = as<IO>(node)) {
+                if (io->get("operation") == "input") {
+                    loads.push_back(io);
+                }
+            } else if (const auto* call = as<Call>(node)) {
+                if (called.insert(call->getName()).second) {
+                    collect(program.getSubroutine(call->getName()));
+                }
+            }
+        });
+    };
+    collect(program.getMain());
+    return loads;
+}
+
+}  // namespace souffle::ram
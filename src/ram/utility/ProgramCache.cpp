@@ -0,0 +1,1080 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProgramCache.cpp
+ *
+ * Implementation of the cache of optimised RAM programs
+ *
+ ***********************************************************************/
+
+#include "ram/utility/ProgramCache.h"
+#include "AggregateOp.h"
+#include "FunctorOps.h"
+#include "Global.h"
+#include "RelationTag.h"
+#include "ram/NestedIntrinsicOperator.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/RamTypes.h"
+#include "souffle/TypeAttribute.h"
+#include "souffle/utility/FileUtil.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace souffle::ram {
+
+namespace {
+
+/** Identifies cache files; the version has to change with the RAM nodes or their encoding */
+constexpr char magic[] = "SOUFFLE-RAM";
+constexpr std::uint64_t formatVersion = 2;
+
+/** The kinds of nodes, preceding their fields in the binary form */
+enum class Kind : std::uint8_t {
+    Relation,
+    // expressions
+    SignedConstant,
+    UnsignedConstant,
+    FloatConstant,
+    TupleElement,
+    IntrinsicOperator,
+    UserDefinedOperator,
+    AutoIncrement,
+    PackRecord,
+    SubroutineArgument,
+    UndefValue,
+    RelationSize,
+    // conditions
+    True,
+    False,
+    Conjunction,
+    Negation,
+    Constraint,
+    ExistenceCheck,
+    ProvenanceExistenceCheck,
+    EmptinessCheck,
+    // operations
+    Filter,
+    Break,
+    Project,
+    GuardedProject,
+    SubroutineReturn,
+    UnpackRecord,
+    NestedIntrinsicOperator,
+    Scan,
+    ParallelScan,
+    IndexScan,
+    ParallelIndexScan,
+    Choice,
+    ParallelChoice,
+    IndexChoice,
+    ParallelIndexChoice,
+    Aggregate,
+    ParallelAggregate,
+    IndexAggregate,
+    ParallelIndexAggregate,
+    // statements
+    IO,
+    Query,
+    Clear,
+    Facts,
+    LogSize,
+    Swap,
+    Extend,
+    Sequence,
+    Loop,
+    Parallel,
+    Adaptive,
+    Dataflow,
+    Exit,
+    LogTimer,
+    LogRelationTimer,
+    DebugInfo,
+    Call
+};
+
+/**
+ * Writes nodes in pre-order, each as its kind followed by its fields and children.
+ * Numbers are written in the byte order of the machine, which is part of the key.
+ */
+class Writer : public Visitor<void> {
+public:
+    explicit Writer(std::ostream& os) : os(os) {}
+
+    void writeNumber(std::uint64_t value) {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeString(const std::string& value) {
+        writeNumber(value.size());
+        os.write(value.data(), value.size());
+    }
+
+    void writeStrings(const std::vector<std::string>& values) {
+        writeNumber(values.size());
+        for (const auto& cur : values) {
+            writeString(cur);
+        }
+    }
+
+    template <typename T>
+    void writeNodes(const std::vector<T*>& nodes) {
+        writeNumber(nodes.size());
+        for (const auto* cur : nodes) {
+            visit(*cur);
+        }
+    }
+
+    void writePattern(const IndexOperation& op) {
+        const auto pattern = op.getRangePattern();
+        writeNodes(pattern.first);
+        writeNodes(pattern.second);
+    }
+
+protected:
+    void kind(Kind k) {
+        os.put(static_cast<char>(k));
+    }
+
+    void visit_(type_identity<Relation>, const Relation& rel) override {
+        kind(Kind::Relation);
+        writeString(rel.getName());
+        writeNumber(rel.getArity());
+        writeNumber(rel.getAuxiliaryArity());
+        writeStrings(rel.getAttributeNames());
+        writeStrings(rel.getAttributeTypes());
+        writeNumber(static_cast<std::uint64_t>(rel.getRepresentation()));
+    }
+
+    // -- expressions --
+
+    void visit_(type_identity<SignedConstant>, const SignedConstant& constant) override {
+        kind(Kind::SignedConstant);
+        writeNumber(constant.getConstant());
+    }
+
+    void visit_(type_identity<UnsignedConstant>, const UnsignedConstant& constant) override {
+        kind(Kind::UnsignedConstant);
+        writeNumber(constant.getConstant());
+    }
+
+    void visit_(type_identity<FloatConstant>, const FloatConstant& constant) override {
+        kind(Kind::FloatConstant);
+        writeNumber(constant.getConstant());
+    }
+
+    void visit_(type_identity<TupleElement>, const TupleElement& element) override {
+        kind(Kind::TupleElement);
+        writeNumber(element.getTupleId());
+        writeNumber(element.getElement());
+    }
+
+    void visit_(type_identity<IntrinsicOperator>, const IntrinsicOperator& op) override {
+        kind(Kind::IntrinsicOperator);
+        writeNumber(static_cast<std::uint64_t>(op.getOperator()));
+        writeNodes(op.getArguments());
+    }
+
+    void visit_(type_identity<UserDefinedOperator>, const UserDefinedOperator& op) override {
+        kind(Kind::UserDefinedOperator);
+        writeString(op.getName());
+        writeNumber(op.getArgsTypes().size());
+        for (auto type : op.getArgsTypes()) {
+            writeNumber(static_cast<std::uint64_t>(type));
+        }
+        writeNumber(static_cast<std::uint64_t>(op.getReturnType()));
+        writeNumber(op.isStateful());
+        writeNodes(op.getArguments());
+    }
+
+    void visit_(type_identity<AutoIncrement>, const AutoIncrement&) override {
+        kind(Kind::AutoIncrement);
+    }
+
+    void visit_(type_identity<PackRecord>, const PackRecord& pack) override {
+        kind(Kind::PackRecord);
+        writeNodes(pack.getArguments());
+    }
+
+    void visit_(type_identity<SubroutineArgument>, const SubroutineArgument& arg) override {
+        kind(Kind::SubroutineArgument);
+        writeNumber(arg.getArgument());
+    }
+
+    void visit_(type_identity<UndefValue>, const UndefValue&) override {
+        kind(Kind::UndefValue);
+    }
+
+    void visit_(type_identity<RelationSize>, const RelationSize& size) override {
+        kind(Kind::RelationSize);
+        writeString(size.getRelation());
+    }
+
+    // -- conditions --
+
+    void visit_(type_identity<True>, const True&) override {
+        kind(Kind::True);
+    }
+
+    void visit_(type_identity<False>, const False&) override {
+        kind(Kind::False);
+    }
+
+    void visit_(type_identity<Conjunction>, const Conjunction& conj) override {
+        kind(Kind::Conjunction);
+        visit(conj.getLHS());
+        visit(conj.getRHS());
+    }
+
+    void visit_(type_identity<Negation>, const Negation& neg) override {
+        kind(Kind::Negation);
+        visit(neg.getOperand());
+    }
+
+    void visit_(type_identity<Constraint>, const Constraint& constraint) override {
+        kind(Kind::Constraint);
+        writeNumber(static_cast<std::uint64_t>(constraint.getOperator()));
+        visit(constraint.getLHS());
+        visit(constraint.getRHS());
+    }
+
+    void visit_(type_identity<ExistenceCheck>, const ExistenceCheck& exists) override {
+        kind(Kind::ExistenceCheck);
+        writeString(exists.getRelation());
+        writeNodes(exists.getValues());
+    }
+
+    void visit_(type_identity<ProvenanceExistenceCheck>, const ProvenanceExistenceCheck& exists) override {
+        kind(Kind::ProvenanceExistenceCheck);
+        writeString(exists.getRelation());
+        writeNodes(exists.getValues());
+    }
+
+    void visit_(type_identity<EmptinessCheck>, const EmptinessCheck& emptiness) override {
+        kind(Kind::EmptinessCheck);
+        writeString(emptiness.getRelation());
+    }
+
+    // -- operations --
+
+    void visit_(type_identity<Filter>, const Filter& filter) override {
+        kind(Kind::Filter);
+        visit(filter.getCondition());
+        writeString(filter.getProfileText());
+        visit(filter.getOperation());
+    }
+
+    void visit_(type_identity<Break>, const Break& breakOp) override {
+        kind(Kind::Break);
+        visit(breakOp.getCondition());
+        writeString(breakOp.getProfileText());
+        visit(breakOp.getOperation());
+    }
+
+    void visit_(type_identity<Project>, const Project& project) override {
+        kind(Kind::Project);
+        writeString(project.getRelation());
+        writeNodes(project.getValues());
+    }
+
+    void visit_(type_identity<GuardedProject>, const GuardedProject& project) override {
+        kind(Kind::GuardedProject);
+        writeString(project.getRelation());
+        writeNodes(project.getValues());
+        visit(*project.getCondition());
+    }
+
+    void visit_(type_identity<SubroutineReturn>, const SubroutineReturn& ret) override {
+        kind(Kind::SubroutineReturn);
+        writeNodes(ret.getValues());
+    }
+
+    void visit_(type_identity<UnpackRecord>, const UnpackRecord& unpack) override {
+        kind(Kind::UnpackRecord);
+        writeNumber(unpack.getTupleId());
+        writeNumber(unpack.getArity());
+        visit(unpack.getExpression());
+        visit(unpack.getOperation());
+    }
+
+    void visit_(type_identity<NestedIntrinsicOperator>, const NestedIntrinsicOperator& op) override {
+        kind(Kind::NestedIntrinsicOperator);
+        writeNumber(static_cast<std::uint64_t>(op.getFunction()));
+        writeNumber(op.getTupleId());
+        writeNodes(op.getArguments());
+        visit(op.getOperation());
+    }
+
+    void visit_(type_identity<Scan>, const Scan& scan) override {
+        kind(isA<ParallelScan>(scan) ? Kind::ParallelScan : Kind::Scan);
+        writeString(scan.getRelation());
+        writeNumber(scan.getTupleId());
+        writeString(scan.getProfileText());
+        visit(scan.getOperation());
+    }
+
+    void visit_(type_identity<IndexScan>, const IndexScan& scan) override {
+        kind(isA<ParallelIndexScan>(scan) ? Kind::ParallelIndexScan : Kind::IndexScan);
+        writeString(scan.getRelation());
+        writeNumber(scan.getTupleId());
+        writePattern(scan);
+        writeString(scan.getProfileText());
+        visit(scan.getOperation());
+    }
+
+    void visit_(type_identity<Choice>, const Choice& choice) override {
+        kind(isA<ParallelChoice>(choice) ? Kind::ParallelChoice : Kind::Choice);
+        writeString(choice.getRelation());
+        writeNumber(choice.getTupleId());
+        visit(choice.getCondition());
+        writeString(choice.getProfileText());
+        visit(choice.getOperation());
+    }
+
+    void visit_(type_identity<IndexChoice>, const IndexChoice& choice) override {
+        kind(isA<ParallelIndexChoice>(choice) ? Kind::ParallelIndexChoice : Kind::IndexChoice);
+        writeString(choice.getRelation());
+        writeNumber(choice.getTupleId());
+        visit(choice.getCondition());
+        writePattern(choice);
+        writeString(choice.getProfileText());
+        visit(choice.getOperation());
+    }
+
+    void visit_(type_identity<Aggregate>, const Aggregate& agg) override {
+        kind(isA<ParallelAggregate>(agg) ? Kind::ParallelAggregate : Kind::Aggregate);
+        writeString(agg.getRelation());
+        writeNumber(agg.getTupleId());
+        writeNumber(static_cast<std::uint64_t>(agg.getFunction()));
+        visit(agg.getExpression());
+        visit(agg.getCondition());
+        visit(agg.getOperation());
+    }
+
+    void visit_(type_identity<IndexAggregate>, const IndexAggregate& agg) override {
+        kind(isA<ParallelIndexAggregate>(agg) ? Kind::ParallelIndexAggregate : Kind::IndexAggregate);
+        writeString(agg.getRelation());
+        writeNumber(agg.getTupleId());
+        writeNumber(static_cast<std::uint64_t>(agg.getFunction()));
+        visit(agg.getExpression());
+        visit(agg.getCondition());
+        writePattern(agg);
+        visit(agg.getOperation());
+    }
+
+    // -- statements --
+
+    void visit_(type_identity<IO>, const IO& io) override {
+        kind(Kind::IO);
+        writeString(io.getRelation());
+        writeNumber(io.getDirectives().size());
+        for (const auto& [key, value] : io.getDirectives()) {
+            writeString(key);
+            writeString(value);
+        }
+    }
+
+    void visit_(type_identity<Query>, const Query& query) override {
+        kind(Kind::Query);
+        visit(query.getOperation());
+    }
+
+    void visit_(type_identity<Clear>, const Clear& clear) override {
+        kind(Kind::Clear);
+        writeString(clear.getRelation());
+    }
+
+    void visit_(type_identity<Facts>, const Facts& facts) override {
+        kind(Kind::Facts);
+        writeString(facts.getRelation());
+        writeNumber(facts.getArity());
+        writeNumber(facts.getValues().size());
+        for (RamDomain value : facts.getValues()) {
+            writeNumber(value);
+        }
+    }
+
+    void visit_(type_identity<LogSize>, const LogSize& logSize) override {
+        kind(Kind::LogSize);
+        writeString(logSize.getRelation());
+        writeString(logSize.getMessage());
+    }
+
+    void visit_(type_identity<Swap>, const Swap& swap) override {
+        kind(Kind::Swap);
+        writeString(swap.getFirstRelation());
+        writeString(swap.getSecondRelation());
+    }
+
+    void visit_(type_identity<Extend>, const Extend& extend) override {
+        kind(Kind::Extend);
+        writeString(extend.getFirstRelation());
+        writeString(extend.getSecondRelation());
+    }
+
+    void visit_(type_identity<Sequence>, const Sequence& seq) override {
+        kind(Kind::Sequence);
+        writeNodes(seq.getStatements());
+    }
+
+    void visit_(type_identity<Loop>, const Loop& loop) override {
+        kind(Kind::Loop);
+        visit(loop.getBody());
+    }
+
+    void visit_(type_identity<Parallel>, const Parallel& parallel) override {
+        kind(Kind::Parallel);
+        writeNodes(parallel.getStatements());
+    }
+
+    void visit_(type_identity<Adaptive>, const Adaptive& adaptive) override {
+        kind(Kind::Adaptive);
+        writeNodes(adaptive.getCosts());
+        writeNodes(adaptive.getStatements());
+    }
+
+    void visit_(type_identity<Dataflow>, const Dataflow& dataflow) override {
+        kind(Kind::Dataflow);
+        writeNumber(dataflow.getConcurrencyLimit());
+        writeNodes(dataflow.getStatements());
+        for (const auto& preds : dataflow.getPredecessors()) {
+            writeNumber(preds.size());
+            for (std::size_t pred : preds) {
+                writeNumber(pred);
+            }
+        }
+    }
+
+    void visit_(type_identity<Exit>, const Exit& exit) override {
+        kind(Kind::Exit);
+        visit(exit.getCondition());
+    }
+
+    void visit_(type_identity<LogTimer>, const LogTimer& timer) override {
+        kind(Kind::LogTimer);
+        writeString(timer.getMessage());
+        visit(timer.getStatement());
+    }
+
+    void visit_(type_identity<LogRelationTimer>, const LogRelationTimer& timer) override {
+        kind(Kind::LogRelationTimer);
+        writeString(timer.getMessage());
+        writeString(timer.getRelation());
+        visit(timer.getStatement());
+    }
+
+    void visit_(type_identity<DebugInfo>, const DebugInfo& dbg) override {
+        kind(Kind::DebugInfo);
+        writeString(dbg.getMessage());
+        visit(dbg.getStatement());
+    }
+
+    void visit_(type_identity<Call>, const Call& call) override {
+        kind(Kind::Call);
+        writeString(call.getName());
+    }
+
+    void visit_(type_identity<Node>, const Node& node) override {
+        fatal("cannot write RAM node %s", toString(node));
+    }
+
+private:
+    std::ostream& os;
+};
+
+/**
+ * Reads the nodes written by a Writer. Fields are read into locals in the order they
+ * were written, before the node is constructed from them.
+ */
+class Reader {
+public:
+    explicit Reader(std::istream& is) : is(is) {}
+
+    std::uint64_t readNumber() {
+        std::uint64_t value = 0;
+        if (!is.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+            throw std::runtime_error("unexpected end of cached RAM program");
+        }
+        return value;
+    }
+
+    std::string readString() {
+        const std::uint64_t size = readNumber();
+        std::string value;
+        // read in blocks, so that a corrupted size fails at the end of the file
+        char buffer[4096];
+        for (std::uint64_t left = size; left > 0;) {
+            const auto block = static_cast<std::streamsize>(std::min<std::uint64_t>(left, sizeof(buffer)));
+            if (!is.read(buffer, block)) {
+                throw std::runtime_error("unexpected end of cached RAM program");
+            }
+            value.append(buffer, block);
+            left -= block;
+        }
+        return value;
+    }
+
+    std::vector<std::string> readStrings() {
+        std::vector<std::string> values(readCount());
+        for (auto& cur : values) {
+            cur = readString();
+        }
+        return values;
+    }
+
+    /** Read a node of the given type */
+    template <typename T>
+    Own<T> read() {
+        Own<Node> node = readNode();
+        if (!isA<T>(node)) {
+            throw std::runtime_error("unexpected node in cached RAM program");
+        }
+        return Own<T>(as<T>(node.release()));
+    }
+
+    template <typename T>
+    VecOwn<T> readNodes() {
+        VecOwn<T> nodes(readCount());
+        for (auto& cur : nodes) {
+            cur = read<T>();
+        }
+        return nodes;
+    }
+
+    RamPattern readPattern() {
+        RamBound lower = readNodes<Expression>();
+        RamBound upper = readNodes<Expression>();
+        return {std::move(lower), std::move(upper)};
+    }
+
+    /** Read the size of a list, bounded by the remaining input */
+    std::size_t readCount() {
+        const std::uint64_t count = readNumber();
+        if (count > maxCount) {
+            throw std::runtime_error("invalid size in cached RAM program");
+        }
+        return count;
+    }
+
+    Own<Node> readNode() {
+        const int k = is.get();
+        if (k == std::char_traits<char>::eof()) {
+            throw std::runtime_error("unexpected end of cached RAM program");
+        }
+        switch (static_cast<Kind>(k)) {
+            case Kind::Relation: {
+                auto name = readString();
+                auto arity = readNumber();
+                auto auxiliaryArity = readNumber();
+                auto attributeNames = readStrings();
+                auto attributeTypes = readStrings();
+                auto representation = static_cast<RelationRepresentation>(readNumber());
+                if (attributeNames.size() != attributeTypes.size() || auxiliaryArity > arity) {
+                    throw std::runtime_error("invalid relation in cached RAM program");
+                }
+                return mk<Relation>(std::move(name), arity, auxiliaryArity, std::move(attributeNames),
+                        std::move(attributeTypes), representation);
+            }
+
+            // -- expressions --
+            case Kind::SignedConstant: return mk<SignedConstant>(static_cast<RamDomain>(readNumber()));
+            case Kind::UnsignedConstant:
+                return mk<UnsignedConstant>(ramBitCast<RamUnsigned>(static_cast<RamDomain>(readNumber())));
+            case Kind::FloatConstant:
+                return mk<FloatConstant>(ramBitCast<RamFloat>(static_cast<RamDomain>(readNumber())));
+            case Kind::TupleElement: {
+                auto ident = readNumber();
+                auto element = readNumber();
+                return mk<TupleElement>(ident, element);
+            }
+            case Kind::IntrinsicOperator: {
+                auto op = static_cast<FunctorOp>(readNumber());
+                return mk<IntrinsicOperator>(op, readNodes<Expression>());
+            }
+            case Kind::UserDefinedOperator: {
+                auto name = readString();
+                std::vector<TypeAttribute> argsTypes(readCount());
+                for (auto& type : argsTypes) {
+                    type = static_cast<TypeAttribute>(readNumber());
+                }
+                auto returnType = static_cast<TypeAttribute>(readNumber());
+                bool stateful = readNumber() != 0;
+                auto args = readNodes<Expression>();
+                return mk<UserDefinedOperator>(
+                        std::move(name), std::move(argsTypes), returnType, stateful, std::move(args));
+            }
+            case Kind::AutoIncrement: return mk<AutoIncrement>();
+            case Kind::PackRecord: return mk<PackRecord>(readNodes<Expression>());
+            case Kind::SubroutineArgument: return mk<SubroutineArgument>(readNumber());
+            case Kind::UndefValue: return mk<UndefValue>();
+            case Kind::RelationSize: return mk<RelationSize>(readString());
+
+            // -- conditions --
+            case Kind::True: return mk<True>();
+            case Kind::False: return mk<False>();
+            case Kind::Conjunction: {
+                auto lhs = read<Condition>();
+                auto rhs = read<Condition>();
+                return mk<Conjunction>(std::move(lhs), std::move(rhs));
+            }
+            case Kind::Negation: return mk<Negation>(read<Condition>());
+            case Kind::Constraint: {
+                auto op = static_cast<BinaryConstraintOp>(readNumber());
+                auto lhs = read<Expression>();
+                auto rhs = read<Expression>();
+                return mk<Constraint>(op, std::move(lhs), std::move(rhs));
+            }
+            case Kind::ExistenceCheck: {
+                auto rel = readString();
+                return mk<ExistenceCheck>(std::move(rel), readNodes<Expression>());
+            }
+            case Kind::ProvenanceExistenceCheck: {
+                auto rel = readString();
+                return mk<ProvenanceExistenceCheck>(std::move(rel), readNodes<Expression>());
+            }
+            case Kind::EmptinessCheck: return mk<EmptinessCheck>(readString());
+
+            // -- operations --
+            case Kind::Filter:
+            case Kind::Break: {
+                auto cond = read<Condition>();
+                auto profileText = readString();
+                auto nested = read<Operation>();
+                if (static_cast<Kind>(k) == Kind::Filter) {
+                    return mk<Filter>(std::move(cond), std::move(nested), std::move(profileText));
+                }
+                return mk<Break>(std::move(cond), std::move(nested), std::move(profileText));
+            }
+            case Kind::Project: {
+                auto rel = readString();
+                return mk<Project>(std::move(rel), readNodes<Expression>());
+            }
+            case Kind::GuardedProject: {
+                auto rel = readString();
+                auto values = readNodes<Expression>();
+                auto cond = read<Condition>();
+                return mk<GuardedProject>(std::move(rel), std::move(values), std::move(cond));
+            }
+            case Kind::SubroutineReturn: return mk<SubroutineReturn>(readNodes<Expression>());
+            case Kind::UnpackRecord: {
+                int ident = readNumber();
+                auto arity = readNumber();
+                auto expr = read<Expression>();
+                auto nested = read<Operation>();
+                return mk<UnpackRecord>(std::move(nested), ident, std::move(expr), arity);
+            }
+            case Kind::NestedIntrinsicOperator: {
+                auto op = static_cast<NestedIntrinsicOp>(readNumber());
+                int ident = readNumber();
+                auto args = readNodes<Expression>();
+                auto nested = read<Operation>();
+                return mk<NestedIntrinsicOperator>(op, std::move(args), std::move(nested), ident);
+            }
+            case Kind::Scan:
+            case Kind::ParallelScan: {
+                auto rel = readString();
+                int ident = readNumber();
+                auto profileText = readString();
+                auto nested = read<Operation>();
+                if (static_cast<Kind>(k) == Kind::Scan) {
+                    return mk<Scan>(std::move(rel), ident, std::move(nested), std::move(profileText));
+                }
+                return mk<ParallelScan>(std::move(rel), ident, std::move(nested), std::move(profileText));
+            }
+            case Kind::IndexScan:
+            case Kind::ParallelIndexScan: {
+                auto rel = readString();
+                int ident = readNumber();
+                auto pattern = readPattern();
+                auto profileText = readString();
+                auto nested = read<Operation>();
+                if (static_cast<Kind>(k) == Kind::IndexScan) {
+                    return mk<IndexScan>(std::move(rel), ident, std::move(pattern), std::move(nested),
+                            std::move(profileText));
+                }
+                return mk<ParallelIndexScan>(
+                        std::move(rel), ident, std::move(pattern), std::move(nested), std::move(profileText));
+            }
+            case Kind::Choice:
+            case Kind::ParallelChoice: {
+                auto rel = readString();
+                int ident = readNumber();
+                auto cond = read<Condition>();
+                auto profileText = readString();
+                auto nested = read<Operation>();
+                if (static_cast<Kind>(k) == Kind::Choice) {
+                    return mk<Choice>(std::move(rel), ident, std::move(cond), std::move(nested),
+                            std::move(profileText));
+                }
+                return mk<ParallelChoice>(
+                        std::move(rel), ident, std::move(cond), std::move(nested), std::move(profileText));
+            }
+            case Kind::IndexChoice:
+            case Kind::ParallelIndexChoice: {
+                auto rel = readString();
+                int ident = readNumber();
+                auto cond = read<Condition>();
+                auto pattern = readPattern();
+                auto profileText = readString();
+                auto nested = read<Operation>();
+                if (static_cast<Kind>(k) == Kind::IndexChoice) {
+                    return mk<IndexChoice>(std::move(rel), ident, std::move(cond), std::move(pattern),
+                            std::move(nested), std::move(profileText));
+                }
+                return mk<ParallelIndexChoice>(std::move(rel), ident, std::move(cond), std::move(pattern),
+                        std::move(nested), std::move(profileText));
+            }
+            case Kind::Aggregate:
+            case Kind::ParallelAggregate: {
+                auto rel = readString();
+                int ident = readNumber();
+                auto fun = static_cast<AggregateOp>(readNumber());
+                auto expr = read<Expression>();
+                auto cond = read<Condition>();
+                auto nested = read<Operation>();
+                if (static_cast<Kind>(k) == Kind::Aggregate) {
+                    return mk<Aggregate>(
+                            std::move(nested), fun, std::move(rel), std::move(expr), std::move(cond), ident);
+                }
+                return mk<ParallelAggregate>(
+                        std::move(nested), fun, std::move(rel), std::move(expr), std::move(cond), ident);
+            }
+            case Kind::IndexAggregate:
+            case Kind::ParallelIndexAggregate: {
+                auto rel = readString();
+                int ident = readNumber();
+                auto fun = static_cast<AggregateOp>(readNumber());
+                auto expr = read<Expression>();
+                auto cond = read<Condition>();
+                auto pattern = readPattern();
+                auto nested = read<Operation>();
+                if (static_cast<Kind>(k) == Kind::IndexAggregate) {
+                    return mk<IndexAggregate>(std::move(nested), fun, std::move(rel), std::move(expr),
+                            std::move(cond), std::move(pattern), ident);
+                }
+                return mk<ParallelIndexAggregate>(std::move(nested), fun, std::move(rel), std::move(expr),
+                        std::move(cond), std::move(pattern), ident);
+            }
+
+            // -- statements --
+            case Kind::IO: {
+                auto rel = readString();
+                std::map<std::string, std::string> directives;
+                for (std::size_t i = readCount(); i > 0; i--) {
+                    auto key = readString();
+                    directives[key] = readString();
+                }
+                return mk<IO>(std::move(rel), std::move(directives));
+            }
+            case Kind::Query: return mk<Query>(read<Operation>());
+            case Kind::Clear: return mk<Clear>(readString());
+            case Kind::Facts: {
+                auto rel = readString();
+                auto arity = readNumber();
+                std::vector<RamDomain> values(readCount());
+                for (auto& value : values) {
+                    value = static_cast<RamDomain>(readNumber());
+                }
+                if (arity == 0 || values.size() % arity != 0) {
+                    throw std::runtime_error("invalid facts in cached RAM program");
+                }
+                return mk<Facts>(std::move(rel), arity, std::move(values));
+            }
+            case Kind::LogSize: {
+                auto rel = readString();
+                auto message = readString();
+                return mk<LogSize>(std::move(rel), std::move(message));
+            }
+            case Kind::Swap: {
+                auto first = readString();
+                auto second = readString();
+                return mk<Swap>(std::move(first), std::move(second));
+            }
+            case Kind::Extend: {
+                // the source relation comes first, while the constructor takes the target first
+                auto source = readString();
+                auto target = readString();
+                return mk<Extend>(std::move(target), source);
+            }
+            case Kind::Sequence: return mk<Sequence>(readNodes<Statement>());
+            case Kind::Loop: return mk<Loop>(read<Statement>());
+            case Kind::Parallel: return mk<Parallel>(readNodes<Statement>());
+            case Kind::Adaptive: {
+                auto costs = readNodes<Expression>();
+                auto alternatives = readNodes<Statement>();
+                if (costs.size() != alternatives.size()) {
+                    throw std::runtime_error("invalid adaptive statement in cached RAM program");
+                }
+                return mk<Adaptive>(std::move(costs), std::move(alternatives));
+            }
+            case Kind::Dataflow: {
+                auto concurrencyLimit = readNumber();
+                auto steps = readNodes<Statement>();
+                std::vector<std::vector<std::size_t>> predecessors(steps.size());
+                for (std::size_t i = 0; i < steps.size(); i++) {
+                    predecessors[i].resize(readCount());
+                    for (auto& pred : predecessors[i]) {
+                        pred = readNumber();
+                        if (pred >= i) {
+                            throw std::runtime_error("invalid dataflow in cached RAM program");
+                        }
+                    }
+                }
+                if (concurrencyLimit == 0) {
+                    throw std::runtime_error("invalid dataflow in cached RAM program");
+                }
+                return mk<Dataflow>(std::move(steps), std::move(predecessors), concurrencyLimit);
+            }
+            case Kind::Exit: return mk<Exit>(read<Condition>());
+            case Kind::LogTimer: {
+                auto message = readString();
+                auto stmt = read<Statement>();
+                return mk<LogTimer>(std::move(stmt), std::move(message));
+            }
+            case Kind::LogRelationTimer: {
+                auto message = readString();
+                auto rel = readString();
+                auto stmt = read<Statement>();
+                return mk<LogRelationTimer>(std::move(stmt), std::move(message), std::move(rel));
+            }
+            case Kind::DebugInfo: {
+                auto message = readString();
+                auto stmt = read<Statement>();
+                return mk<DebugInfo>(std::move(stmt), std::move(message));
+            }
+            case Kind::Call: return mk<Call>(readString());
+        }
+        throw std::runtime_error("unknown node in cached RAM program");
+    }
+
+private:
+    /** Bound of the sizes of lists, well above any program but guarding against corrupted sizes */
+    static constexpr std::uint64_t maxCount = std::uint64_t(1) << 32;
+
+    std::istream& is;
+};
+
+/** 64-bit FNV-1a hash, whose offset basis may be varied to obtain an independent hash */
+class Hash {
+public:
+    explicit Hash(std::uint64_t basis = 0xcbf29ce484222325ull) : value(basis) {}
+
+    void add(const std::string& data) {
+        // the length separates consecutive strings
+        const std::uint64_t size = data.size();
+        add(reinterpret_cast<const char*>(&size), sizeof(size));
+        add(data.data(), data.size());
+    }
+
+    std::string toString() const {
+        std::ostringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << value;
+        return ss.str();
+    }
+
+private:
+    void add(const char* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; i++) {
+            value ^= static_cast<unsigned char>(data[i]);
+            value *= 0x100000001b3ull;
+        }
+    }
+
+    std::uint64_t value;
+};
+
+/** Hash of the contents of a file, or of an empty file if it cannot be read */
+std::string hashFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    Hash hash;
+    hash.add(contents.str());
+    return hash.toString();
+}
+
+}  // namespace
+
+ProgramCache::ProgramCache(std::string directory, const std::string& source)
+        : directory(std::move(directory)) {
+    Hash hash;
+    hash.add(std::to_string(RAM_DOMAIN_SIZE));
+    hash.add(std::to_string(formatVersion));
+    // the numbers of cache files are in the byte order of the machine
+    const std::uint16_t byteOrder = 1;
+    hash.add(std::string(reinterpret_cast<const char*>(&byteOrder), sizeof(byteOrder)));
+    // the options include the version of Souffle
+    for (const auto& [option, value] : Global::config().data()) {
+        if (!isRuntimeOption(option)) {
+            hash.add(option);
+            hash.add(value);
+        }
+        if (isFileOption(option)) {
+            hash.add(hashFile(value));
+        }
+    }
+    hash.add(source);
+    key = hash.toString();
+
+    // a second hash of the source, checked on load, so that a collision of keys cannot load
+    // the program of another source
+    Hash checkHash(0x84222325cbf29ce4ull);
+    checkHash.add(source);
+    sourceHash = checkHash.toString();
+    filename = this->directory + "/" + key + ".ram";
+}
+
+bool ProgramCache::isRuntimeOption(const std::string& option) {
+    return option == "ram-cache" || option == "verbose";
+}
+
+bool ProgramCache::isFileOption(const std::string& option) {
+    return option == "profile-use";
+}
+
+Own<TranslationUnit> ProgramCache::load(ErrorReport& errorReport, DebugReport& debugReport) const {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    try {
+        Reader reader(file);
+        char header[sizeof(magic)];
+        if (!file.read(header, sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0 ||
+                reader.readNumber() != formatVersion || reader.readString() != key ||
+                reader.readString() != sourceHash) {
+            return nullptr;
+        }
+
+        // the options set by the front end, e.g. by pragmas
+        std::map<std::string, std::string> options;
+        for (std::size_t i = reader.readCount(); i > 0; i--) {
+            auto option = reader.readString();
+            options[option] = reader.readString();
+        }
+
+        // the files named by options, which may have been set by pragmas, must be unchanged
+        for (std::size_t i = reader.readCount(); i > 0; i--) {
+            auto option = reader.readString();
+            auto fileHash = reader.readString();
+            if (options.count(option) == 0 || hashFile(options[option]) != fileHash) {
+                return nullptr;
+            }
+        }
+
+        auto [program, symbolTable] = read(file);
+        for (const auto& [option, value] : options) {
+            if (!isRuntimeOption(option)) {
+                Global::config().set(option, value);
+            }
+        }
+        return mk<TranslationUnit>(std::move(program), std::move(symbolTable), errorReport, debugReport);
+    } catch (std::exception&) {
+        // a malformed entry is rebuilt
+        return nullptr;
+    }
+}
+
+void ProgramCache::store(TranslationUnit& translationUnit) const {
+    if (!existDir(directory) && mkdir(directory.c_str(), 0755) != 0 && !existDir(directory)) {
+        return;
+    }
+
+    // write to a file of this process, and move it into place once complete
+    const std::string tmpFilename = filename + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream file(tmpFilename, std::ios::binary);
+        if (!file) {
+            return;
+        }
+        Writer writer(file);
+        file.write(magic, sizeof(magic));
+        writer.writeNumber(formatVersion);
+        writer.writeString(key);
+        writer.writeString(sourceHash);
+        const auto& options = Global::config().data();
+        writer.writeNumber(options.size());
+        for (const auto& [option, value] : options) {
+            writer.writeString(option);
+            writer.writeString(value);
+        }
+        std::map<std::string, std::string> fileHashes;
+        for (const auto& [option, value] : options) {
+            if (isFileOption(option)) {
+                fileHashes[option] = hashFile(value);
+            }
+        }
+        writer.writeNumber(fileHashes.size());
+        for (const auto& [option, fileHash] : fileHashes) {
+            writer.writeString(option);
+            writer.writeString(fileHash);
+        }
+        write(file, translationUnit.getProgram(), translationUnit.getSymbolTable());
+        if (!file) {
+            file.close();
+            std::remove(tmpFilename.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+        std::remove(tmpFilename.c_str());
+    }
+}
+
+void ProgramCache::write(std::ostream& os, const Program& program, const SymbolTable& symbolTable) {
+    Writer writer(os);
+    writer.writeNumber(symbolTable.size());
+    for (std::size_t i = 0; i < symbolTable.size(); i++) {
+        writer.writeString(symbolTable.resolve(i));
+    }
+    writer.writeNodes(program.getRelations());
+    writer.visit(program.getMain());
+    const auto subroutines = program.getSubroutines();
+    writer.writeNumber(subroutines.size());
+    for (const auto& [name, stmt] : subroutines) {
+        writer.writeString(name);
+        writer.visit(*stmt);
+    }
+}
+
+std::pair<Own<Program>, SymbolTable> ProgramCache::read(std::istream& is) {
+    Reader reader(is);
+    std::vector<std::string> symbols(reader.readCount());
+    for (auto& symbol : symbols) {
+        symbol = reader.readString();
+    }
+    SymbolTable symbolTable;
+    symbolTable.insert(symbols);
+    if (symbolTable.size() != symbols.size()) {
+        throw std::runtime_error("invalid symbol table in cached RAM program");
+    }
+
+    auto relations = reader.readNodes<Relation>();
+    auto main = reader.read<Statement>();
+    std::map<std::string, Own<Statement>> subroutines;
+    for (std::size_t i = reader.readCount(); i > 0; i--) {
+        auto name = reader.readString();
+        subroutines[name] = reader.read<Statement>();
+    }
+    return {mk<Program>(std::move(relations), std::move(main), std::move(subroutines)),
+            std::move(symbolTable)};
+}
+
+}  // namespace souffle::ram
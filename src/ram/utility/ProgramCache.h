@@ -0,0 +1,90 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProgramCache.h
+ *
+ * A cache of optimised RAM programs in binary form
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Program.h"
+#include "ram/TranslationUnit.h"
+#include "reports/DebugReport.h"
+#include "reports/ErrorReport.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/utility/MiscUtil.h"
+#include <iosfwd>
+#include <string>
+#include <utility>
+
+namespace souffle::ram {
+
+/**
+ * @class ProgramCache
+ * @brief Cache of the optimised RAM translation units of programs
+ *
+ * The translation unit of a program is stored in a directory, keyed on a hash of
+ * the pre-processed source, the options, the contents of the profile of --profile-use
+ * and the Souffle version. A later run of the unchanged program loads the RAM program
+ * and its symbol table, and skips parsing, the AST transformations, the translation
+ * to RAM and the RAM transformations. The options set by pragmas of the program are
+ * stored along with it.
+ *
+ * An entry also holds a second hash of the source and hashes of the files named by
+ * options, which are checked on load, so that neither a collision of keys nor a
+ * changed profile named by a pragma loads a stale program.
+ *
+ * Analyses such as the index selection are derived from the loaded program.
+ */
+class ProgramCache {
+public:
+    /** Create the cache entry of the given pre-processed source under the current options */
+    ProgramCache(std::string directory, const std::string& source);
+
+    /** Load the translation unit of the source, or return nullptr if it is not in the cache */
+    Own<TranslationUnit> load(ErrorReport& errorReport, DebugReport& debugReport) const;
+
+    /** Store the translation unit of the source; failures leave the cache unchanged */
+    void store(TranslationUnit& translationUnit) const;
+
+    /** Get the file of the cache entry */
+    const std::string& getFilename() const {
+        return filename;
+    }
+
+    /** Write a RAM program and its symbol table in binary form */
+    static void write(std::ostream& os, const Program& program, const SymbolTable& symbolTable);
+
+    /** Read a RAM program and its symbol table written by write(); throws if they are malformed */
+    static std::pair<Own<Program>, SymbolTable> read(std::istream& is);
+
+private:
+    /** Options not affecting the translation, which are neither hashed nor restored */
+    static bool isRuntimeOption(const std::string& option);
+
+    /** Options naming files whose contents affect the translation */
+    static bool isFileOption(const std::string& option);
+
+    /** Hash of the source and the options */
+    std::string key;
+
+    /** Independent hash of the source */
+    std::string sourceHash;
+
+    /** Cache directory */
+    std::string directory;
+
+    /** File of the cache entry */
+    std::string filename;
+};
+
+}  // namespace souffle::ram
@@ -20,6 +20,7 @@
 #include "ram/AbstractConditional.h"
 #include "ram/AbstractExistenceCheck.h"
 #include "ram/AbstractOperator.h"
+#include "ram/Adaptive.h"
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
 #include "ram/BinRelationStatement.h"
@@ -31,12 +32,14 @@
 #include "ram/Conjunction.h"
 #include "ram/Constant.h"
 #include "ram/Constraint.h"
+#include "ram/Dataflow.h"
 #include "ram/DebugInfo.h"
 #include "ram/EmptinessCheck.h"
 #include "ram/ExistenceCheck.h"
 #include "ram/Exit.h"
 #include "ram/Expression.h"
 #include "ram/Extend.h"
+#include "ram/Facts.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
 #include "ram/FloatConstant.h"
@@ -160,6 +163,7 @@ struct Visitor : public souffle::Visitor<R, NodeType, Params...> {
         SOUFFLE_VISITOR_FORWARD(IO);
         SOUFFLE_VISITOR_FORWARD(Query);
         SOUFFLE_VISITOR_FORWARD(Clear);
+        SOUFFLE_VISITOR_FORWARD(Facts);
         SOUFFLE_VISITOR_FORWARD(LogSize);
 
         SOUFFLE_VISITOR_FORWARD(Swap);
@@ -170,6 +174,8 @@ struct Visitor : public souffle::Visitor<R, NodeType, Params...> {
         SOUFFLE_VISITOR_FORWARD(Sequence);
         SOUFFLE_VISITOR_FORWARD(Loop);
         SOUFFLE_VISITOR_FORWARD(Parallel);
+        SOUFFLE_VISITOR_FORWARD(Adaptive);
+        SOUFFLE_VISITOR_FORWARD(Dataflow);
         SOUFFLE_VISITOR_FORWARD(Exit);
         SOUFFLE_VISITOR_FORWARD(LogTimer);
         SOUFFLE_VISITOR_FORWARD(LogRelationTimer);
@@ -185,6 +191,7 @@ protected:
     SOUFFLE_VISITOR_LINK(IO, RelationStatement);
     SOUFFLE_VISITOR_LINK(Query, Statement);
     SOUFFLE_VISITOR_LINK(Clear, RelationStatement);
+    SOUFFLE_VISITOR_LINK(Facts, RelationStatement);
     SOUFFLE_VISITOR_LINK(LogSize, RelationStatement);
 
     SOUFFLE_VISITOR_LINK(RelationStatement, Statement);
@@ -196,6 +203,8 @@ protected:
     SOUFFLE_VISITOR_LINK(Sequence, ListStatement);
     SOUFFLE_VISITOR_LINK(Loop, Statement);
     SOUFFLE_VISITOR_LINK(Parallel, ListStatement);
+    SOUFFLE_VISITOR_LINK(Adaptive, ListStatement);
+    SOUFFLE_VISITOR_LINK(Dataflow, ListStatement);
     SOUFFLE_VISITOR_LINK(ListStatement, Statement);
     SOUFFLE_VISITOR_LINK(Exit, Statement);
     SOUFFLE_VISITOR_LINK(LogTimer, Statement);
@@ -7,6 +7,7 @@
  */
 
 #include "synthesiser/Relation.h"
+#include "Global.h"
 #include "RelationTag.h"
 #include "ram/analysis/Index.h"
 #include "souffle/SouffleInterface.h"
@@ -47,13 +48,16 @@ Own<Relation> Relation::getSynthesiserRelation(
         const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection, bool isProvenance) {
     Relation* rel;
 
+    // computed relations are frozen into compressed indexes, but not their semi-naive copies
+    const bool isFreezable = !isProvenance && !ramRel.isTemp() && Global::config().has("freeze-relations");
+
     // Handle the qualifier in souffle code
     if (isProvenance) {
         rel = new DirectRelation(ramRel, indexSelection, isProvenance);
     } else if (ramRel.isNullary()) {
         rel = new NullaryRelation(ramRel, indexSelection, isProvenance);
     } else if (ramRel.getRepresentation() == RelationRepresentation::BTREE) {
-        rel = new DirectRelation(ramRel, indexSelection, isProvenance);
+        rel = new DirectRelation(ramRel, indexSelection, isProvenance, isFreezable);
     } else if (ramRel.getRepresentation() == RelationRepresentation::BRIE) {
         rel = new BrieRelation(ramRel, indexSelection, isProvenance);
     } else if (ramRel.getRepresentation() == RelationRepresentation::EQREL) {
@@ -62,7 +66,12 @@ Own<Relation> Relation::getSynthesiserRelation(
         rel = new InfoRelation(ramRel, indexSelection, isProvenance);
     } else {
         // Handle the data structure command line flag
-        if (ramRel.getArity() > 6) {
+        if (isFreezable) {
+            rel = new DirectRelation(ramRel, indexSelection, isProvenance, isFreezable);
+        } else if (!isProvenance && Global::config().has("compact-relations") &&
+                CompactRelation::isPreferable(ramRel, indexSelection)) {
+            rel = new CompactRelation(ramRel, indexSelection, isProvenance);
+        } else if (ramRel.getArity() > 6) {
             rel = new IndirectRelation(ramRel, indexSelection, isProvenance);
         } else {
             rel = new DirectRelation(ramRel, indexSelection, isProvenance);
@@ -172,7 +181,8 @@ std::string DirectRelation::getTypeName() {
     }
 
     std::stringstream res;
-    res << "t_btree_" << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
+    res << (freezable ? "t_freezable_btree_" : "t_btree_")
+        << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
 
     for (auto& ind : getIndices()) {
         res << "__" << join(ind, "_");
@@ -235,6 +245,10 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
 
         auto genstruct = [&](std::string name, size_t bound) {
             out << "struct " << name << "{\n";
+            // signed leading columns can be searched by the vectorised search strategy
+            if (bound > 0 && typecasts[ind[0]] == "ramBitCast<RamSigned>") {
+                out << " static constexpr int leading_column = " << ind[0] << ";\n";
+            }
             out << " int operator()(const t_tuple& a, const t_tuple& b) const {\n";
             out << "  return ";
             std::function<void(size_t)> gencmp = [&](size_t i) {
@@ -303,22 +317,44 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
                 comparator_aux = comparator;
             }
             out << "using t_ind_" << i << " = btree_set<t_tuple," << comparator
-                << ",std::allocator<t_tuple>,256,typename "
+                << ",PoolAllocator<t_tuple>,256,typename "
                    "souffle::detail::default_strategy<t_tuple>::type,"
                 << comparator_aux << ",updater_" << getTypeName() << ">;\n";
         } else {
             if (ind.size() == arity) {
-                out << "using t_ind_" << i << " = btree_set<t_tuple," << comparator << ">;\n";
+                out << "using t_ind_" << i << " = btree_set<t_tuple," << comparator
+                    << ",PoolAllocator<t_tuple>>;\n";
             } else {
                 // without provenance, some indices may be not full, so we use btree_multiset for those
-                out << "using t_ind_" << i << " = btree_multiset<t_tuple," << comparator << ">;\n";
+                out << "using t_ind_" << i << " = btree_multiset<t_tuple," << comparator
+                    << ",PoolAllocator<t_tuple>>;\n";
             }
         }
         out << "t_ind_" << i << " ind_" << i << ";\n";
+        if (freezable) {
+            out << "using t_frozen_" << i << " = CompressedIndex<t_tuple," << comparator << ">;\n";
+            out << "t_frozen_" << i << " frozen_" << i << ";\n";
+        }
     }
 
+    // a layered relation reads the tuples of a base relation in place and only stores its own tuples,
+    // see BaseDatabase in SouffleInterface.h
+    const bool isLayered = !isProvenance && Global::config().has("layered-relations");
+    const std::string master = "ind_" + std::to_string(masterIndex);
+
     // typedef master index iterator to be struct iterator
-    out << "using iterator = t_ind_" << masterIndex << "::iterator;\n";
+    if (isLayered) {
+        out << "using iterator = ChainIterator<t_ind_" << masterIndex << "::iterator>;\n";
+        out << "const " << getTypeName() << "* base = nullptr;\n";
+        out << "void setBase(const " << getTypeName() << "* b) {\n";
+        out << "base = b;\n";
+        out << "}\n";
+    } else if (freezable) {
+        out << "using iterator = FreezableIterator<t_ind_" << masterIndex << "::iterator, t_frozen_"
+            << masterIndex << "::iterator>;\n";
+    } else {
+        out << "using iterator = t_ind_" << masterIndex << "::iterator;\n";
+    }
 
     // create a struct storing hints for each btree
     out << "struct context {\n";
@@ -327,10 +363,43 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
             << ";\n";
         out << "t_ind_" << i << "::operation_hints hints_" << i << "_upper"
             << ";\n";
+        if (isLayered) {
+            out << "t_ind_" << i << "::operation_hints base_hints_" << i << "_lower;\n";
+            out << "t_ind_" << i << "::operation_hints base_hints_" << i << "_upper;\n";
+        }
+        if (freezable) {
+            out << "t_frozen_" << i << "::operation_hints frozen_hints_" << i << "_lower;\n";
+            out << "t_frozen_" << i << "::operation_hints frozen_hints_" << i << "_upper;\n";
+        }
     }
     out << "};\n";
     out << "context createContext() { return context(); }\n";
 
+    // a frozen relation holds its tuples in compressed indexes only, which are searched in place,
+    // until it is written again
+    const std::string frozenMaster = "frozen_" + std::to_string(masterIndex);
+    if (freezable) {
+        out << "bool frozen = false;\n";
+        out << "void freeze() {\n";
+        out << "if (frozen) return;\n";
+        for (size_t i = 0; i < numIndexes; i++) {
+            out << "frozen_" << i << ".assign(ind_" << i << ".begin(), ind_" << i << ".end());\n";
+            // clearing a b-tree keeps its nodes for reuse
+            out << "t_ind_" << i << "().swap(ind_" << i << ");\n";
+        }
+        out << "frozen = true;\n";
+        out << "}\n";
+        out << "void thaw() {\n";
+        out << "if (!frozen) return;\n";
+        out << "frozen = false;\n";
+        out << "context h;\n";
+        out << "for (const auto& t : " << frozenMaster << ") insert(t, h);\n";
+        for (size_t i = 0; i < numIndexes; i++) {
+            out << "frozen_" << i << ".clear();\n";
+        }
+        out << "}\n";
+    }
+
     // insert methods
     out << "bool insert(const t_tuple& t) {\n";
     out << "context h;\n";
@@ -338,6 +407,13 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
     out << "}\n";  // end of insert(t_tuple&)
 
     out << "bool insert(const t_tuple& t, context& h) {\n";
+    if (freezable) {
+        out << "thaw();\n";
+    }
+    if (isLayered) {
+        out << "if (base != nullptr && base->" << master << ".contains(t, h.base_hints_" << masterIndex
+            << "_lower)) return false;\n";
+    }
     out << "if (ind_" << masterIndex << ".insert(t, h.hints_" << masterIndex << "_lower"
         << ")) {\n";
     for (size_t i = 0; i < numIndexes; i++) {
@@ -371,6 +447,14 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
 
     // contains methods
     out << "bool contains(const t_tuple& t, context& h) const {\n";
+    if (isLayered) {
+        out << "if (base != nullptr && base->" << master << ".contains(t, h.base_hints_" << masterIndex
+            << "_lower)) return true;\n";
+    }
+    if (freezable) {
+        out << "if (frozen) return " << frozenMaster << ".contains(t, h.frozen_hints_" << masterIndex
+            << "_lower);\n";
+    }
     out << "return ind_" << masterIndex << ".contains(t, h.hints_" << masterIndex << "_lower"
         << ");\n";
     out << "}\n";
@@ -382,13 +466,33 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
 
     // size method
     out << "std::size_t size() const {\n";
-    out << "return ind_" << masterIndex << ".size();\n";
+    if (isLayered) {
+        out << "return " << master << ".size() + (base != nullptr ? base->size() : 0);\n";
+    } else if (freezable) {
+        out << "return frozen ? " << frozenMaster << ".size() : " << master << ".size();\n";
+    } else {
+        out << "return ind_" << masterIndex << ".size();\n";
+    }
     out << "}\n";
 
     // find methods
     out << "iterator find(const t_tuple& t, context& h) const {\n";
-    out << "return ind_" << masterIndex << ".find(t, h.hints_" << masterIndex << "_lower"
-        << ");\n";
+    if (isLayered) {
+        out << "if (base != nullptr) {\n";
+        out << "auto pos = base->" << master << ".find(t, h.base_hints_" << masterIndex << "_lower);\n";
+        out << "if (pos != base->" << master << ".end()) {\n";
+        out << "return iterator(pos, base->" << master << ".end(), " << master << ".begin());\n";
+        out << "}\n";
+        out << "}\n";
+        out << "return iterator(" << master << ".find(t, h.hints_" << masterIndex << "_lower));\n";
+    } else if (freezable) {
+        out << "if (frozen) return " << frozenMaster << ".find(t, h.frozen_hints_" << masterIndex
+            << "_lower);\n";
+        out << "return " << master << ".find(t, h.hints_" << masterIndex << "_lower);\n";
+    } else {
+        out << "return ind_" << masterIndex << ".find(t, h.hints_" << masterIndex << "_lower"
+            << ");\n";
+    }
     out << "}\n";
 
     out << "iterator find(const t_tuple& t) const {\n";
@@ -396,18 +500,35 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
     out << "return find(t, h);\n";
     out << "}\n";
 
+    // lookup of a tuple by its primary attributes, which precede the annotations in the master index
+    if (isProvenance) {
+        const size_t primaryArity = arity - auxiliaryArity;
+        out << "iterator findPrimary(const t_tuple& t) const {\n";
+        out << "t_tuple low(t);\n";
+        for (size_t i = primaryArity; i < arity; i++) {
+            out << "low[" << i << "] = MIN_RAM_SIGNED;\n";
+        }
+        out << "auto pos = ind_" << masterIndex << ".lower_bound(low);\n";
+        out << "if (pos != ind_" << masterIndex << ".end() && std::equal(t.begin(), t.begin() + "
+            << primaryArity << ", (*pos).begin())) {\n";
+        out << "return pos;\n";
+        out << "}\n";
+        out << "return ind_" << masterIndex << ".end();\n";
+        out << "}\n";
+    }
+
     // empty lowerUpperRange method
     out << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
         << "(const t_tuple& /* lower */, const t_tuple& /* upper */, context& /* h */) const "
            "{\n";
 
-    out << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    out << "return range<iterator>(begin(),end());\n";
     out << "}\n";
 
     out << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
         << "(const t_tuple& /* lower */, const t_tuple& /* upper */) const {\n";
 
-    out << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    out << "return range<iterator>(begin(),end());\n";
     out << "}\n";
 
     // lowerUpperRange methods for each pattern which is used to search this relation
@@ -415,7 +536,16 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
         auto& lexOrder = indexSelection.getLexOrder(search);
         size_t indNum = indexToNumMap[lexOrder];
 
-        out << "range<t_ind_" << indNum << "::iterator> lowerUpperRange_" << search;
+        const std::string indexIterator = "t_ind_" + std::to_string(indNum) + "::iterator";
+        const std::string freezableIterator =
+                "FreezableIterator<" + indexIterator + ", t_frozen_" + std::to_string(indNum) + "::iterator>";
+        std::string rangeType = "range<" + indexIterator + ">";
+        if (isLayered) {
+            rangeType = "range<ChainIterator<" + indexIterator + ">>";
+        } else if (freezable) {
+            rangeType = "range<" + freezableIterator + ">";
+        }
+        out << rangeType << " lowerUpperRange_" << search;
         out << "(const t_tuple& lower, const t_tuple& upper, context& h) const {\n";
 
         // count size of search pattern
@@ -426,31 +556,67 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
             }
         }
 
-        out << "t_comparator_" << indNum << " comparator;\n";
-        out << "int cmp = comparator(lower, upper);\n";
+        // the search of the given index with the given hints, whose iterators are converted to
+        // the given iterator type, if any
+        auto genSearch = [&](const std::string& index, const std::string& lowerHints,
+                                 const std::string& upperHints, const std::string& iter = "") {
+            out << "t_comparator_" << indNum << " comparator;\n";
+            out << "int cmp = comparator(lower, upper);\n";
+
+            // if search signature is full we can apply this specialization
+            if (eqSize == arity) {
+                // use the more efficient find() method if lower == upper
+                out << "if (cmp == 0) {\n";
+                out << "    auto pos = " << index << ".find(lower, " << lowerHints << ");\n";
+                out << "    auto fin = " << index << ".end();\n";
+                out << "    if (pos != fin) {fin = pos; ++fin;}\n";
+                out << "    return make_range(" << iter << "(pos), " << iter << "(fin));\n";
+                out << "}\n";
+            }
+            // if lower_bound > upper_bound then we return an empty range
+            out << "if (cmp > 0) {\n";
+            out << "    return make_range(" << iter << "(" << index << ".end()), " << iter << "(" << index
+                << ".end()));\n";
+            out << "}\n";
+            // otherwise use the general method
+            out << "return make_range(" << iter << "(" << index << ".lower_bound(lower, " << lowerHints
+                << ")), " << iter << "(" << index << ".upper_bound(upper, " << upperHints << ")));\n";
+        };
 
-        // if search signature is full we can apply this specialization
-        if (eqSize == arity) {
-            // use the more efficient find() method if lower == upper
-            out << "if (cmp == 0) {\n";
-            out << "    auto pos = ind_" << indNum << ".find(lower, h.hints_" << indNum << "_lower);\n";
-            out << "    auto fin = ind_" << indNum << ".end();\n";
-            out << "    if (pos != fin) {fin = pos; ++fin;}\n";
-            out << "    return make_range(pos, fin);\n";
+        const std::string ind = "ind_" + std::to_string(indNum);
+        if (isLayered) {
+            // the tuples of the base relation are visited before the own tuples
+            out << "auto search = [&](const t_ind_" << indNum << "& index, t_ind_" << indNum
+                << "::operation_hints& lowerHints, t_ind_" << indNum
+                << "::operation_hints& upperHints) -> range<" << indexIterator << "> {\n";
+            genSearch("index", "lowerHints", "upperHints");
+            out << "};\n";
+            out << "using chain = ChainIterator<" << indexIterator << ">;\n";
+            out << "auto own = search(" << ind << ", h.hints_" << indNum << "_lower, h.hints_" << indNum
+                << "_upper);\n";
+            out << "if (base == nullptr) {\n";
+            out << "return make_range(chain(own.begin()), chain(own.end()));\n";
             out << "}\n";
+            out << "auto inBase = search(base->" << ind << ", h.base_hints_" << indNum
+                << "_lower, h.base_hints_" << indNum << "_upper);\n";
+            out << "return make_range(chain(inBase.begin(), inBase.end(), own.begin()), "
+                   "chain(own.end()));\n";
+        } else if (freezable) {
+            const std::string frozen = "frozen_" + std::to_string(indNum);
+            out << "if (frozen) {\n";
+            genSearch(frozen, "h.frozen_hints_" + std::to_string(indNum) + "_lower",
+                    "h.frozen_hints_" + std::to_string(indNum) + "_upper", freezableIterator);
+            out << "}\n";
+            genSearch(ind, "h.hints_" + std::to_string(indNum) + "_lower",
+                    "h.hints_" + std::to_string(indNum) + "_upper", freezableIterator);
+        } else {
+            genSearch(ind, "h.hints_" + std::to_string(indNum) + "_lower",
+                    "h.hints_" + std::to_string(indNum) + "_upper");
         }
-        // if lower_bound > upper_bound then we return an empty range
-        out << "if (cmp > 0) {\n";
-        out << "    return make_range(ind_" << indNum << ".end(), ind_" << indNum << ".end());\n";
-        out << "}\n";
-        // otherwise use the general method
-        out << "return make_range(ind_" << indNum << ".lower_bound(lower, h.hints_" << indNum << "_lower"
-            << "), ind_" << indNum << ".upper_bound(upper, h.hints_" << indNum << "_upper"
-            << "));\n";
 
         out << "}\n";
 
-        out << "range<t_ind_" << indNum << "::iterator> lowerUpperRange_" << search;
+        out << rangeType << " lowerUpperRange_" << search;
         out << "(const t_tuple& lower, const t_tuple& upper) const {\n";
 
         out << "context h;\n";
@@ -460,28 +626,96 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
 
     // empty method
     out << "bool empty() const {\n";
-    out << "return ind_" << masterIndex << ".empty();\n";
+    if (isLayered) {
+        out << "return " << master << ".empty() && (base == nullptr || base->empty());\n";
+    } else if (freezable) {
+        out << "return frozen ? " << frozenMaster << ".empty() : " << master << ".empty();\n";
+    } else {
+        out << "return ind_" << masterIndex << ".empty();\n";
+    }
     out << "}\n";
 
     // partition method for parallelism
     out << "std::vector<range<iterator>> partition() const {\n";
-    out << "return ind_" << masterIndex << ".getChunks(400);\n";
+    if (isLayered) {
+        out << "std::vector<range<iterator>> res;\n";
+        out << "if (base != nullptr) {\n";
+        out << "for (const auto& chunk : base->" << master << ".getChunks(400)) {\n";
+        out << "res.push_back(make_range(iterator(chunk.begin(), chunk.end(), chunk.end()), "
+               "iterator(chunk.end())));\n";
+        out << "}\n";
+        out << "}\n";
+        out << "for (const auto& chunk : " << master << ".getChunks(400)) {\n";
+        out << "res.push_back(make_range(iterator(chunk.begin()), iterator(chunk.end())));\n";
+        out << "}\n";
+        out << "return res;\n";
+    } else if (freezable) {
+        out << "std::vector<range<iterator>> res;\n";
+        out << "if (frozen) {\n";
+        out << "for (const auto& chunk : " << frozenMaster << ".getChunks(400)) {\n";
+        out << "res.push_back(make_range(iterator(chunk.begin()), iterator(chunk.end())));\n";
+        out << "}\n";
+        out << "return res;\n";
+        out << "}\n";
+        out << "for (const auto& chunk : " << master << ".getChunks(400)) {\n";
+        out << "res.push_back(make_range(iterator(chunk.begin()), iterator(chunk.end())));\n";
+        out << "}\n";
+        out << "return res;\n";
+    } else {
+        out << "return ind_" << masterIndex << ".getChunks(400);\n";
+    }
     out << "}\n";
 
     // purge method
     out << "void purge() {\n";
     for (size_t i = 0; i < numIndexes; i++) {
         out << "ind_" << i << ".clear();\n";
+        if (freezable) {
+            out << "frozen_" << i << ".clear();\n";
+        }
+    }
+    if (freezable) {
+        out << "frozen = false;\n";
+    }
+    out << "}\n";
+
+    // memory usage method
+    out << "std::size_t getMemoryUsage() const {\n";
+    out << "std::size_t usage = 0;\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "usage += ind_" << i << ".getMemoryUsage();\n";
+        if (freezable) {
+            out << "usage += frozen_" << i << ".getMemoryUsage();\n";
+        }
     }
+    out << "return usage;\n";
     out << "}\n";
 
     // begin and end iterators
     out << "iterator begin() const {\n";
-    out << "return ind_" << masterIndex << ".begin();\n";
+    if (isLayered) {
+        out << "if (base != nullptr) {\n";
+        out << "return iterator(base->" << master << ".begin(), base->" << master << ".end(), " << master
+            << ".begin());\n";
+        out << "}\n";
+        out << "return iterator(" << master << ".begin());\n";
+    } else if (freezable) {
+        out << "if (frozen) return " << frozenMaster << ".begin();\n";
+        out << "return " << master << ".begin();\n";
+    } else {
+        out << "return ind_" << masterIndex << ".begin();\n";
+    }
     out << "}\n";
 
     out << "iterator end() const {\n";
-    out << "return ind_" << masterIndex << ".end();\n";
+    if (isLayered) {
+        out << "return iterator(" << master << ".end());\n";
+    } else if (freezable) {
+        out << "if (frozen) return " << frozenMaster << ".end();\n";
+        out << "return " << master << ".end();\n";
+    } else {
+        out << "return ind_" << masterIndex << ".end();\n";
+    }
     out << "}\n";
 
     // copyIndex method
@@ -497,6 +731,12 @@ void DirectRelation::generateTypeStruct(std::ostream& out) {
 
     // printStatistics method
     out << "void printStatistics(std::ostream& o) const {\n";
+    if (freezable) {
+        out << "if (frozen) {\n";
+        out << "o << \" arity " << arity << " frozen relation of \" << getMemoryUsage() << \" bytes\\n\";\n";
+        out << "return;\n";
+        out << "}\n";
+    }
     for (size_t i = 0; i < numIndexes; i++) {
         out << "o << \" arity " << arity << " direct b-tree index " << i << " lex-order " << inds[i]
             << "\\n\";\n";
@@ -645,9 +885,11 @@ void IndirectRelation::generateTypeStruct(std::ostream& out) {
         out << "};\n";
 
         if (ind.size() == arity) {
-            out << "using t_ind_" << i << " = btree_set<const t_tuple*," << comparator << ">;\n";
+            out << "using t_ind_" << i << " = btree_set<const t_tuple*," << comparator
+                << ",PoolAllocator<const t_tuple*>>;\n";
         } else {
-            out << "using t_ind_" << i << " = btree_multiset<const t_tuple*," << comparator << ">;\n";
+            out << "using t_ind_" << i << " = btree_multiset<const t_tuple*," << comparator
+                << ",PoolAllocator<const t_tuple*>>;\n";
         }
 
         out << "t_ind_" << i << " ind_" << i << ";\n";
@@ -822,6 +1064,15 @@ void IndirectRelation::generateTypeStruct(std::ostream& out) {
     out << "dataTable.clear();\n";
     out << "}\n";
 
+    // memory usage method, with the tuples referenced by the indexes
+    out << "std::size_t getMemoryUsage() const {\n";
+    out << "std::size_t usage = dataTable.size() * sizeof(t_tuple);\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "usage += ind_" << i << ".getMemoryUsage();\n";
+    }
+    out << "return usage;\n";
+    out << "}\n";
+
     // begin and end iterators
     out << "iterator begin() const {\n";
     out << "return ind_" << masterIndex << ".begin();\n";
@@ -844,6 +1095,373 @@ void IndirectRelation::generateTypeStruct(std::ostream& out) {
     out << "};\n";
 }
 
+// -------- Compact Indexed B-Tree Relation --------
+
+bool CompactRelation::isPreferable(
+        const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection) {
+    const auto& inds = indexSelection.getAllOrders();
+    const size_t arity = ramRel.getArity();
+    if (inds.size() < 2) {
+        return false;
+    }
+
+    // words stored per tuple: the direct representation keeps a full tuple in every index, while
+    // the compact one keeps it in the row store only, a pointer to its row in the primary index,
+    // and the columns of their lex-order plus a row id in the secondary indexes
+    size_t direct = inds.size() * arity;
+    size_t compact = arity + sizeof(void*) / sizeof(RamDomain);
+    bool hasFull = false;
+    for (const auto& ind : inds) {
+        if (!hasFull && ind.size() == arity) {
+            hasFull = true;
+        } else {
+            compact += ind.size() + 1;
+        }
+    }
+
+    // searches and scans pay an indirection per tuple, so the saving must be substantial
+    return hasFull && 4 * compact <= 3 * direct;
+}
+
+/** Generate index set for a compact indexed relation */
+void CompactRelation::computeIndices() {
+    assert(!isProvenance && "compact indexes cannot used for provenance");
+
+    // Generate and set indices
+    auto inds = indexSelection.getAllOrders();
+
+    // generate a full index if no indices exist
+    assert(!inds.empty() && "no full index in relation");
+
+    // check for full index
+    for (size_t i = 0; i < inds.size(); i++) {
+        auto& ind = inds[i];
+        if (ind.size() == getArity()) {
+            masterIndex = i;
+            break;
+        }
+    }
+    assert(masterIndex < inds.size() && "no full index in relation");
+    computedIndices = inds;
+}
+
+/** Generate type name of a compact indexed relation */
+std::string CompactRelation::getTypeName() {
+    // collect all attributes used in the lex-order
+    std::unordered_set<uint32_t> attributesUsed;
+    for (auto& ind : getIndices()) {
+        for (auto& attr : ind) {
+            attributesUsed.insert(attr);
+        }
+    }
+
+    std::stringstream res;
+    res << "t_rowbtree_" << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
+
+    for (auto& ind : getIndices()) {
+        res << "__" << join(ind, "_");
+    }
+
+    for (auto& search : indexSelection.getSearches()) {
+        res << "__" << search;
+    }
+
+    return res.str();
+}
+
+/** Generate type struct of a compact indexed relation */
+void CompactRelation::generateTypeStruct(std::ostream& out) {
+    size_t arity = getArity();
+    const auto& inds = getIndices();
+    auto types = relation.getAttributeTypes();
+    size_t numIndexes = inds.size();
+    std::map<LexOrder, int> indexToNumMap;
+
+    std::vector<std::string> typecasts;
+    typecasts.reserve(types.size());
+    for (auto type : types) {
+        switch (type[0]) {
+            case 'f': typecasts.push_back("ramBitCast<RamFloat>"); break;
+            case 'u': typecasts.push_back("ramBitCast<RamUnsigned>"); break;
+            default: typecasts.push_back("ramBitCast<RamSigned>");
+        }
+    }
+
+    // generate a comparator of the given key type comparing the given columns with the given casts,
+    // where the keys of the primary index are pointers to rows
+    auto genstruct = [&](const std::string& name, const std::string& key, const std::vector<size_t>& columns,
+                             const std::vector<std::string>& casts, bool isPointer = false) {
+        const std::string a = isPointer ? "(*a)" : "a";
+        const std::string b = isPointer ? "(*b)" : "b";
+        const std::string param = "const " + key + (isPointer ? " " : "& ");
+        out << "struct " << name << "{\n";
+        if (!isPointer && casts[0] == "ramBitCast<RamSigned>") {
+            out << " static constexpr int leading_column = " << columns[0] << ";\n";
+        }
+        out << " int operator()(" << param << "a, " << param << "b) const {\n";
+        out << "  return ";
+        for (size_t i = 0; i < columns.size(); i++) {
+            const auto lhs = casts[i] + "(" + a + "[" + std::to_string(columns[i]) + "])";
+            const auto rhs = casts[i] + "(" + b + "[" + std::to_string(columns[i]) + "])";
+            out << "(" << lhs << " < " << rhs << ") ? -1 : (" << lhs << " > " << rhs << ") ? 1 :(";
+        }
+        out << "0" << std::string(columns.size(), ')') << ";\n }\n";
+        out << "bool less(" << param << "a, " << param << "b) const {\n";
+        out << "  return operator()(a, b) < 0;\n }\n";
+        out << "bool equal(" << param << "a, " << param << "b) const {\n";
+        out << "return ";
+        for (size_t i = 0; i < columns.size(); i++) {
+            const auto column = std::to_string(columns[i]);
+            out << (i > 0 ? "&&" : "") << "(" << casts[i] << "(" << a << "[" << column << "]) == " << casts[i]
+                << "(" << b << "[" << column << "]))";
+        }
+        out << ";\n }\n";
+        out << "};\n";
+    };
+
+    // struct definition
+    out << "struct " << getTypeName() << " {\n";
+    out << "static constexpr Relation::arity_type Arity = " << arity << ";\n";
+
+    // stored tuple type
+    out << "using t_tuple = Tuple<RamDomain, " << arity << ">;\n";
+
+    // rows referenced by all indexes
+    out << "RowStore<" << arity << "> rows;\n";
+
+    // btree types
+    for (size_t i = 0; i < numIndexes; i++) {
+        const auto& ind = inds[i];
+
+        if (i < indexSelection.getAllOrders().size()) {
+            indexToNumMap[indexSelection.getAllOrders()[i]] = i;
+        }
+
+        std::string comparator = "t_comparator_" + std::to_string(i);
+        std::vector<std::string> casts;
+        for (auto attrib : ind) {
+            casts.push_back(typecasts[attrib]);
+        }
+        if (i == masterIndex) {
+            // the primary index stores pointers to rows, which do not move
+            genstruct(comparator, "t_tuple*", std::vector<size_t>(ind.begin(), ind.end()), casts, true);
+            out << "using t_ind_" << i << " = btree_set<const t_tuple*," << comparator
+                << ",PoolAllocator<const t_tuple*>>;\n";
+        } else {
+            // secondary indexes store the columns of their lex-order followed by a row id
+            std::vector<size_t> columns(ind.size() + 1);
+            for (size_t j = 0; j < columns.size(); j++) {
+                columns[j] = j;
+            }
+            casts.push_back("ramBitCast<RamUnsigned>");
+            out << "using t_key_" << i << " = Tuple<RamDomain, " << ind.size() + 1 << ">;\n";
+            genstruct(comparator, "t_key_" + std::to_string(i), columns, casts);
+            out << "using t_ind_" << i << " = btree_set<t_key_" << i << "," << comparator
+                << ",PoolAllocator<t_key_" << i << ">>;\n";
+            out << "using iterator_" << i << " = RowStore<" << arity << ">::iterator<t_ind_" << i
+                << "::iterator>;\n";
+        }
+        out << "t_ind_" << i << " ind_" << i << ";\n";
+    }
+
+    // typedef deref iterator of the master index to be struct iterator
+    out << "using iterator = IterDerefWrapper<typename t_ind_" << masterIndex << "::iterator>;\n";
+
+    // create a struct storing hints for each btree
+    out << "struct context {\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "t_ind_" << i << "::operation_hints hints_" << i << "_lower;\n";
+        out << "t_ind_" << i << "::operation_hints hints_" << i << "_upper;\n";
+    }
+    out << "};\n";
+    out << "context createContext() { return context(); }\n";
+
+    // generate the key of a secondary index for a tuple and a row id
+    auto genkey = [&](size_t i, const std::string& tuple, const std::string& row) {
+        out << "t_key_" << i << "{{";
+        for (auto attrib : inds[i]) {
+            out << tuple << "[" << attrib << "],";
+        }
+        out << row << "}}";
+    };
+
+    // insert methods
+    out << "bool insert(const t_tuple& t) {\n";
+    out << "context h;\n";
+    out << "return insert(t, h);\n";
+    out << "}\n";  // end of insert(t_tuple&)
+
+    out << "bool insert(const t_tuple& t, context& h) {\n";
+    out << "if (contains(t, h)) {\n";
+    out << "return false;\n";
+    out << "}\n";
+    // a row appended by a concurrent insertion of the same tuple stays unreferenced
+    out << "RamDomain row = rows.append(t);\n";
+    out << "if (!ind_" << masterIndex << ".insert(&rows[row], h.hints_" << masterIndex << "_lower)) {\n";
+    out << "return false;\n";
+    out << "}\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        if (i != masterIndex) {
+            out << "ind_" << i << ".insert(";
+            genkey(i, "t", "row");
+            out << ", h.hints_" << i << "_lower);\n";
+        }
+    }
+    out << "return true;\n";
+    out << "}\n";  // end of insert(t_tuple&, context&)
+
+    out << "bool insert(const RamDomain* ramDomain) {\n";
+    out << "RamDomain data[" << arity << "];\n";
+    out << "std::copy(ramDomain, ramDomain + " << arity << ", data);\n";
+    out << "const t_tuple& tuple = reinterpret_cast<const t_tuple&>(data);\n";
+    out << "context h;\n";
+    out << "return insert(tuple, h);\n";
+    out << "}\n";  // end of insert(RamDomain*)
+
+    std::vector<std::string> decls;
+    std::vector<std::string> params;
+    for (size_t i = 0; i < arity; i++) {
+        decls.push_back("RamDomain a" + std::to_string(i));
+        params.push_back("a" + std::to_string(i));
+    }
+    out << "bool insert(" << join(decls, ",") << ") {\n";
+    out << "RamDomain data[" << arity << "] = {" << join(params, ",") << "};\n";
+    out << "return insert(data);\n";
+    out << "}\n";  // end of insert(RamDomain x1, RamDomain x2, ...)
+
+    // contains methods
+    out << "bool contains(const t_tuple& t, context& h) const {\n";
+    out << "return ind_" << masterIndex << ".contains(&t, h.hints_" << masterIndex << "_lower);\n";
+    out << "}\n";
+
+    out << "bool contains(const t_tuple& t) const {\n";
+    out << "context h;\n";
+    out << "return contains(t, h);\n";
+    out << "}\n";
+
+    // size method
+    out << "std::size_t size() const {\n";
+    out << "return ind_" << masterIndex << ".size();\n";
+    out << "}\n";
+
+    // find methods
+    out << "iterator find(const t_tuple& t, context& h) const {\n";
+    out << "return ind_" << masterIndex << ".find(&t, h.hints_" << masterIndex << "_lower);\n";
+    out << "}\n";
+
+    out << "iterator find(const t_tuple& t) const {\n";
+    out << "context h;\n";
+    out << "return find(t, h);\n";
+    out << "}\n";
+
+    // empty lowerUpperRange method
+    out << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
+        << "(const t_tuple& /* lower */, const t_tuple& /* upper */, context& /* h */) const {\n";
+    out << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    out << "}\n";
+
+    out << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
+        << "(const t_tuple& /* lower */, const t_tuple& /* upper */) const {\n";
+    out << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    out << "}\n";
+
+    // lowerUpperRange methods for each pattern which is used to search this relation
+    for (auto search : indexSelection.getSearches()) {
+        auto& lexOrder = indexSelection.getLexOrder(search);
+        size_t indNum = indexToNumMap[lexOrder];
+        std::string iteratorType =
+                indNum == masterIndex ? "iterator" : "iterator_" + std::to_string(indNum);
+
+        out << "range<" << iteratorType << "> lowerUpperRange_" << search;
+        out << "(const t_tuple& lower, const t_tuple& upper, context& h) const {\n";
+
+        out << "t_comparator_" << indNum << " comparator;\n";
+        if (indNum == masterIndex) {
+            out << "int cmp = comparator(&lower, &upper);\n";
+            out << "if (cmp > 0) {\n";
+            out << "    return range<iterator>(ind_" << indNum << ".end(), ind_" << indNum << ".end());\n";
+            out << "}\n";
+            out << "return range<iterator>(ind_" << indNum << ".lower_bound(&lower, h.hints_" << indNum
+                << "_lower), ind_" << indNum << ".upper_bound(&upper, h.hints_" << indNum << "_upper));\n";
+        } else {
+            // the bounds cover all row ids of the searched columns
+            out << "auto lowerKey = ";
+            genkey(indNum, "lower", "ramBitCast(MIN_RAM_UNSIGNED)");
+            out << ";\n";
+            out << "auto upperKey = ";
+            genkey(indNum, "upper", "ramBitCast(MAX_RAM_UNSIGNED)");
+            out << ";\n";
+            out << "int cmp = comparator(lowerKey, upperKey);\n";
+            out << "if (cmp > 0) {\n";
+            out << "    return make_range(rows.wrap(ind_" << indNum << ".end()), rows.wrap(ind_" << indNum
+                << ".end()));\n";
+            out << "}\n";
+            out << "return make_range(rows.wrap(ind_" << indNum << ".lower_bound(lowerKey, h.hints_" << indNum
+                << "_lower)), rows.wrap(ind_" << indNum << ".upper_bound(upperKey, h.hints_" << indNum
+                << "_upper)));\n";
+        }
+        out << "}\n";
+
+        out << "range<" << iteratorType << "> lowerUpperRange_" << search;
+        out << "(const t_tuple& lower, const t_tuple& upper) const {\n";
+        out << "context h;\n";
+        out << "return lowerUpperRange_" << search << "(lower,upper,h);\n";
+        out << "}\n";
+    }
+
+    // empty method
+    out << "bool empty() const {\n";
+    out << "return ind_" << masterIndex << ".empty();\n";
+    out << "}\n";
+
+    // partition method for parallelism
+    out << "std::vector<range<iterator>> partition() const {\n";
+    out << "std::vector<range<iterator>> res;\n";
+    out << "for (const auto& cur : ind_" << masterIndex << ".getChunks(400)) {\n";
+    out << "    res.push_back(make_range(derefIter(cur.begin()), derefIter(cur.end())));\n";
+    out << "}\n";
+    out << "return res;\n";
+    out << "}\n";
+
+    // purge method
+    out << "void purge() {\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "ind_" << i << ".clear();\n";
+    }
+    out << "rows.clear();\n";
+    out << "}\n";
+
+    // memory usage method, with the rows referenced by the indexes
+    out << "std::size_t getMemoryUsage() const {\n";
+    out << "std::size_t usage = rows.getMemoryUsage();\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "usage += ind_" << i << ".getMemoryUsage();\n";
+    }
+    out << "return usage;\n";
+    out << "}\n";
+
+    // begin and end iterators
+    out << "iterator begin() const {\n";
+    out << "return ind_" << masterIndex << ".begin();\n";
+    out << "}\n";
+
+    out << "iterator end() const {\n";
+    out << "return ind_" << masterIndex << ".end();\n";
+    out << "}\n";
+
+    // printStatistics method
+    out << "void printStatistics(std::ostream& o) const {\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "o << \" arity " << arity << " compact b-tree index " << i << " lex-order " << inds[i]
+            << "\\n\";\n";
+        out << "ind_" << i << ".printStats(o);\n";
+    }
+    out << "}\n";
+
+    // end struct
+    out << "};\n";
+}
+
 // -------- Brie Relation --------
 
 /** Generate index set for a brie relation */
@@ -1096,6 +1714,15 @@ void BrieRelation::generateTypeStruct(std::ostream& out) {
     }
     out << "}\n";
 
+    // memory usage method
+    out << "std::size_t getMemoryUsage() const {\n";
+    out << "std::size_t usage = 0;\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "usage += ind_" << i << ".getMemoryUsage();\n";
+    }
+    out << "return usage;\n";
+    out << "}\n";
+
     // begin and end iterators
     out << "iterator begin() const {\n";
     out << "return iterator_" << masterIndex << "(ind_" << masterIndex << ".begin());\n";
@@ -1317,6 +1944,15 @@ void EqrelRelation::generateTypeStruct(std::ostream& out) {
     }
     out << "}\n";
 
+    // memory usage method
+    out << "std::size_t getMemoryUsage() const {\n";
+    out << "std::size_t usage = 0;\n";
+    for (size_t i = 0; i < numIndexes; i++) {
+        out << "usage += ind_" << i << ".getMemoryUsage();\n";
+    }
+    out << "return usage;\n";
+    out << "}\n";
+
     // begin and end iterators
     out << "iterator begin() const {\n";
     out << "return iterator_" << masterIndex << "(ind_" << masterIndex << ".begin());\n";
@@ -119,13 +119,21 @@ public:
 
 class DirectRelation : public Relation {
 public:
-    DirectRelation(
-            const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection, bool isProvenance)
-            : Relation(ramRel, indexSelection, isProvenance) {}
+    DirectRelation(const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection,
+            bool isProvenance, bool freezable = false)
+            : Relation(ramRel, indexSelection, isProvenance), freezable(freezable) {}
 
     void computeIndices() override;
     std::string getTypeName() override;
     void generateTypeStruct(std::ostream& out) override;
+
+    /** Whether the relation can be frozen into compressed indexes once it is computed */
+    bool isFreezable() const {
+        return freezable;
+    }
+
+private:
+    const bool freezable;
 };
 
 class IndirectRelation : public Relation {
@@ -139,6 +147,25 @@ public:
     void generateTypeStruct(std::ostream& out) override;
 };
 
+/**
+ * A b-tree relation storing its tuples once in a row store, while its primary index only
+ * stores pointers to the rows, and its secondary indexes the columns of their lex-order and
+ * a row id.
+ */
+class CompactRelation : public Relation {
+public:
+    CompactRelation(
+            const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection, bool isProvenance)
+            : Relation(ramRel, indexSelection, isProvenance) {}
+
+    void computeIndices() override;
+    std::string getTypeName() override;
+    void generateTypeStruct(std::ostream& out) override;
+
+    /** Whether the compact representation is expected to pay off for the given indexes */
+    static bool isPreferable(const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection);
+};
+
 class BrieRelation : public Relation {
 public:
     BrieRelation(
@@ -19,7 +19,9 @@
 #include "FunctorOps.h"
 #include "Global.h"
 #include "RelationTag.h"
+#include "ram/AbstractExistenceCheck.h"
 #include "ram/AbstractParallel.h"
+#include "ram/Adaptive.h"
 #include "ram/Aggregate.h"
 #include "ram/AutoIncrement.h"
 #include "ram/Break.h"
@@ -29,18 +31,21 @@
 #include "ram/Condition.h"
 #include "ram/Conjunction.h"
 #include "ram/Constraint.h"
+#include "ram/Dataflow.h"
 #include "ram/DebugInfo.h"
 #include "ram/EmptinessCheck.h"
 #include "ram/ExistenceCheck.h"
 #include "ram/Exit.h"
 #include "ram/Expression.h"
 #include "ram/Extend.h"
+#include "ram/Facts.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
 #include "ram/FloatConstant.h"
 #include "ram/IO.h"
 #include "ram/IndexAggregate.h"
 #include "ram/IndexChoice.h"
+#include "ram/IndexOperation.h"
 #include "ram/IndexScan.h"
 #include "ram/IntrinsicOperator.h"
 #include "ram/LogRelationTimer.h"
@@ -83,6 +88,7 @@
 #include "ram/UnsignedConstant.h"
 #include "ram/UserDefinedOperator.h"
 #include "ram/analysis/Index.h"
+#include "ram/utility/ExecutionOrder.h"
 #include "ram/utility/Utils.h"
 #include "ram/utility/Visitor.h"
 #include "souffle/BinaryConstraintOps.h"
@@ -105,6 +111,8 @@
 #include <iterator>
 #include <limits>
 #include <map>
+#include <regex>
+#include <set>
 #include <sstream>
 #include <tuple>
 #include <type_traits>
@@ -116,6 +124,7 @@ namespace souffle::synthesiser {
 
 using json11::Json;
 using ram::analysis::IndexAnalysis;
+using ram::analysis::SearchSignature;
 using namespace ram;
 using namespace stream_write_qualified_char_as_number;
 
@@ -130,7 +139,7 @@ unsigned Synthesiser::lookupFreqIdx(const std::string& txt) {
     }
 }
 
-/** Lookup frequency counter */
+/** Lookup read counter */
 size_t Synthesiser::lookupReadIdx(const std::string& txt) {
     std::string modifiedTxt = txt;
     std::replace(modifiedTxt.begin(), modifiedTxt.end(), '-', '.');
@@ -143,6 +152,18 @@ size_t Synthesiser::lookupReadIdx(const std::string& txt) {
     }
 }
 
+/** Lookup search counter */
+size_t Synthesiser::lookupSearchIdx(const std::string& relName, const SearchSignature& search) {
+    std::string txt = relName + ";" + toString(search);
+    auto pos = searchIdxMap.find(txt);
+    if (pos == searchIdxMap.end()) {
+        size_t idx = searchIdxMap.size();
+        return searchIdxMap[txt] = idx;
+    } else {
+        return pos->second;
+    }
+}
+
 /** Convert RAM identifier */
 const std::string Synthesiser::convertRamIdent(const std::string& name) {
     auto it = identifiers.find(name);
@@ -221,6 +242,93 @@ std::set<const ram::Relation*> Synthesiser::getReferencedRelations(const Operati
     return res;
 }
 
+/** Get relations computed without negation, aggregation and choice domains */
+std::set<std::string> Synthesiser::getMonotoneRelations(const ram::Program& prog) {
+    // the semi-naive copies of a relation stand for the relation itself
+    auto original = [](const std::string& name) {
+        for (const std::string& prefix : {std::string("@delta_"), std::string("@new_")}) {
+            if (name.rfind(prefix, 0) == 0) {
+                return name.substr(prefix.size());
+            }
+        }
+        return name;
+    };
+
+    std::set<std::string> nonMonotone;
+    std::map<std::string, std::set<std::string>> sources;
+    std::vector<const Statement*> statements{&prog.getMain()};
+    visitDepthFirst(prog.getMain(), [&](const Call& call) {
+        statements.push_back(&prog.getSubroutine(call.getName()));
+    });
+    for (const Statement* stmt : statements) {
+        visitDepthFirst(*stmt, [&](const Query& query) {
+            std::set<std::string> targets;
+            std::set<std::string> reads;
+            bool monotone = true;
+            std::size_t emptinessChecks = 0;
+            std::size_t negatedEmptinessChecks = 0;
+            visitDepthFirst(query, [&](const Node& node) {
+                if (auto project = as<Project>(node)) {
+                    targets.insert(original(project->getRelation()));
+                } else if (auto scan = as<RelationOperation>(node)) {
+                    reads.insert(original(scan->getRelation()));
+                    monotone = monotone && !isA<Aggregate>(node) && !isA<IndexAggregate>(node);
+                } else if (auto exists = as<AbstractExistenceCheck>(node)) {
+                    reads.insert(original(exists->getRelation()));
+                } else if (auto emptiness = as<EmptinessCheck>(node)) {
+                    reads.insert(original(emptiness->getRelation()));
+                    emptinessChecks++;
+                }
+            });
+            visitDepthFirst(query, [&](const Negation& negation) {
+                const Condition* operand = &negation.getOperand();
+                if (isA<EmptinessCheck>(operand)) {
+                    negatedEmptinessChecks++;
+                } else if (auto exists = as<AbstractExistenceCheck>(operand)) {
+                    // a negated check of the inserted relation only drops known tuples, unless it
+                    // leaves attributes undefined to look up the key of a choice domain
+                    const auto values = exists->getValues();
+                    monotone = monotone && contains(targets, original(exists->getRelation())) &&
+                               std::none_of(values.begin(), values.end(), isUndefValue);
+                }
+            });
+            // an emptiness check that is not negated is the negation of a nullary atom
+            monotone = monotone && emptinessChecks == negatedEmptinessChecks;
+            for (const std::string& target : targets) {
+                sources[target].insert(reads.begin(), reads.end());
+                if (!monotone) {
+                    nonMonotone.insert(target);
+                }
+            }
+        });
+    }
+
+    // relations computed from relations that are not monotone are not monotone either
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto& [target, reads] : sources) {
+            if (contains(nonMonotone, target)) {
+                continue;
+            }
+            for (const std::string& read : reads) {
+                if (contains(nonMonotone, read)) {
+                    nonMonotone.insert(target);
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::set<std::string> monotone;
+    for (const ram::Relation* rel : prog.getRelations()) {
+        if (!rel->isTemp() && !contains(nonMonotone, rel->getName())) {
+            monotone.insert(rel->getName());
+        }
+    }
+    return monotone;
+}
+
 void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
     class CodeEmitter : public ram::Visitor<void, Node const, std::ostream&> {
     private:
@@ -263,6 +371,14 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             };
         }
 
+        /** Get the statement counting a search of a relation for the frequency profile */
+        std::string getSearchCounter(const ram::Relation& rel, const SearchSignature& keys) {
+            if (!Global::config().has("profile") || !Global::config().has("profile-frequency")) {
+                return "";
+            }
+            return "searches[" + std::to_string(synthesiser.lookupSearchIdx(rel.getName(), keys)) + "]++;\n";
+        }
+
         std::pair<std::stringstream, std::stringstream> getPaddedRangeBounds(const ram::Relation& rel,
                 const std::vector<Expression*>& rangePatternLower,
                 const std::vector<Expression*>& rangePatternUpper) {
@@ -343,10 +459,53 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             const auto& directives = io.getDirectives();
             const std::string& op = io.get("operation");
+
+            // relations are spilled to disk regardless of performIO
+            if (op == "spill" || op == "restore") {
+                const std::string& relName =
+                        synthesiser.getRelationName(synthesiser.lookup(io.getRelation()));
+                out << "try {";
+                out << "std::map<std::string, std::string> directiveMap(";
+                printDirectives(directives);
+                out << ");\n";
+                if (op == "spill") {
+                    // relations are only spilled while the memory limit is exceeded
+                    out << "if (!spillStore.isSpilled(directiveMap[\"name\"]) && "
+                           "spillStore.exceeds(getMemoryUsage())) {\n";
+                    if (Global::config().has("async-output")) {
+                        out << "writeQueue.wait(" << relName << ".get());\n";
+                    }
+                    // record the memory saved by compressing the spilled relation
+                    const bool profileCompression =
+                            Global::config().has("profile") && Global::config().has("compress-spills");
+                    if (profileCompression) {
+                        out << "const std::size_t rawUsage = " << relName << "->getMemoryUsage();\n";
+                    }
+                    out << "spillStore.spill(*" << relName << ", directiveMap, symTable, recordTable);\n";
+                    if (profileCompression) {
+                        out << "const std::string event = \"@relation-spill;\" + directiveMap[\"name\"];\n";
+                        out << "ProfileEventSingleton::instance().makeQuantityEvent(event + \";raw\", "
+                               "rawUsage, 0);\n";
+                        out << "ProfileEventSingleton::instance().makeQuantityEvent(event + \";compressed\", "
+                               "spillStore.getCompressedMemoryUsage(directiveMap[\"name\"]), 0);\n";
+                    }
+                    out << "}\n";
+                } else {
+                    out << "spillStore.restore(*" << relName << ", directiveMap, symTable, recordTable);\n";
+                }
+                out << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+                PRINT_END_COMMENT(out);
+                return;
+            }
+
             out << "if (performIO) {\n";
 
             // get some table details
-            if (op == "input") {
+            if (op == "input" && directives.count("prefetch") > 0) {
+                // the relation has been read ahead
+                out << "readQueue.wait("
+                    << synthesiser.getRelationName(synthesiser.lookup(io.getRelation())) << ".get());\n";
+            } else if (op == "input") {
                 out << "try {";
                 out << "std::map<std::string, std::string> directiveMap(";
                 printDirectives(directives);
@@ -361,7 +520,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 out << "} catch (std::exception& e) {std::cerr << \"Error loading data: \" << e.what() "
                        "<< "
                        "'\\n';}\n";
-            } else if (op == "output" || op == "printsize") {
+            } else if (op == "output" || op == "printsize" || op == "statistics") {
                 out << "try {";
                 out << "std::map<std::string, std::string> directiveMap(";
                 printDirectives(directives);
@@ -369,10 +528,18 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 out << R"_(if (!outputDirectory.empty()) {)_";
                 out << R"_(directiveMap["output-dir"] = outputDirectory;)_";
                 out << "}\n";
+                const std::string& relName =
+                        synthesiser.getRelationName(synthesiser.lookup(io.getRelation()));
+                if (directives.count("async") > 0) {
+                    // the relation is written in the background until it is cleared
+                    out << "writeQueue.submit(" << relName << ".get(), [this, directiveMap]() {\n";
+                }
                 out << "IOSystem::getInstance().getWriter(";
                 out << "directiveMap, symTable, recordTable";
-                out << ")->writeAll(*" << synthesiser.getRelationName(synthesiser.lookup(io.getRelation()))
-                    << ");\n";
+                out << ")->writeAll(*" << relName << ");\n";
+                if (directives.count("async") > 0) {
+                    out << "});\n";
+                }
                 out << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
             } else {
                 assert("Wrong i/o operation");
@@ -475,11 +642,44 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
         void visit_(type_identity<Clear>, const Clear& clear, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
 
+            const std::string& relName = synthesiser.getRelationName(synthesiser.lookup(clear.getRelation()));
             if (!synthesiser.lookup(clear.getRelation())->isTemp()) {
                 out << "if (performIO) ";
             }
-            out << synthesiser.getRelationName(synthesiser.lookup(clear.getRelation())) << "->"
-                << "purge();\n";
+            if (Global::config().has("async-output")) {
+                // wait for the relation to be written
+                out << "{ writeQueue.wait(" << relName << ".get()); ";
+                out << relName << "->purge(); }\n";
+            } else {
+                out << relName << "->purge();\n";
+            }
+
+            PRINT_END_COMMENT(out);
+        }
+
+        void visit_(type_identity<Facts>, const Facts& facts, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+
+            const std::string& relName = synthesiser.getRelationName(synthesiser.lookup(facts.getRelation()));
+            const auto& values = facts.getValues();
+            const std::size_t arity = facts.getArity();
+
+            // the values as unsigned bit patterns, which are valid literals for all types
+            out << "{\n";
+            out << "static const RamUnsigned facts[] = {";
+            for (std::size_t i = 0; i < values.size(); i++) {
+                out << (i % 16 == 0 ? "\n" : "") << ramBitCast<RamUnsigned>(values[i]) << "u,";
+            }
+            out << "\n};\n";
+            out << "auto ctxt = " << relName << "->createContext();\n";
+            out << "Tuple<RamDomain," << arity << "> tuple;\n";
+            out << "for (std::size_t i = 0; i < " << values.size() << "; i += " << arity << ") {\n";
+            out << "for (std::size_t j = 0; j < " << arity << "; j++) {\n";
+            out << "tuple[j] = ramBitCast<RamDomain>(facts[i + j]);\n";
+            out << "}\n";
+            out << relName << "->insert(tuple, ctxt);\n";
+            out << "}\n";
+            out << "}\n";
 
             PRINT_END_COMMENT(out);
         }
@@ -536,6 +736,57 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        void visit_(type_identity<Adaptive>, const Adaptive& adaptive, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            auto costs = adaptive.getCosts();
+            auto stmts = adaptive.getStatements();
+
+            // evaluate the costs and execute the cheapest alternative
+            out << "{\n";
+            out << "const RamDomain cost[] = {" << join(costs, ",", [&](auto& os, const Expression* cost) {
+                visit(*cost, os);
+            }) << "};\n";
+            out << "std::size_t choice = 0;\n";
+            out << "for (std::size_t i = 1; i < " << costs.size() << "; i++) {\n";
+            out << "if (cost[i] < cost[choice]) choice = i;\n";
+            out << "}\n";
+            for (size_t i = 0; i < stmts.size(); i++) {
+                out << (i == 0 ? "" : "else ") << "if (choice == " << i << ") {\n";
+                visit(*stmts[i], out);
+                out << "}\n";
+            }
+            out << "}\n";
+            PRINT_END_COMMENT(out);
+        }
+
+        void visit_(type_identity<Dataflow>, const Dataflow& dataflow, std::ostream& out) override {
+            PRINT_BEGIN_COMMENT(out);
+            auto stmts = dataflow.getStatements();
+            const auto& predecessors = dataflow.getPredecessors();
+
+            // execute each step once the steps it depends on have finished
+            out << "{\n";
+            out << "std::vector<std::vector<std::size_t>> predecessors(" << stmts.size() << ");\n";
+            for (size_t i = 0; i < stmts.size(); i++) {
+                if (!predecessors[i].empty()) {
+                    out << "predecessors[" << i << "] = {" << join(predecessors[i], ",") << "};\n";
+                }
+            }
+            out << "DataflowScheduler scheduler(predecessors, " << dataflow.getConcurrencyLimit() << ");\n";
+            out << "scheduler.run([&](std::size_t step) {\n";
+            out << "switch (step) {\n";
+            for (size_t i = 0; i < stmts.size(); i++) {
+                out << "case " << i << ": {\n";
+                visit(*stmts[i], out);
+                out << "} break;\n";
+            }
+            out << "}\n";
+            out << "return true;\n";
+            out << "});\n";
+            out << "}\n";
+            PRINT_END_COMMENT(out);
+        }
+
         void visit_(type_identity<Loop>, const Loop& loop, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
             out << "iter = 0;\n";
@@ -666,9 +917,10 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_BEGIN_COMMENT(out);
 
             out << "auto part = " << relName << "->partition();\n";
+            out << "NumaChunkQueue<decltype(part)> queue(part);\n";
             out << "PARALLEL_START\n";
             out << preamble.str();
-            out << "pfor(auto it = part.begin(); it<part.end();++it){\n";
+            out << "for(auto* it = queue.next(); it != nullptr; it = queue.next()) {\n";
             out << "try{\n";
             out << "for(const auto& env0 : *it) {\n";
 
@@ -741,9 +993,10 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_BEGIN_COMMENT(out);
 
             out << "auto part = " << relName << "->partition();\n";
+            out << "NumaChunkQueue<decltype(part)> queue(part);\n";
             out << "PARALLEL_START\n";
             out << preamble.str();
-            out << "pfor(auto it = part.begin(); it<part.end();++it){\n";
+            out << "for(auto* it = queue.next(); it != nullptr; it = queue.next()) {\n";
             out << "try{\n";
             out << "for(const auto& env0 : *it) {\n";
             out << "if( ";
@@ -779,6 +1032,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(*rel) + ")";
             auto rangeBounds = getPaddedRangeBounds(*rel, rangePatternLower, rangePatternUpper);
 
+            out << getSearchCounter(*rel, keys);
             out << "auto range = " << relName << "->"
                 << "lowerUpperRange_" << keys << "(" << rangeBounds.first.str() << ","
                 << rangeBounds.second.str() << "," << ctxName << ");\n";
@@ -809,15 +1063,17 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             PRINT_BEGIN_COMMENT(out);
             auto rangeBounds = getPaddedRangeBounds(*rel, rangePatternLower, rangePatternUpper);
+            out << getSearchCounter(*rel, keys);
             out << "auto range = " << relName
                 << "->"
                 // TODO (b-scholz): context may be missing here?
                 << "lowerUpperRange_" << keys << "(" << rangeBounds.first.str() << ","
                 << rangeBounds.second.str() << ");\n";
             out << "auto part = range.partition();\n";
+            out << "NumaChunkQueue<decltype(part)> queue(part);\n";
             out << "PARALLEL_START\n";
             out << preamble.str();
-            out << "pfor(auto it = part.begin(); it<part.end(); ++it) { \n";
+            out << "for(auto* it = queue.next(); it != nullptr; it = queue.next()) {\n";
             out << "try{\n";
             out << "for(const auto& env0 : *it) {\n";
 
@@ -845,6 +1101,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(*rel) + ")";
             auto rangeBounds = getPaddedRangeBounds(*rel, rangePatternLower, rangePatternUpper);
 
+            out << getSearchCounter(*rel, keys);
             out << "auto range = " << relName << "->"
                 << "lowerUpperRange_" << keys << "(" << rangeBounds.first.str() << ","
                 << rangeBounds.second.str() << "," << ctxName << ");\n";
@@ -883,15 +1140,17 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             PRINT_BEGIN_COMMENT(out);
             auto rangeBounds = getPaddedRangeBounds(*rel, rangePatternLower, rangePatternUpper);
+            out << getSearchCounter(*rel, keys);
             out << "auto range = " << relName
                 << "->"
                 // TODO (b-scholz): context may be missing here?
                 << "lowerUpperRange_" << keys << "(" << rangeBounds.first.str() << ","
                 << rangeBounds.second.str() << ");\n";
             out << "auto part = range.partition();\n";
+            out << "NumaChunkQueue<decltype(part)> queue(part);\n";
             out << "PARALLEL_START\n";
             out << preamble.str();
-            out << "pfor(auto it = part.begin(); it<part.end(); ++it) { \n";
+            out << "for(auto* it = queue.next(); it != nullptr; it = queue.next()) {\n";
             out << "try{";
             out << "for(const auto& env0 : *it) {\n";
             out << "if( ";
@@ -959,6 +1218,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             // get range to aggregate
             auto keys = isa->getSearchSignature(&aggregate);
+            out << getSearchCounter(*rel, keys);
 
             // special case: counting number elements over an unrestricted predicate
             if (aggregate.getFunction() == AggregateOp::COUNT && keys.empty() &&
@@ -1170,6 +1430,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             // get range to aggregate
             auto keys = isa->getSearchSignature(&aggregate);
+            out << getSearchCounter(*rel, keys);
 
             // special case: counting number elements over an unrestricted predicate
             if (aggregate.getFunction() == AggregateOp::COUNT && keys.empty() &&
@@ -1819,9 +2080,13 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             auto arity = rel->getArity();
             assert(arity > 0 && "AstToRamTranslator failed");
             std::string after;
-            if (Global::config().has("profile") && Global::config().has("profile-frequency") &&
-                    !synthesiser.lookup(exists.getRelation())->isTemp()) {
-                out << R"_((reads[)_" << synthesiser.lookupReadIdx(rel->getName()) << R"_(]++,)_";
+            if (Global::config().has("profile") && Global::config().has("profile-frequency")) {
+                auto searchIdx =
+                        synthesiser.lookupSearchIdx(rel->getName(), isa->getSearchSignature(&exists));
+                out << "(searches[" << searchIdx << "]++,";
+                if (!rel->isTemp()) {
+                    out << R"_(reads[)_" << synthesiser.lookupReadIdx(rel->getName()) << R"_(]++,)_";
+                }
                 after = ")";
             }
 
@@ -2308,6 +2573,12 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 }
 
 void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& withSharedLibrary) {
+    std::vector<std::stringstream> noUnits;
+    generateCode(os, os, noUnits, "", id, withSharedLibrary);
+}
+
+void Synthesiser::generateCode(std::ostream& hs, std::ostream& os, std::vector<std::stringstream>& units,
+        const std::string& headerName, const std::string& id, bool& withSharedLibrary) {
     // ---------------------------------------------------------------
     //                      Auto-Index Generation
     // ---------------------------------------------------------------
@@ -2323,21 +2594,45 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     std::string classname = "Sf_" + id;
 
     // generate C++ program
+    const bool splitUnits = !units.empty();
+    if (splitUnits) {
+        hs << "#pragma once\n";
+        for (auto& unit : units) {
+            unit << "#include \"" << headerName << "\"\n";
+            unit << "namespace souffle {\n";
+        }
+    }
 
     if (Global::config().has("verbose")) {
-        os << "#define _SOUFFLE_STATS\n";
+        hs << "#define _SOUFFLE_STATS\n";
     }
-    os << "\n#include \"souffle/CompiledSouffle.h\"\n";
+    hs << "\n#include \"souffle/CompiledSouffle.h\"\n";
     if (Global::config().has("provenance")) {
-        os << "#include <mutex>\n";
-        os << "#include \"souffle/provenance/Explain.h\"\n";
+        hs << "#include <mutex>\n";
+        hs << "#include \"souffle/provenance/Explain.h\"\n";
     }
 
     if (Global::config().has("live-profile")) {
-        os << "#include <thread>\n";
-        os << "#include \"souffle/profile/Tui.h\"\n";
+        hs << "#include <thread>\n";
+        hs << "#include \"souffle/profile/Tui.h\"\n";
+    }
+
+    if (Global::config().has("prefetch-input")) {
+        hs << "#include \"souffle/io/ReadQueue.h\"\n";
+    }
+
+    if (Global::config().has("async-output")) {
+        hs << "#include \"souffle/io/WriteQueue.h\"\n";
+    }
+
+    if (Global::config().has("memory-limit") || Global::config().has("compress-spills")) {
+        hs << "#include \"souffle/io/SpillStore.h\"\n";
+    }
+
+    if (Global::config().has("concurrent-strata")) {
+        hs << "#include \"souffle/utility/DataflowScheduler.h\"\n";
     }
-    os << "\n";
+    hs << "\n";
     // produce external definitions for user-defined functors
     std::map<std::string, std::tuple<TypeAttribute, std::vector<TypeAttribute>, bool>> functors;
     visitDepthFirst(prog, [&](const UserDefinedOperator& op) {
@@ -2346,7 +2641,7 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         }
         withSharedLibrary = true;
     });
-    os << "extern \"C\" {\n";
+    hs << "extern \"C\" {\n";
     for (const auto& f : functors) {
         //        size_t arity = f.second.length() - 1;
         const std::string& name = f.first;
@@ -2370,20 +2665,20 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
         };
 
         if (stateful) {
-            os << "souffle::RamDomain " << name << "(souffle::SymbolTable *, souffle::RecordTable *";
+            hs << "souffle::RamDomain " << name << "(souffle::SymbolTable *, souffle::RecordTable *";
             for (size_t i = 0; i < argsTypes.size(); i++) {
-                os << ",souffle::RamDomain";
+                hs << ",souffle::RamDomain";
             }
-            os << ");\n";
+            hs << ");\n";
         } else {
-            tfm::format(os, "%s %s(%s);\n", cppTypeDecl(returnType), name,
+            tfm::format(hs, "%s %s(%s);\n", cppTypeDecl(returnType), name,
                     join(map(argsTypes, cppTypeDecl), ","));
         }
     }
-    os << "}\n";
-    os << "\n";
-    os << "namespace souffle {\n";
-    os << "static const RamDomain RAM_BIT_SHIFT_MASK = RAM_DOMAIN_SIZE - 1;\n";
+    hs << "}\n";
+    hs << "\n";
+    hs << "namespace souffle {\n";
+    hs << "static const RamDomain RAM_BIT_SHIFT_MASK = RAM_DOMAIN_SIZE - 1;\n";
 
     // synthesise data-structures for relations
     for (auto rel : prog.getRelations()) {
@@ -2392,70 +2687,102 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
                 Relation::getSynthesiserRelation(*rel, idxAnalysis->getIndexSelection(rel->getName()),
                         Global::config().has("provenance") && !isProvInfo);
 
-        generateRelationTypeStruct(os, std::move(relationType));
+        generateRelationTypeStruct(hs, std::move(relationType));
     }
-    os << '\n';
-
-    os << "class " << classname << " : public SouffleProgram {\n";
+    hs << '\n';
+
+    hs << "class " << classname << " : public SouffleProgram {\n";
+
+    // In split mode the methods of the class are only declared in the shared header, and defined
+    // in the entry unit, so that the strata units do not parse their bodies. Otherwise they are
+    // defined in the class.
+    std::stringstream methods;
+    std::ostream& defs = splitUnits ? methods : hs;
+    auto beginMethod = [&](const std::string& type, const std::string& signature,
+                               const std::string& specifiers = "") {
+        hs << type << " " << signature << specifiers;
+        if (splitUnits) {
+            // default arguments are only given by the declaration
+            hs << ";\n";
+            defs << type << " " << classname << "::"
+                 << std::regex_replace(signature, std::regex(" = [^,)]*"), "");
+        }
+        defs << " {\n";
+    };
 
     // regex wrapper
-    os << "private:\n";
-    os << "static inline bool regex_wrapper(const std::string& pattern, const std::string& text) {\n";
-    os << "   bool result = false; \n";
-    os << "   try { result = std::regex_match(text, std::regex(pattern)); } catch(...) { \n";
-    os << "     std::cerr << \"warning: wrong pattern provided for match(\\\"\" << pattern << \"\\\",\\\"\" "
+    hs << "private:\n";
+    hs << "static inline bool regex_wrapper(const std::string& pattern, const std::string& text) {\n";
+    hs << "   bool result = false; \n";
+    hs << "   try { result = std::regex_match(text, std::regex(pattern)); } catch(...) { \n";
+    hs << "     std::cerr << \"warning: wrong pattern provided for match(\\\"\" << pattern << \"\\\",\\\"\" "
           "<< text << \"\\\").\\n\";\n}\n";
-    os << "   return result;\n";
-    os << "}\n";
+    hs << "   return result;\n";
+    hs << "}\n";
 
     // substring wrapper
-    os << "private:\n";
-    os << "static inline std::string substr_wrapper(const std::string& str, size_t idx, size_t len) {\n";
-    os << "   std::string result; \n";
-    os << "   try { result = str.substr(idx,len); } catch(...) { \n";
-    os << "     std::cerr << \"warning: wrong index position provided by substr(\\\"\";\n";
-    os << "     std::cerr << str << \"\\\",\" << (int32_t)idx << \",\" << (int32_t)len << \") "
+    hs << "private:\n";
+    hs << "static inline std::string substr_wrapper(const std::string& str, size_t idx, size_t len) {\n";
+    hs << "   std::string result; \n";
+    hs << "   try { result = str.substr(idx,len); } catch(...) { \n";
+    hs << "     std::cerr << \"warning: wrong index position provided by substr(\\\"\";\n";
+    hs << "     std::cerr << str << \"\\\",\" << (int32_t)idx << \",\" << (int32_t)len << \") "
           "functor.\\n\";\n";
-    os << "   } return result;\n";
-    os << "}\n";
+    hs << "   } return result;\n";
+    hs << "}\n";
 
     if (Global::config().has("profile")) {
-        os << "std::string profiling_fname;\n";
+        hs << "std::string profiling_fname;\n";
     }
 
-    os << "public:\n";
+    hs << "public:\n";
 
     // declare symbol table
-    os << "// -- initialize symbol table --\n";
+    hs << "// -- initialize symbol table --\n";
 
-    os << "SymbolTable symTable";
+    // in split mode the symbols are given by the constructor definition in the entry unit
+    std::stringstream symbols;
     if (symTable.size() > 0) {
-        os << "{\n";
+        symbols << "{\n";
         for (size_t i = 0; i < symTable.size(); i++) {
-            os << "\tR\"_(" << symTable.resolve(i) << ")_\",\n";
+            symbols << "\tR\"_(" << symTable.resolve(i) << ")_\",\n";
         }
-        os << "}";
+        symbols << "}";
+    }
+    hs << "SymbolTable symTable";
+    if (!splitUnits) {
+        hs << symbols.str();
     }
-    os << ";";
+    hs << ";";
 
     // declare record table
-    os << "// -- initialize record table --\n";
+    hs << "// -- initialize record table --\n";
 
-    os << "RecordTable recordTable;"
+    hs << "RecordTable recordTable;"
        << "\n";
 
     if (Global::config().has("profile")) {
-        os << "private:\n";
+        hs << "private:\n";
         size_t numFreq = 0;
         visitDepthFirst(prog, [&](const Statement&) { numFreq++; });
-        os << "  size_t freqs[" << numFreq << "]{};\n";
+        hs << "  size_t freqs[" << numFreq << "]{};\n";
         size_t numRead = 0;
         for (auto rel : prog.getRelations()) {
             if (!rel->isTemp()) {
                 numRead++;
             }
         }
-        os << "  size_t reads[" << numRead << "]{};\n";
+        hs << "  size_t reads[" << numRead << "]{};\n";
+        if (Global::config().has("profile-frequency")) {
+            // searches are numbered up front since the counters are declared before the subroutines
+            visitDepthFirst(prog, [&](const IndexOperation& op) {
+                lookupSearchIdx(op.getRelation(), idxAnalysis->getSearchSignature(&op));
+            });
+            visitDepthFirst(prog, [&](const ExistenceCheck& exists) {
+                lookupSearchIdx(exists.getRelation(), idxAnalysis->getSearchSignature(&exists));
+            });
+            hs << "  size_t searches[" << std::max<size_t>(searchIdxMap.size(), 1) << "]{};\n";
+        }
     }
 
     // print relation definitions
@@ -2471,12 +2798,16 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
     if (Global::config().has("profile")) {
         initConsSep() << "profiling_fname(std::move(pf))";
     }
+    if (splitUnits && symTable.size() > 0) {
+        initConsSep() << "symTable" << symbols.str();
+    }
 
     int relCtr = 0;
     std::set<std::string> storeRelations;
     std::set<std::string> loadRelations;
     std::set<const IO*> loadIOs;
     std::set<const IO*> storeIOs;
+    std::set<std::string> freezableRelations;
 
     // collect load/store operations/relations
     visitDepthFirst(prog, [&](const IO& io) {
@@ -2502,13 +2833,17 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
                 Relation::getSynthesiserRelation(*rel, idxAnalysis->getIndexSelection(datalogName),
                         Global::config().has("provenance") && !isProvInfo);
         const std::string& type = relationType->getTypeName();
+        auto* direct = as<DirectRelation>(relationType.get());
+        if (direct != nullptr && direct->isFreezable()) {
+            freezableRelations.insert(datalogName);
+        }
 
         // defining table
-        os << "// -- Table: " << datalogName << "\n";
+        hs << "// -- Table: " << datalogName << "\n";
 
-        os << "Own<" << type << "> " << cppName << " = mk<" << type << ">();\n";
+        hs << "Own<" << type << "> " << cppName << " = mk<" << type << ">();\n";
         if (!rel->isTemp()) {
-            tfm::format(os, "souffle::RelationWrapper<%s> wrapper_%s;\n", type, cppName);
+            tfm::format(hs, "souffle::RelationWrapper<%s> wrapper_%s;\n", type, cppName);
 
             auto strLitAry = [](auto&& xs) {
                 std::stringstream ss;
@@ -2526,30 +2861,37 @@ void Synthesiser::generateCode(std::ostream& os, const std::string& id, bool& wi
                     foundIn(loadRelations), foundIn(storeRelations));
         }
     }
-    os << "public:\n";
+    hs << "public:\n";
 
     // -- constructor --
 
-    os << classname;
-    os << (Global::config().has("profile") ? "(std::string pf=\"profile.log\")" : "()");
-    os << initCons.str() << '\n';
-    os << "{\n";
+    if (splitUnits) {
+        hs << classname;
+        hs << (Global::config().has("profile") ? "(std::string pf=\"profile.log\");\n" : "();\n");
+        defs << classname << "::" << classname;
+        defs << (Global::config().has("profile") ? "(std::string pf)" : "()");
+    } else {
+        hs << classname;
+        hs << (Global::config().has("profile") ? "(std::string pf=\"profile.log\")" : "()");
+    }
+    defs << initCons.str() << '\n';
+    defs << "{\n";
     if (Global::config().has("profile")) {
-        os << "ProfileEventSingleton::instance().setOutputFile(profiling_fname);\n";
+        defs << "ProfileEventSingleton::instance().setOutputFile(profiling_fname);\n";
     }
-    os << registerRel.str();
-    os << "}\n";
+    defs << registerRel.str();
+    defs << "}\n";
     // -- destructor --
 
-    os << "~" << classname << "() {\n";
-    os << "}\n";
+    hs << "~" << classname << "() {\n";
+    hs << "}\n";
 
     // issue state variables for the evaluation
     //
     // Improve compile time by storing the signal handler in one loc instead of
     // emitting thousands of `SignalHandler::instance()`. The volume of calls
     // makes GVN and register alloc very expensive, even if the call is inlined.
-    os << R"_(
+    hs << R"_(
 private:
 std::string             inputDirectory;
 std::string             outputDirectory;
@@ -2557,10 +2899,31 @@ SignalHandler*          signalHandler {SignalHandler::instance()};
 std::atomic<RamDomain>  ctr {};
 std::atomic<size_t>     iter {};
 bool                    performIO = false;
-
-void runFunction(std::string  inputDirectoryArg   = "",
-                 std::string  outputDirectoryArg  = "",
-                 bool         performIOArg        = false) {
+)_";
+    if (Global::config().has("async-output")) {
+        hs << "WriteQueue              writeQueue {" << Global::config().get("async-output") << "};\n";
+    }
+    if (Global::config().has("prefetch-input")) {
+        hs << "ReadQueue               readQueue {" << Global::config().get("prefetch-input") << "};\n";
+    }
+    if (Global::config().has("memory-limit") || Global::config().has("compress-spills")) {
+        const std::string limit =
+                Global::config().has("memory-limit") ? Global::config().get("memory-limit") : "0";
+        hs << "SpillStore              spillStore {std::size_t(" << limit << ") << 20, "
+           << (Global::config().has("compress-spills") ? "true" : "false") << "};\n";
+        hs << "std::size_t getMemoryUsage() const {\n";
+        hs << "std::size_t usage = 0;\n";
+        for (auto rel : prog.getRelations()) {
+            hs << "usage += " << getRelationName(*rel) << "->getMemoryUsage();\n";
+        }
+        hs << "return usage;\n";
+        hs << "}\n";
+    }
+    hs << "\n";
+    beginMethod("void",
+            "runFunction(std::string inputDirectoryArg = \"\", std::string outputDirectoryArg = \"\", "
+            "bool performIOArg = false)");
+    defs << R"_(
     this->inputDirectory  = std::move(inputDirectoryArg);
     this->outputDirectory = std::move(outputDirectoryArg);
     this->performIO       = performIOArg;
@@ -2574,15 +2937,42 @@ void runFunction(std::string  inputDirectoryArg   = "",
     signalHandler->set();
 )_";
     if (Global::config().has("verbose")) {
-        os << "signalHandler->enableLogging();\n";
+        defs << "signalHandler->enableLogging();\n";
+    }
+
+    // pin the threads and place the relations on the NUMA nodes
+    if (Global::config().has("numa")) {
+        defs << "Numa::instance().setMode(\"" << Global::config().get("numa") << "\");\n";
+        defs << "Numa::instance().pinThreads();\n";
+    }
+
+    // place the relation nodes and the symbol and record tables on huge pages
+    if (Global::config().has("huge-pages")) {
+        defs << "HugePages::instance().setEnabled(true);\n";
+    }
+
+    // start reading the input files ahead of the strata using them
+    if (Global::config().has("prefetch-input")) {
+        defs << "if (performIO) {\n";
+        for (const IO* io : ram::getLoadsInExecutionOrder(prog)) {
+            auto directives = io->getDirectives();
+            if (directives.erase("prefetch") == 0) {
+                continue;
+            }
+            defs << "readQueue.add(" << getRelationName(lookup(io->getRelation())) << ".get(), [this]() {\n";
+            emitCode(defs, IO(io->getRelation(), directives));
+            defs << "});\n";
+        }
+        defs << "readQueue.start();\n";
+        defs << "}\n";
     }
 
     // add actual program body
-    os << "// -- query evaluation --\n";
+    defs << "// -- query evaluation --\n";
     if (Global::config().has("profile")) {
-        os << "ProfileEventSingleton::instance().startTimer();\n";
-        os << R"_(ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");)_" << '\n';
-        os << "{\n"
+        defs << "ProfileEventSingleton::instance().startTimer();\n";
+        defs << R"_(ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");)_" << '\n';
+        defs << "{\n"
            << R"_(Logger logger("@runtime;", 0);)_" << '\n';
         // Store count of relations
         size_t relationCount = 0;
@@ -2592,106 +2982,116 @@ void runFunction(std::string  inputDirectoryArg   = "",
             }
         }
         // Store configuration
-        os << R"_(ProfileEventSingleton::instance().makeConfigRecord("relationCount", std::to_string()_"
+        defs << R"_(ProfileEventSingleton::instance().makeConfigRecord("relationCount", std::to_string()_"
            << relationCount << "));";
+        defs << R"_(ProfileEventSingleton::instance().makeConfigRecord("numa-mode", Numa::instance().getModeName());)_"
+           << '\n';
+        defs << R"_(ProfileEventSingleton::instance().makeConfigRecord("numa-nodes", )_"
+           << R"_(std::to_string(Numa::instance().getNumNodes()));)_" << '\n';
+        if (Global::config().has("huge-pages")) {
+            defs << R"_(ProfileEventSingleton::instance().makeConfigRecord("huge-pages", "");)_" << '\n';
+        }
     }
 
     // emit code
-    emitCode(os, prog.getMain());
+    emitCode(defs, prog.getMain());
+
+    if (Global::config().has("async-output")) {
+        defs << "writeQueue.waitAll();\n";
+    }
 
     if (Global::config().has("profile")) {
-        os << "}\n";
-        os << "ProfileEventSingleton::instance().stopTimer();\n";
-        os << "dumpFreqs();\n";
+        defs << "}\n";
+        defs << "ProfileEventSingleton::instance().stopTimer();\n";
+        defs << "dumpFreqs();\n";
     }
 
     // add code printing hint statistics
-    os << "\n// -- relation hint statistics --\n";
+    defs << "\n// -- relation hint statistics --\n";
 
     if (Global::config().has("verbose")) {
         for (auto rel : prog.getRelations()) {
             auto name = getRelationName(*rel);
-            os << "std::cout << \"Statistics for Relation " << name << ":\\n\";\n";
-            os << name << "->printStatistics(std::cout);\n";
-            os << "std::cout << \"\\n\";\n";
+            defs << "std::cout << \"Statistics for Relation " << name << ":\\n\";\n";
+            defs << name << "->printStatistics(std::cout);\n";
+            defs << "std::cout << \"\\n\";\n";
         }
     }
 
-    os << "signalHandler->reset();\n";
+    defs << "signalHandler->reset();\n";
 
-    os << "}\n";  // end of runFunction() method
+    defs << "}\n";  // end of runFunction() method
 
     // add methods to run with and without performing IO (mainly for the interface)
-    os << "public:\nvoid run() override { runFunction(\"\", \"\", "
+    hs << "public:\nvoid run() override { runFunction(\"\", \"\", "
           "false); }\n";
-    os << "public:\nvoid runAll(std::string inputDirectoryArg = \"\", std::string outputDirectoryArg = \"\") "
+    hs << "public:\nvoid runAll(std::string inputDirectoryArg = \"\", std::string outputDirectoryArg = \"\") "
           "override { ";
     if (Global::config().has("live-profile")) {
-        os << "std::thread profiler([]() { profile::Tui().runProf(); });\n";
+        hs << "std::thread profiler([]() { profile::Tui().runProf(); });\n";
     }
-    os << "runFunction(inputDirectoryArg, outputDirectoryArg, true);\n";
+    hs << "runFunction(inputDirectoryArg, outputDirectoryArg, true);\n";
     if (Global::config().has("live-profile")) {
-        os << "if (profiler.joinable()) { profiler.join(); }\n";
+        hs << "if (profiler.joinable()) { profiler.join(); }\n";
     }
-    os << "}\n";
-    // issue printAll method
-    os << "public:\n";
-    os << "void printAll(std::string outputDirectoryArg = \"\") override {\n";
+    hs << "}\n";
 
     // print directives as C++ initializers
-    auto printDirectives = [&](const std::map<std::string, std::string>& registry) {
+    auto printDirectives = [&](std::ostream& out, const std::map<std::string, std::string>& registry) {
         auto cur = registry.begin();
         if (cur == registry.end()) {
             return;
         }
-        os << "{{\"" << cur->first << "\",\"" << escape(cur->second) << "\"}";
+        out << "{{\"" << cur->first << "\",\"" << escape(cur->second) << "\"}";
         ++cur;
         for (; cur != registry.end(); ++cur) {
-            os << ",{\"" << cur->first << "\",\"" << escape(cur->second) << "\"}";
+            out << ",{\"" << cur->first << "\",\"" << escape(cur->second) << "\"}";
         }
-        os << '}';
+        out << '}';
     };
 
+    // issue printAll method
+    hs << "public:\n";
+    beginMethod("void", "printAll(std::string outputDirectoryArg = \"\")", " override");
     for (auto store : storeIOs) {
         auto const& directive = store->getDirectives();
-        os << "try {";
-        os << "std::map<std::string, std::string> directiveMap(";
-        printDirectives(directive);
-        os << ");\n";
-        os << R"_(if (!outputDirectoryArg.empty()) {)_";
-        os << R"_(directiveMap["output-dir"] = outputDirectoryArg;)_";
-        os << "}\n";
-        os << "IOSystem::getInstance().getWriter(";
-        os << "directiveMap, symTable, recordTable";
-        os << ")->writeAll(*" << getRelationName(lookup(store->getRelation())) << ");\n";
-
-        os << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+        defs << "try {";
+        defs << "std::map<std::string, std::string> directiveMap(";
+        printDirectives(defs, directive);
+        defs << ");\n";
+        defs << R"_(if (!outputDirectoryArg.empty()) {)_";
+        defs << R"_(directiveMap["output-dir"] = outputDirectoryArg;)_";
+        defs << "}\n";
+        defs << "IOSystem::getInstance().getWriter(";
+        defs << "directiveMap, symTable, recordTable";
+        defs << ")->writeAll(*" << getRelationName(lookup(store->getRelation())) << ");\n";
+
+        defs << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
     }
-    os << "}\n";  // end of printAll() method
+    defs << "}\n";  // end of printAll() method
 
     // issue loadAll method
-    os << "public:\n";
-    os << "void loadAll(std::string inputDirectoryArg = \"\") override {\n";
-
+    hs << "public:\n";
+    beginMethod("void", "loadAll(std::string inputDirectoryArg = \"\")", " override");
     for (auto load : loadIOs) {
-        os << "try {";
-        os << "std::map<std::string, std::string> directiveMap(";
-        printDirectives(load->getDirectives());
-        os << ");\n";
-        os << R"_(if (!inputDirectoryArg.empty()) {)_";
-        os << R"_(directiveMap["fact-dir"] = inputDirectoryArg;)_";
-        os << "}\n";
-        os << "IOSystem::getInstance().getReader(";
-        os << "directiveMap, symTable, recordTable";
-        os << ")->readAll(*" << getRelationName(lookup(load->getRelation()));
-        os << ");\n";
-        os << "} catch (std::exception& e) {std::cerr << \"Error loading data: \" << e.what() << "
-              "'\\n';}\n";
+        defs << "try {";
+        defs << "std::map<std::string, std::string> directiveMap(";
+        printDirectives(defs, load->getDirectives());
+        defs << ");\n";
+        defs << R"_(if (!inputDirectoryArg.empty()) {)_";
+        defs << R"_(directiveMap["fact-dir"] = inputDirectoryArg;)_";
+        defs << "}\n";
+        defs << "IOSystem::getInstance().getReader(";
+        defs << "directiveMap, symTable, recordTable";
+        defs << ")->readAll(*" << getRelationName(lookup(load->getRelation()));
+        defs << ");\n";
+        defs << "} catch (std::exception& e) {std::cerr << \"Error loading data: \" << e.what() << "
+                "'\\n';}\n";
     }
+    defs << "}\n";  // end of loadAll() method
 
-    os << "}\n";  // end of loadAll() method
     // issue dump methods
-    auto dumpRelation = [&](const ram::Relation& ramRelation) {
+    auto dumpRelation = [&](std::ostream& out, const ram::Relation& ramRelation) {
         const auto& relName = getRelationName(ramRelation);
         const auto& name = ramRelation.getName();
         const auto& attributesTypes = ramRelation.getAttributeTypes();
@@ -2702,92 +3102,156 @@ void runFunction(std::string  inputDirectoryArg   = "",
 
         Json types = Json::object{{"relation", relJson}};
 
-        os << "try {";
-        os << "std::map<std::string, std::string> rwOperation;\n";
-        os << "rwOperation[\"IO\"] = \"stdout\";\n";
-        os << R"(rwOperation["name"] = ")" << name << "\";\n";
-        os << "rwOperation[\"types\"] = ";
-        os << "\"" << escapeJSONstring(types.dump()) << "\"";
-        os << ";\n";
-        os << "IOSystem::getInstance().getWriter(";
-        os << "rwOperation, symTable, recordTable";
-        os << ")->writeAll(*" << relName << ");\n";
-        os << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+        out << "try {";
+        out << "std::map<std::string, std::string> rwOperation;\n";
+        out << "rwOperation[\"IO\"] = \"stdout\";\n";
+        out << R"(rwOperation["name"] = ")" << name << "\";\n";
+        out << "rwOperation[\"types\"] = ";
+        out << "\"" << escapeJSONstring(types.dump()) << "\"";
+        out << ";\n";
+        out << "IOSystem::getInstance().getWriter(";
+        out << "rwOperation, symTable, recordTable";
+        out << ")->writeAll(*" << relName << ");\n";
+        out << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
     };
 
     // dump inputs
-    os << "public:\n";
-    os << "void dumpInputs() override {\n";
+    hs << "public:\n";
+    beginMethod("void", "dumpInputs()", " override");
     for (auto load : loadIOs) {
-        dumpRelation(*lookup(load->getRelation()));
+        dumpRelation(defs, *lookup(load->getRelation()));
     }
-    os << "}\n";  // end of dumpInputs() method
+    defs << "}\n";  // end of dumpInputs() method
 
     // dump outputs
-    os << "public:\n";
-    os << "void dumpOutputs() override {\n";
+    hs << "public:\n";
+    beginMethod("void", "dumpOutputs()", " override");
     for (auto store : storeIOs) {
-        dumpRelation(*lookup(store->getRelation()));
+        dumpRelation(defs, *lookup(store->getRelation()));
     }
-    os << "}\n";  // end of dumpOutputs() method
+    defs << "}\n";  // end of dumpOutputs() method
 
-    os << "public:\n";
-    os << "SymbolTable& getSymbolTable() override {\n";
-    os << "return symTable;\n";
-    os << "}\n";  // end of getSymbolTable() method
+    hs << "public:\n";
+    hs << "SymbolTable& getSymbolTable() override {\n";
+    hs << "return symTable;\n";
+    hs << "}\n";  // end of getSymbolTable() method
+
+    hs << "RecordTable& getRecordTable() override {\n";
+    hs << "return recordTable;\n";
+    hs << "}\n";  // end of getRecordTable() method
 
-    os << "RecordTable& getRecordTable() override {\n";
-    os << "return recordTable;\n";
-    os << "}\n";  // end of getRecordTable() method
+    hs << "bool isMonotone(const std::string& name) const override {\n";
+    hs << "static const std::set<std::string> monotone{"
+       << join(getMonotoneRelations(prog), ",", [](auto&& os, auto&& name) { os << '"' << name << '"'; })
+       << "};\n";
+    hs << "return monotone.count(name) > 0;\n";
+    hs << "}\n";  // end of isMonotone() method
 
     if (!prog.getSubroutines().empty()) {
         // generate subroutine adapter
-        os << "void executeSubroutine(std::string name, const std::vector<RamDomain>& args, "
-              "std::vector<RamDomain>& ret) override {\n";
+        beginMethod("void",
+                "executeSubroutine(std::string name, const std::vector<RamDomain>& args, "
+                "std::vector<RamDomain>& ret)",
+                " override");
         // subroutine number
         size_t subroutineNum = 0;
         for (auto& sub : prog.getSubroutines()) {
-            os << "if (name == \"" << sub.first << "\") {\n"
-               << "subroutine_" << subroutineNum
-               << "(args, ret);\n"  // subroutine_<i> to deal with special characters in relation names
-               << "return;"
-               << "}\n";
+            defs << "if (name == \"" << sub.first << "\") {\n"
+                 << "subroutine_" << subroutineNum
+                 << "(args, ret);\n"  // subroutine_<i> to deal with special characters in relation names
+                 << "return;"
+                 << "}\n";
             subroutineNum++;
         }
-        os << "fatal(\"unknown subroutine\");\n";
-        os << "}\n";  // end of executeSubroutine
+        defs << "fatal(\"unknown subroutine\");\n";
+        defs << "}\n";  // end of executeSubroutine
 
-        // generate method for each subroutine
+        // generate method for each subroutine; in split mode only the declaration
+        // stays in the class and the definition goes to the unit chosen by a hash
+        // of the subroutine name, so that editing one stratum leaves the other units
+        // unchanged and their compiled objects can be reused
         subroutineNum = 0;
         for (auto& sub : prog.getSubroutines()) {
-            // silence unused argument warnings on MSVC
-            os << "#ifdef _MSC_VER\n";
-            os << "#pragma warning(disable: 4100)\n";
-            os << "#endif // _MSC_VER\n";
-
-            // issue method header
-            os << "void "
-               << "subroutine_" << subroutineNum
-               << "(const std::vector<RamDomain>& args, "
-                  "std::vector<RamDomain>& ret) {\n";
+            std::stringstream body;
 
             // issue lock variable for return statements
             bool needLock = false;
             visitDepthFirst(*sub.second, [&](const SubroutineReturn&) { needLock = true; });
             if (needLock) {
-                os << "std::mutex lock;\n";
+                body << "std::mutex lock;\n";
+            }
+
+            // the relations written by a stratum are thawed before and frozen after it
+            std::set<std::string> written;
+            visitDepthFirst(*sub.second, [&](const Node& node) {
+                std::string name;
+                if (auto project = as<Project>(node)) {
+                    name = project->getRelation();
+                } else if (auto facts = as<Facts>(node)) {
+                    name = facts->getRelation();
+                } else if (auto io = as<IO>(node)) {
+                    const std::string& op = io->get("operation");
+                    name = op == "input" || op == "restore" ? io->getRelation() : "";
+                }
+                if (contains(freezableRelations, name)) {
+                    written.insert(name);
+                }
+            });
+            for (const auto& name : written) {
+                body << getRelationName(lookup(name)) << "->thaw();\n";
             }
 
             // emit code for subroutine
-            emitCode(os, *sub.second);
+            emitCode(body, *sub.second);
+
+            for (const auto& name : written) {
+                const std::string relName = getRelationName(lookup(name));
+                if (Global::config().has("profile")) {
+                    // record the memory saved by freezing the relation
+                    body << "{\n";
+                    const std::string event = "R\"_(@relation-freeze;" + name;
+                    body << "const std::size_t rawUsage = " << relName << "->getMemoryUsage();\n";
+                    body << relName << "->freeze();\n";
+                    body << "ProfileEventSingleton::instance().makeQuantityEvent(" << event
+                         << ";raw)_\", rawUsage, 0);\n";
+                    body << "ProfileEventSingleton::instance().makeQuantityEvent(" << event << ";frozen)_\", "
+                         << relName << "->getMemoryUsage(), 0);\n";
+                    body << "}\n";
+                } else {
+                    body << relName << "->freeze();\n";
+                }
+            }
+
+            const std::string signature = "(const std::vector<RamDomain>& args, std::vector<RamDomain>& ret)";
+            std::ostream* out = &hs;
+            std::string qualifier;
+            if (splitUnits) {
+                hs << "void subroutine_" << subroutineNum << signature << ";\n";
+                // 64-bit FNV-1a, independent of the standard library of the compiler
+                uint64_t h = 14695981039346656037ull;
+                for (unsigned char c : sub.first) {
+                    h = (h ^ c) * 1099511628211ull;
+                }
+                out = &units[h % units.size()];
+                qualifier = classname + "::";
+            }
+
+            // silence unused argument warnings on MSVC
+            *out << "#ifdef _MSC_VER\n";
+            *out << "#pragma warning(disable: 4100)\n";
+            *out << "#endif // _MSC_VER\n";
+
+            // issue method header
+            *out << "void " << qualifier << "subroutine_" << subroutineNum << signature << " {\n";
+            *out << body.str();
 
             // issue end of subroutine
-            os << "}\n";
+            *out << "}\n";
 
             // restore unused argument warning
-            os << "#ifdef _MSC_VER\n";
-            os << "#pragma warning(default: 4100)\n";
-            os << "#endif // _MSC_VER\n";
+            *out << "#ifdef _MSC_VER\n";
+            *out << "#pragma warning(default: 4100)\n";
+            *out << "#endif // _MSC_VER\n";
             subroutineNum++;
         }
     }
@@ -2795,19 +3259,34 @@ void runFunction(std::string  inputDirectoryArg   = "",
     //  Frequency counts must be emitted after subroutines otherwise lookup tables
     //  are not populated.
     if (Global::config().has("profile")) {
-        os << "private:\n";
-        os << "void dumpFreqs() {\n";
+        hs << "private:\n";
+        beginMethod("void", "dumpFreqs()");
         for (auto const& cur : idxMap) {
-            os << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(" << cur.first << ")_\", freqs["
-               << cur.second << "],0);\n";
+            defs << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(" << cur.first
+                 << ")_\", freqs[" << cur.second << "],0);\n";
         }
         for (auto const& cur : neIdxMap) {
-            os << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(@relation-reads;" << cur.first
-               << ")_\", reads[" << cur.second << "],0);\n";
+            defs << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(@relation-reads;" << cur.first
+                 << ")_\", reads[" << cur.second << "],0);\n";
+        }
+        for (auto const& cur : searchIdxMap) {
+            defs << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(@relation-searches;"
+                 << cur.first << ")_\", searches[" << cur.second << "],0);\n";
+        }
+        defs << "}\n";  // end of dumpFreqs() method
+    }
+    hs << "};\n";  // end of class declaration
+
+    // in split mode the entry points re-open the namespace after including the shared header
+    if (splitUnits) {
+        hs << "}\n";
+        for (auto& unit : units) {
+            unit << "}\n";
         }
-        os << "}\n";  // end of dumpFreqs() method
+        os << "#include \"" << headerName << "\"\n";
+        os << "namespace souffle {\n";
+        os << methods.str();
     }
-    os << "};\n";  // end of class declaration
 
     // hidden hooks
     os << "SouffleProgram *newInstance_" << id << "(){return new " << classname << ";}\n";
@@ -2844,6 +3323,9 @@ void runFunction(std::string  inputDirectoryArg   = "",
         os << "R\"()\",\n";
     }
     os << std::stoi(Global::config().get("jobs"));
+    if (Global::config().has("provenance")) {
+        os << ",\ntrue";
+    }
     os << ");\n";
 
     os << "if (!opt.parse(argc,argv)) return 1;\n";
@@ -2873,10 +3355,14 @@ void runFunction(std::string  inputDirectoryArg   = "",
     }
     os << "obj.runAll(opt.getInputFileDir(), opt.getOutputFileDir());\n";
 
-    if (Global::config().get("provenance") == "explain") {
-        os << "explain(obj, false);\n";
-    } else if (Global::config().get("provenance") == "explore") {
-        os << "explain(obj, true);\n";
+    // the explain queries are read from the file given on the command line of the program, if any
+    const std::string& provenance = Global::config().get("provenance");
+    if (provenance == "explain" || provenance == "explore") {
+        os << "if (!opt.getExplainBatchFile().empty()) {\n";
+        os << "explainBatch(obj, opt.getExplainBatchFile());\n";
+        os << "} else {\n";
+        os << "explain(obj, " << (provenance == "explore" ? "true" : "false") << ");\n";
+        os << "}\n";
     }
     os << "return 0;\n";
     os << "} catch(std::exception &e) { souffle::SignalHandler::instance()->error(e.what());}\n";
@@ -20,6 +20,7 @@
 #include "ram/Relation.h"
 #include "ram/Statement.h"
 #include "ram/TranslationUnit.h"
+#include "ram/analysis/Index.h"
 #include "ram/utility/Visitor.h"
 #include "souffle/RecordTable.h"
 #include "souffle/utility/ContainerUtil.h"
@@ -29,7 +30,9 @@
 #include <memory>
 #include <ostream>
 #include <set>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace souffle::synthesiser {
 
@@ -53,6 +56,9 @@ private:
     /** Frequency profiling of non-existence checks */
     std::map<std::string, size_t> neIdxMap;
 
+    /** Frequency profiling of index searches */
+    std::map<std::string, size_t> searchIdxMap;
+
     /** Cache for generated types for relations */
     std::set<std::string> typeCache;
 
@@ -79,6 +85,9 @@ protected:
     /** Get referenced relations */
     std::set<const ram::Relation*> getReferencedRelations(const ram::Operation& op);
 
+    /** Get relations computed without negation, aggregation and choice domains */
+    std::set<std::string> getMonotoneRelations(const ram::Program& prog);
+
     /** Generate code */
     void emitCode(std::ostream& out, const ram::Statement& stmt);
 
@@ -88,6 +97,9 @@ protected:
     /** Lookup read counter */
     size_t lookupReadIdx(const std::string& txt);
 
+    /** Lookup search counter */
+    size_t lookupSearchIdx(const std::string& relName, const ram::analysis::SearchSignature& search);
+
     /** Lookup relation by relation name */
     const ram::Relation* lookup(const std::string& relName) {
         auto it = relationMap.find(relName);
@@ -110,5 +122,15 @@ public:
 
     /** Generate code */
     void generateCode(std::ostream& os, const std::string& id, bool& withSharedLibrary);
+
+    /**
+     * Generate code split into several translation units
+     *
+     * The relation types and the program class are written to the header stream `hs`,
+     * the entry points to `os`, and the subroutines (i.e. strata) are distributed over
+     * `units` so that they can be compiled in parallel. Each unit includes `headerName`.
+     */
+    void generateCode(std::ostream& hs, std::ostream& os, std::vector<std::stringstream>& units,
+            const std::string& headerName, const std::string& id, bool& withSharedLibrary);
 };
 }  // namespace souffle::synthesiser
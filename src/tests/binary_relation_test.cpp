@@ -278,6 +278,63 @@ TEST(EqRelTest, Extend) {
     EXPECT_EQ(br2.size(), (11 * 11) + (4 * 4) + (2 * 2));
 }
 
+TEST(EqRelTest, IncrementalIteration) {
+    // test that the disjoint sets stay consistent when merged between iterations
+    EqRel br;
+    const int N = 200;
+
+    std::vector<int> data;
+    for (int i = 0; i < N; i++) {
+        data.push_back(i);
+    }
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    shuffle(data.begin(), data.end(), generator);
+
+    // merge the classes in rounds, and iterate after each round
+    std::vector<int> rep(N);
+    for (int i = 0; i < N; i++) {
+        rep[i] = i;
+    }
+    for (int round = 0; round < N / 10; round++) {
+        for (int i = round * 10; i < (round + 1) * 10; i++) {
+            const int x = data[i];
+            const int y = data[(i * 7) % N];
+            br.insert(x, y);
+            // naive union of the classes
+            const int oldRep = rep[y];
+            for (int j = 0; j < N; j++) {
+                if (rep[j] == oldRep) {
+                    rep[j] = rep[x];
+                }
+            }
+        }
+
+        // compare the pairs of the relation with the naive classes
+        size_t count = 0;
+        std::vector<size_t> classSize(N, 0);
+        for (const auto& t : br) {
+            EXPECT_EQ(rep[t[0]], rep[t[1]]);
+            ++count;
+        }
+        std::vector<bool> inRelation(N, false);
+        for (const auto& t : br) {
+            inRelation[t[0]] = true;
+        }
+        for (int j = 0; j < N; j++) {
+            if (inRelation[j]) {
+                classSize[rep[j]]++;
+            }
+        }
+        size_t expected = 0;
+        for (size_t s : classSize) {
+            expected += s * s;
+        }
+        EXPECT_EQ(expected, count);
+        EXPECT_EQ(count, br.size());
+    }
+}
+
 TEST(EqRelTest, Merge) {
     // test insertAll isolates data
     EqRel br;
@@ -16,6 +16,7 @@
 
 #include "tests/test.h"
 
+#include "souffle/RamTypes.h"
 #include "souffle/datastructure/BTree.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/StreamUtil.h"
@@ -31,6 +32,7 @@
 #include <string>
 #include <system_error>
 #include <tuple>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 #ifdef _OPENMP
@@ -576,6 +578,64 @@ TEST(BTreeSet, ChunkSplitStress) {
     }
 }
 
+/** A comparator ordering tuples by their second column first */
+struct SecondColumnComparator {
+    static constexpr int leading_column = 1;
+
+    int operator()(const Tuple<RamDomain, 2>& a, const Tuple<RamDomain, 2>& b) const {
+        return (a[1] < b[1]) ? -1 : (a[1] > b[1]) ? 1 : (a[0] < b[0]) ? -1 : (a[0] > b[0]) ? 1 : 0;
+    }
+    bool less(const Tuple<RamDomain, 2>& a, const Tuple<RamDomain, 2>& b) const {
+        return operator()(a, b) < 0;
+    }
+    bool equal(const Tuple<RamDomain, 2>& a, const Tuple<RamDomain, 2>& b) const {
+        return operator()(a, b) == 0;
+    }
+};
+
+TEST(BTreeSet, SimdSearch) {
+    using Key = Tuple<RamDomain, 2>;
+
+    // the default strategy of RamDomain tuples is the vectorised search
+    EXPECT_TRUE((std::is_same<detail::default_strategy<Key>::type, detail::simd_search>::value));
+
+    auto check = [&](auto s, auto b) {
+        // few distinct values in both columns, including negative ones
+        std::mt19937 generator(3);
+        std::uniform_int_distribution<RamDomain> dist(-20, 20);
+        for (int i = 0; i < 2000; i++) {
+            Key cur = {dist(generator), dist(generator)};
+            s.insert(cur);
+            b.insert(cur);
+        }
+        EXPECT_EQ(b.size(), s.size());
+        EXPECT_TRUE(std::equal(s.begin(), s.end(), b.begin()));
+
+        for (RamDomain i = -22; i <= 22; i++) {
+            for (RamDomain j = -22; j <= 22; j++) {
+                Key cur = {i, j};
+                EXPECT_EQ(b.contains(cur), s.contains(cur));
+                auto lower = s.lower_bound(cur);
+                auto upper = s.upper_bound(cur);
+                EXPECT_EQ(b.lower_bound(cur) == b.end(), lower == s.end());
+                EXPECT_EQ(b.upper_bound(cur) == b.end(), upper == s.end());
+                if (lower != s.end()) {
+                    EXPECT_EQ(*b.lower_bound(cur), *lower);
+                }
+                if (upper != s.end()) {
+                    EXPECT_EQ(*b.upper_bound(cur), *upper);
+                }
+            }
+        }
+    };
+
+    using comparator = detail::comparator<Key>;
+    check(btree_set<Key, comparator, std::allocator<Key>, 256, detail::simd_search>(),
+            btree_set<Key, comparator, std::allocator<Key>, 256, detail::binary_search>());
+    check(btree_set<Key, SecondColumnComparator, std::allocator<Key>, 256, detail::simd_search>(),
+            btree_set<Key, SecondColumnComparator, std::allocator<Key>, 256, detail::binary_search>());
+}
+
 using Entry = std::tuple<int, int>;
 
 std::vector<Entry> getData(unsigned numEntries) {
@@ -728,6 +788,53 @@ TEST(Performance, Load) {
     time("bulk-load", [&]() { auto t = btree_set<int>::load(data.begin(), data.end()); });
 }
 
+TEST(Performance, Search) {
+    using Key = Tuple<RamDomain, 2>;
+    int N = 1 << 18;
+
+    std::vector<Key> in;
+    std::vector<Key> out;
+    for (const auto& cur : getData(2 * N)) {
+        Key key = {std::get<0>(cur), std::get<1>(cur)};
+        (in.size() == out.size() ? in : out).push_back(key);
+    }
+
+    auto check = [&](const std::string& name, auto set) {
+        std::cout << "Testing: " << name << " ..\n";
+        set.insert(in.begin(), in.end());
+        bool allPresent = true;
+        time("membership in", [&]() {
+            for (const auto& cur : in) {
+                allPresent = set.contains(cur) && allPresent;
+            }
+        });
+        EXPECT_TRUE(allPresent);
+        bool allMissing = true;
+        time("membership out", [&]() {
+            for (const auto& cur : out) {
+                allMissing = !set.contains(cur) && allMissing;
+            }
+        });
+        EXPECT_TRUE(allMissing);
+        bool allFound = true;
+        time("lower_boundaries", [&]() {
+            for (const auto& cur : in) {
+                allFound = (*set.lower_bound(cur) == cur) && allFound;
+            }
+        });
+        EXPECT_TRUE(allFound);
+        std::cout << "\tDone!\n\n";
+    };
+
+    using comparator = detail::comparator<Key>;
+    check("souffle btree_set - 256 - linear",
+            btree_set<Key, comparator, std::allocator<Key>, 256, detail::linear_search>());
+    check("souffle btree_set - 256 - binary",
+            btree_set<Key, comparator, std::allocator<Key>, 256, detail::binary_search>());
+    check("souffle btree_set - 256 - simd",
+            btree_set<Key, comparator, std::allocator<Key>, 256, detail::simd_search>());
+}
+
 TEST(BTreeSet, Parallel) {
     //        const int N = 600000000;
     //        const int N = 100000;
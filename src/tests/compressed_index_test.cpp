@@ -0,0 +1,130 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file compressed_index_test.cpp
+ *
+ * A test case testing the compressed indexes of frozen relations.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/CompressedIndex.h"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace souffle::test {
+
+namespace {
+
+using Tuple = std::array<RamDomain, 2>;
+
+/** The order of an index on the first column only, like the indexes of a relation */
+struct FirstColumn {
+    bool less(const Tuple& a, const Tuple& b) const {
+        return a[0] < b[0];
+    }
+    bool equal(const Tuple& a, const Tuple& b) const {
+        return a[0] == b[0];
+    }
+};
+
+/** The order of an index on both columns */
+struct BothColumns {
+    bool less(const Tuple& a, const Tuple& b) const {
+        return a < b;
+    }
+    bool equal(const Tuple& a, const Tuple& b) const {
+        return a == b;
+    }
+};
+
+std::vector<Tuple> getTuples() {
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<RamDomain> dist(-500, 500);
+    std::vector<Tuple> data;
+    for (int i = 0; i < 2000; i++) {
+        data.push_back({dist(generator), dist(generator)});
+    }
+    std::sort(data.begin(), data.end());
+    data.erase(std::unique(data.begin(), data.end()), data.end());
+    return data;
+}
+
+}  // namespace
+
+TEST(CompressedIndex, Empty) {
+    CompressedIndex<Tuple, BothColumns> index;
+    std::vector<Tuple> data;
+    index.assign(data.begin(), data.end());
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(0, index.size());
+    EXPECT_TRUE(index.begin() == index.end());
+    EXPECT_TRUE(index.lower_bound({0, 0}) == index.end());
+    EXPECT_FALSE(index.contains({0, 0}));
+    EXPECT_TRUE(index.getChunks(4).empty());
+}
+
+TEST(CompressedIndex, Iteration) {
+    auto data = getTuples();
+    CompressedIndex<Tuple, BothColumns> index;
+    index.assign(data.begin(), data.end());
+    EXPECT_EQ(data.size(), index.size());
+    EXPECT_LT(index.getMemoryUsage(), data.size() * sizeof(Tuple));
+
+    std::vector<Tuple> decoded(index.begin(), index.end());
+    EXPECT_EQ(data, decoded);
+
+    // chunks of whole blocks cover all tuples
+    decoded.clear();
+    for (const auto& chunk : index.getChunks(5)) {
+        decoded.insert(decoded.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ(data, decoded);
+}
+
+TEST(CompressedIndex, Contains) {
+    auto data = getTuples();
+    CompressedIndex<Tuple, BothColumns> index;
+    index.assign(data.begin(), data.end());
+
+    CompressedIndex<Tuple, BothColumns>::operation_hints hints;
+    for (RamDomain x = -510; x <= 510; x += 3) {
+        for (RamDomain y = -510; y <= 510; y += 7) {
+            Tuple t{x, y};
+            EXPECT_EQ(std::binary_search(data.begin(), data.end(), t), index.contains(t, hints));
+        }
+    }
+    for (const auto& t : data) {
+        EXPECT_TRUE(index.contains(t, hints));
+        EXPECT_EQ(t, *index.find(t, hints));
+    }
+}
+
+TEST(CompressedIndex, Range) {
+    auto data = getTuples();
+    CompressedIndex<Tuple, FirstColumn> index;
+    index.assign(data.begin(), data.end());
+
+    auto less = [](const Tuple& a, const Tuple& b) { return a[0] < b[0]; };
+    CompressedIndex<Tuple, FirstColumn>::operation_hints hints;
+    for (RamDomain x = -510; x <= 510; x++) {
+        Tuple t{x, 0};
+        std::vector<Tuple> expected(std::lower_bound(data.begin(), data.end(), t, less),
+                std::upper_bound(data.begin(), data.end(), t, less));
+        std::vector<Tuple> found(index.lower_bound(t, hints), index.upper_bound(t, hints));
+        EXPECT_EQ(expected, found);
+    }
+}
+
+}  // namespace souffle::test
@@ -0,0 +1,98 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file compressed_tuples_test.cpp
+ *
+ * A test case testing the compressed tuple sequences of spilled relations.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/CompressedTuples.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace souffle::test {
+
+TEST(CompressedTuples, Empty) {
+    CompressedTuples tuples(2);
+    tuples.flush();
+    EXPECT_EQ(0, tuples.size());
+    EXPECT_EQ(0, tuples.getMemoryUsage());
+
+    size_t count = 0;
+    tuples.forEach([&](const RamDomain*) { count++; });
+    EXPECT_EQ(0, count);
+}
+
+TEST(CompressedTuples, Sorted) {
+    // an edge relation, whose tuples share their first column
+    std::vector<RamDomain> data;
+    for (RamDomain x = 0; x < 1000; x++) {
+        for (RamDomain y = 0; y < 10; y++) {
+            data.push_back(x);
+            data.push_back(x + y * 7);
+        }
+    }
+
+    CompressedTuples tuples(2);
+    for (size_t i = 0; i < data.size(); i += 2) {
+        tuples.append(&data[i]);
+    }
+    tuples.flush();
+    EXPECT_EQ(data.size() / 2, tuples.size());
+    EXPECT_LT(tuples.getMemoryUsage() * 4, data.size() * sizeof(RamDomain));
+
+    std::vector<RamDomain> decoded;
+    tuples.forEach([&](const RamDomain* tuple) { decoded.insert(decoded.end(), tuple, tuple + 2); });
+    EXPECT_EQ(data, decoded);
+}
+
+TEST(CompressedTuples, Unsorted) {
+    // arbitrary values, including negative and extreme ones
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<RamDomain> dist(MIN_RAM_SIGNED, MAX_RAM_SIGNED);
+    std::vector<RamDomain> data = {MIN_RAM_SIGNED, MAX_RAM_SIGNED, -1, MAX_RAM_SIGNED, MIN_RAM_SIGNED, 0};
+    for (int i = 0; i < 3 * 1000; i++) {
+        data.push_back(dist(generator));
+    }
+
+    CompressedTuples tuples(3);
+    for (size_t i = 0; i < data.size(); i += 3) {
+        tuples.append(&data[i]);
+    }
+    tuples.flush();
+    EXPECT_EQ(data.size() / 3, tuples.size());
+
+    std::vector<RamDomain> decoded;
+    tuples.forEach([&](const RamDomain* tuple) { decoded.insert(decoded.end(), tuple, tuple + 3); });
+    EXPECT_EQ(data, decoded);
+}
+
+TEST(CompressedTuples, Constant) {
+    // a column holding a single value needs no bits at all
+    std::vector<RamDomain> data(CompressedTuples::blockSize * 4, -5);
+
+    CompressedTuples tuples(1);
+    for (const auto& cur : data) {
+        tuples.append(&cur);
+    }
+    tuples.flush();
+    EXPECT_EQ(data.size(), tuples.size());
+
+    std::vector<RamDomain> decoded;
+    tuples.forEach([&](const RamDomain* tuple) { decoded.push_back(*tuple); });
+    EXPECT_EQ(data, decoded);
+}
+
+}  // namespace souffle::test
@@ -0,0 +1,82 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file hyperloglog_test.cpp
+ *
+ * Test cases for the HyperLogLog sketch.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/datastructure/HyperLogLog.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace souffle {
+
+namespace test {
+
+TEST(HyperLogLog, Empty) {
+    HyperLogLog<> sketch;
+    EXPECT_EQ(0, std::llround(sketch.estimate()));
+}
+
+TEST(HyperLogLog, Duplicates) {
+    HyperLogLog<> sketch;
+    for (int i = 0; i < 10000; ++i) {
+        sketch.insert(HyperLogLog<>::hash(i % 10));
+    }
+    EXPECT_EQ(10, std::llround(sketch.estimate()));
+}
+
+TEST(HyperLogLog, Accuracy) {
+    for (uint64_t n : {100, 1000, 10000, 100000, 1000000}) {
+        HyperLogLog<> sketch;
+        for (uint64_t i = 0; i < n; ++i) {
+            sketch.insert(HyperLogLog<>::hash(i));
+        }
+        // standard error is about 1.6%, allow for three times that
+        EXPECT_LT(std::fabs(sketch.estimate() - n), 0.05 * n);
+    }
+}
+
+TEST(HyperLogLog, Merge) {
+    HyperLogLog<> left;
+    HyperLogLog<> right;
+    HyperLogLog<> both;
+    for (uint64_t i = 0; i < 20000; ++i) {
+        (i < 12000 ? left : right).insert(HyperLogLog<>::hash(i));
+        if (i >= 8000) {
+            // overlap of the two halves
+            left.insert(HyperLogLog<>::hash(i - 4000));
+        }
+        both.insert(HyperLogLog<>::hash(i));
+    }
+    left.merge(right);
+    EXPECT_EQ(both.estimate(), left.estimate());
+}
+
+TEST(HyperLogLog, Prefixes) {
+    // pairs (i % 100, i) have 100 distinct prefixes of length one
+    HyperLogLog<> prefixes;
+    HyperLogLog<> tuples;
+    for (uint64_t i = 0; i < 50000; ++i) {
+        uint64_t prefix = HyperLogLog<>::combine(0, i % 100);
+        prefixes.insert(prefix);
+        tuples.insert(HyperLogLog<>::combine(prefix, i));
+    }
+    EXPECT_LT(std::fabs(prefixes.estimate() - 100), 5);
+    EXPECT_LT(std::fabs(tuples.estimate() - 50000), 2500);
+}
+
+}  // namespace test
+}  // namespace souffle
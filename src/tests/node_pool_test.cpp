@@ -0,0 +1,216 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file node_pool_test.cpp
+ *
+ * A test case testing the node pools and the containers using them.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/BTree.h"
+#include "souffle/datastructure/Brie.h"
+#include "souffle/datastructure/NodePool.h"
+#include "souffle/utility/HugePageUtil.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace souffle::test {
+
+TEST(NodePool, Allocate) {
+    NodePool pool;
+    EXPECT_EQ(0, pool.getMemoryUsage());
+
+    std::vector<char*> blocks;
+    for (std::size_t i = 1; i < 2000; i++) {
+        const std::size_t alignment = std::size_t(1) << (i % 7);
+        auto* cur = static_cast<char*>(pool.allocate(i % 300 + 1, alignment));
+        EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(cur) % alignment);
+        blocks.push_back(cur);
+    }
+    // allocations larger than a slab get a slab of their own
+    blocks.push_back(static_cast<char*>(pool.allocate(NodePool::maxSlabSize * 2, 8)));
+    EXPECT_LT(NodePool::maxSlabSize * 2, pool.getMemoryUsage());
+
+    // no two allocations overlap
+    std::sort(blocks.begin(), blocks.end());
+    EXPECT_TRUE(std::adjacent_find(blocks.begin(), blocks.end()) == blocks.end());
+
+    pool.release();
+    EXPECT_EQ(0, pool.getMemoryUsage());
+}
+
+TEST(NodePool, Clear) {
+    NodePool pool;
+    for (int i = 0; i < 1000; i++) {
+        pool.allocate(64, 8);
+    }
+    const std::size_t usage = pool.getMemoryUsage();
+    EXPECT_LT(0, usage);
+
+    // the slabs are kept for the next round of allocations
+    pool.clear();
+    EXPECT_EQ(usage, pool.getMemoryUsage());
+    for (int i = 0; i < 1000; i++) {
+        pool.allocate(64, 8);
+    }
+    EXPECT_EQ(usage, pool.getMemoryUsage());
+
+    // slabs unused between two clears are freed
+    pool.clear();
+    pool.clear();
+    EXPECT_EQ(0, pool.getMemoryUsage());
+}
+
+TEST(NodePool, HugePages) {
+    HugePages::instance().setEnabled(true);
+    {
+        NodePool pool;
+        std::vector<std::uint64_t*> blocks;
+        for (int i = 0; i < 100000; i++) {
+            auto* cur = static_cast<std::uint64_t*>(pool.allocate(64, 8));
+            *cur = i;
+            blocks.push_back(cur);
+        }
+        // slabs grow to whole huge pages
+        EXPECT_LT(2 * HugePages::pageSize, pool.getMemoryUsage());
+        bool intact = true;
+        for (std::size_t i = 0; i < blocks.size(); i++) {
+            intact = intact && *blocks[i] == i;
+        }
+        EXPECT_TRUE(intact);
+        pool.clear();
+        pool.clear();
+        EXPECT_EQ(0, pool.getMemoryUsage());
+    }
+
+    // large arrays of containers are mapped, small ones are on the heap
+    std::vector<RamDomain, HugePageAllocator<RamDomain>> values;
+    for (RamDomain i = 0; i < 1000000; i++) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(values.data()) % HugePages::pageSize);
+    EXPECT_EQ(999999, values.back());
+    HugePages::instance().setEnabled(false);
+}
+
+using Entry = Tuple<RamDomain, 2>;
+using pooled_set = btree_set<Entry, detail::comparator<Entry>, PoolAllocator<Entry>>;
+using pooled_multiset = btree_multiset<Entry, detail::comparator<Entry>, PoolAllocator<Entry>>;
+
+TEST(PooledBTree, Basic) {
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<RamDomain> dist(0, 100);
+
+    std::set<Entry> reference;
+    pooled_set t;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 10000; i++) {
+            Entry cur = {dist(generator), dist(generator)};
+            EXPECT_EQ(reference.insert(cur).second, t.insert(cur));
+        }
+        EXPECT_EQ(reference.size(), t.size());
+        EXPECT_TRUE(std::equal(t.begin(), t.end(), reference.begin()));
+        EXPECT_LT(0, t.getMemoryUsage());
+
+        // a copy owns its nodes
+        pooled_set copy(t);
+        t.clear();
+        EXPECT_TRUE(t.empty());
+        EXPECT_TRUE(std::equal(copy.begin(), copy.end(), reference.begin()));
+        reference.clear();
+    }
+}
+
+TEST(PooledBTree, LoadAndSwap) {
+    std::vector<Entry> data;
+    for (RamDomain i = 0; i < 5000; i++) {
+        data.push_back({i / 10, i % 10});
+    }
+
+    auto a = pooled_set::load(data.begin(), data.end());
+    EXPECT_EQ(data.size(), a.size());
+    EXPECT_TRUE(std::equal(a.begin(), a.end(), data.begin()));
+
+    pooled_set b;
+    b.insert({-1, -1});
+    a.swap(b);
+    EXPECT_EQ(1, a.size());
+    EXPECT_EQ(data.size(), b.size());
+    a.clear();
+    EXPECT_TRUE(std::equal(b.begin(), b.end(), data.begin()));
+
+    pooled_multiset m;
+    for (int i = 0; i < 3; i++) {
+        m.insert(data.begin(), data.end());
+    }
+    EXPECT_EQ(3 * data.size(), m.size());
+}
+
+#ifdef _OPENMP
+TEST(PooledBTree, Parallel) {
+    const int N = 100000;
+    pooled_set t;
+    for (int round = 0; round < 2; round++) {
+#pragma omp parallel for
+        for (int i = 0; i < N; i++) {
+            t.insert({i % 1000, i});
+        }
+        EXPECT_EQ(N, t.size());
+        RamDomain expected = 0;
+        bool ordered = true;
+        for (const auto& cur : t) {
+            ordered = ordered && cur[1] % 1000 == cur[0];
+            expected++;
+        }
+        EXPECT_TRUE(ordered);
+        EXPECT_EQ(N, expected);
+        t.clear();
+    }
+}
+#endif
+
+TEST(PooledSparseBitMap, Basic) {
+    SparseBitMap<4, PoolAllocator<uint64_t>> map;
+    std::set<uint64_t> reference;
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<uint64_t> dist(0, 1 << 20);
+    for (int i = 0; i < 10000; i++) {
+        auto cur = dist(generator);
+        EXPECT_EQ(reference.insert(cur).second, map.set(cur));
+    }
+    EXPECT_EQ(reference.size(), map.size());
+    std::vector<uint64_t> expected(reference.begin(), reference.end());
+    std::vector<uint64_t> values;
+    for (auto cur : map) {
+        values.push_back(cur);
+    }
+    EXPECT_EQ(expected, values);
+
+    auto copy = map;
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    values.clear();
+    for (auto cur : copy) {
+        values.push_back(cur);
+    }
+    EXPECT_EQ(expected, values);
+
+    map = std::move(copy);
+    EXPECT_EQ(reference.size(), map.size());
+    EXPECT_TRUE(map.test(*reference.begin()));
+}
+
+}  // namespace souffle::test
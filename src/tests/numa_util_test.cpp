@@ -0,0 +1,127 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file numa_util_test.cpp
+ *
+ * A test case testing the NUMA placement and the chunk queue of parallel scans.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/BTree.h"
+#include "souffle/datastructure/Brie.h"
+#include "souffle/datastructure/EquivalenceRelation.h"
+#include "souffle/datastructure/NodePool.h"
+#include "souffle/utility/Iteration.h"
+#include "souffle/utility/NumaUtil.h"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace souffle::test {
+
+TEST(Numa, Mode) {
+    Numa& numa = Numa::instance();
+    EXPECT_LT(0, numa.getNumNodes());
+    EXPECT_LT(numa.getCurrentNode(), numa.getNumNodes());
+
+    // the mode only takes effect with several nodes
+    numa.setMode("interleave");
+    EXPECT_EQ(numa.getNumNodes() > 1, numa.isEnabled());
+    EXPECT_EQ(numa.isEnabled() ? "interleave" : "none", numa.getModeName());
+    numa.setMode("partition");
+    EXPECT_EQ(numa.isEnabled() ? "partition" : "none", numa.getModeName());
+    numa.pinThreads();
+
+    numa.setMode(NumaMode::NONE);
+    EXPECT_FALSE(numa.isEnabled());
+    EXPECT_EQ("none", numa.getModeName());
+}
+
+using Entry = Tuple<RamDomain, 2>;
+using pooled_set = btree_set<Entry, detail::comparator<Entry>, PoolAllocator<Entry>>;
+
+TEST(NumaChunkQueue, TupleAddress) {
+    pooled_set set;
+    set.insert({1, 2});
+    set.insert({3, 4});
+    auto it = set.begin();
+    EXPECT_EQ(static_cast<const void*>(&*it), detail::getTupleAddress(it));
+
+    // chained iterators forward the tuples of the underlying iterator
+    pooled_set other;
+    other.insert({5, 6});
+    ChainIterator<pooled_set::iterator> chained(other.begin(), other.end(), set.begin());
+    EXPECT_EQ(static_cast<const void*>(&*other.begin()), detail::getTupleAddress(chained));
+
+    // tuples produced by value have no address
+    Trie<2> trie;
+    trie.insert({1, 2});
+    auto trieIt = trie.begin();
+    EXPECT_EQ(nullptr, detail::getTupleAddress(trieIt));
+
+    EquivalenceRelation<Entry> eqrel;
+    eqrel.insert(1, 2);
+    auto eqrelIt = eqrel.begin();
+    EXPECT_EQ(nullptr, detail::getTupleAddress(eqrelIt));
+}
+
+TEST(NumaChunkQueue, Scan) {
+    // scan all chunks through a queue in parallel, checking that each tuple is seen once
+    auto testQueue = [&](const pooled_set& set) {
+        auto chunks = set.partition(100);
+        NumaChunkQueue<decltype(chunks)> queue(chunks);
+        std::vector<std::atomic<int>> seen(set.size());
+        for (auto& cur : seen) {
+            cur = 0;
+        }
+#pragma omp parallel
+        for (auto* it = queue.next(); it != nullptr; it = queue.next()) {
+            for (const auto& cur : *it) {
+                seen[cur[0]]++;
+            }
+        }
+        bool once = true;
+        for (const auto& cur : seen) {
+            once = once && cur == 1;
+        }
+        EXPECT_TRUE(once);
+        EXPECT_EQ(nullptr, queue.next());
+    };
+
+    pooled_set set;
+    for (RamDomain i = 0; i < 100000; i++) {
+        set.insert({i, i % 7});
+    }
+    testQueue(set);
+
+    // chunks are grouped by their nodes
+    Numa::instance().setMode(NumaMode::PARTITION);
+    pooled_set placed;
+#pragma omp parallel for
+    for (RamDomain i = 0; i < 100000; i++) {
+        placed.insert({i, i % 7});
+    }
+    testQueue(placed);
+    Numa::instance().setMode(NumaMode::NONE);
+
+    pooled_set empty;
+    auto chunks = empty.partition(10);
+    NumaChunkQueue<decltype(chunks)> queue(chunks);
+    std::size_t count = 0;
+    for (auto* it = queue.next(); it != nullptr; it = queue.next()) {
+        count++;
+    }
+    EXPECT_EQ(chunks.size(), count);
+}
+
+}  // namespace souffle::test
@@ -0,0 +1,129 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file row_store_test.cpp
+ *
+ * A test case testing the row store of compact relations.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/BTree.h"
+#include "souffle/datastructure/RowStore.h"
+#include <set>
+#include <vector>
+
+namespace souffle::test {
+
+using store_t = RowStore<3>;
+using t_tuple = store_t::t_tuple;
+
+TEST(RowStore, Basic) {
+    store_t store;
+    EXPECT_EQ(0, store.size());
+    EXPECT_EQ(0, store.getMemoryUsage());
+
+    std::vector<RamDomain> rows;
+    for (RamDomain i = 0; i < 1000; i++) {
+        rows.push_back(store.append({i, -i, i * 2}));
+    }
+    EXPECT_EQ(1000, store.size());
+    EXPECT_EQ(1000 * sizeof(t_tuple), store.getMemoryUsage());
+
+    // row ids are assigned in the order of insertion
+    bool ordered = true;
+    for (RamDomain i = 0; i < 1000; i++) {
+        ordered = ordered && rows[i] == i;
+        const t_tuple& cur = store[rows[i]];
+        ordered = ordered && cur[0] == i && cur[1] == -i && cur[2] == i * 2;
+    }
+    EXPECT_TRUE(ordered);
+
+    store.clear();
+    EXPECT_EQ(0, store.size());
+    EXPECT_EQ(0, store.append({1, 2, 3}));
+}
+
+TEST(RowStore, Stable) {
+    store_t store;
+    const t_tuple* first = &store[store.append({7, 8, 9})];
+    for (RamDomain i = 0; i < 100000; i++) {
+        store.append({i, i, i});
+    }
+    // stored tuples do not move when the store grows
+    EXPECT_EQ(first, &store[0]);
+    EXPECT_EQ(7, (*first)[0]);
+}
+
+TEST(RowStore, Index) {
+    store_t store;
+    using entry_t = Tuple<RamDomain, 2>;
+    btree_set<entry_t, detail::comparator<entry_t>> index;
+
+    // a secondary index on the last column, holding the column and the row id
+    std::set<t_tuple> reference;
+    for (RamDomain i = 0; i < 500; i++) {
+        t_tuple cur = {i, i / 7, (i * 13) % 50};
+        reference.insert(cur);
+        index.insert({cur[2], store.append(cur)});
+    }
+
+    // a range query on the secondary index produces the stored tuples
+    std::set<t_tuple> found;
+    auto low = index.lower_bound({10, MIN_RAM_SIGNED});
+    auto high = index.upper_bound({10, MAX_RAM_SIGNED});
+    for (auto it = store.wrap(low); it != store.wrap(high); ++it) {
+        EXPECT_EQ(10, (*it)[2]);
+        EXPECT_EQ(it->data(), (*it).data());
+        found.insert(*it);
+    }
+    std::set<t_tuple> expected;
+    for (const auto& cur : reference) {
+        if (cur[2] == 10) {
+            expected.insert(cur);
+        }
+    }
+    EXPECT_EQ(expected.size(), found.size());
+    EXPECT_TRUE(expected == found);
+
+    // a full scan visits every tuple once
+    std::set<t_tuple> all;
+    for (auto it = store.wrap(index.begin()); it != store.wrap(index.end()); it++) {
+        all.insert(*it);
+    }
+    EXPECT_TRUE(reference == all);
+}
+
+#ifdef _OPENMP
+TEST(RowStore, Parallel) {
+    const int N = 100000;
+    store_t store;
+    std::vector<RamDomain> rows(N);
+#pragma omp parallel for
+    for (int i = 0; i < N; i++) {
+        rows[i] = store.append({i, i + 1, i + 2});
+    }
+    EXPECT_EQ(N, store.size());
+
+    // every tuple has its own row
+    std::set<RamDomain> distinct(rows.begin(), rows.end());
+    EXPECT_EQ(N, distinct.size());
+    bool intact = true;
+    for (int i = 0; i < N; i++) {
+        const t_tuple& cur = store[rows[i]];
+        intact = intact && cur[0] == i && cur[1] == i + 1 && cur[2] == i + 2;
+    }
+    EXPECT_TRUE(intact);
+}
+#endif
+
+}  // namespace souffle::test
@@ -0,0 +1,110 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020 The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for running queries on a shared base database using the OO-interface
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+void printRelation(const SouffleProgram& prog, const std::string& relName) {
+    Relation* relation = prog.getRelation(relName);
+    std::cout << relName << std::endl;
+    for (tuple tuple : *relation) {
+        for (std::size_t i = 0; i < relation->getArity(); i++) {
+            if (*relation->getAttrType(i) == 'i') {
+                RamSigned number;
+                tuple >> number;
+                std::cout << (i == 0 ? "" : "-") << number;
+            } else {
+                std::string field;
+                tuple >> field;
+                std::cout << (i == 0 ? "" : "-") << field;
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+void printQuery(const SouffleProgram& prog, const std::string& name) {
+    std::cout << "-- " << name << std::endl;
+    printRelation(prog, "source2sink");
+    printRelation(prog, "open_sink");
+    printRelation(prog, "sinks_reached");
+}
+
+void insertTuple(
+        Own<SouffleProgram>& prog, const std::string& relName, const std::vector<std::string>& nodes) {
+    Relation* relation = prog->getRelation(relName);
+    tuple t(relation);
+    for (const auto& node : nodes) {
+        t << node;
+    }
+    relation->insert(t);
+}
+
+/**
+ * Main program
+ */
+int main(int /* argc */, char** /* argv */) {
+    Own<SouffleProgram> prog(ProgramFactory::newInstance("base_database"));
+    if (prog == nullptr) {
+        error("failed to create souffle program");
+    }
+    // load the base facts and evaluate them
+    prog->loadAll();
+    insertTuple(prog, "source", {"A"});
+    insertTuple(prog, "sink", {"F"});
+    Own<BaseDatabase> base = BaseDatabase::evaluate("base_database", std::move(prog));
+    if (base == nullptr) {
+        error("failed to evaluate the base database");
+    }
+
+    // create all queries before running them concurrently
+    std::vector<Own<SouffleProgram>> queries;
+    for (std::size_t i = 0; i < 3; i++) {
+        queries.push_back(base->newQuery());
+    }
+    insertTuple(queries[0], "source", {"B"});
+    insertTuple(queries[1], "edge", {"F", "G"});
+    insertTuple(queries[1], "sink", {"G"});
+    // the sink of the base is no longer open for the third query
+    insertTuple(queries[2], "blocked", {"F"});
+
+    std::vector<std::thread> threads;
+    for (auto& query : queries) {
+        threads.emplace_back([&query]() { query->run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        printQuery(*queries[i], "query " + std::to_string(i + 1));
+    }
+
+    // the queries leave the base database unchanged
+    printQuery(base->getBase(), "base");
+}
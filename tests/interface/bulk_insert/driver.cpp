@@ -0,0 +1,76 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for inserting and reading tuples in bulk using the OO-interface
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int /* argc */, char** /* argv */) {
+    // create an instance of program "bulk_insert"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("bulk_insert")) {
+        // get input relation "edge"
+        if (Relation* edge = prog->getRelation("edge")) {
+            // intern all symbols at once
+            std::vector<RamDomain> node = prog->getSymbolTable().lookup({"A", "B", "C", "D", "E", "F"});
+
+            // load data into relation "edge" from a contiguous array
+            std::vector<RamDomain> myData = {
+                    node[0], node[1], node[1], node[2], node[2], node[3], node[3], node[4], node[4], node[5],
+                    node[5], node[0]};
+            edge->insertAll(myData.data(), myData.size() / 2);
+
+            // run program
+            prog->run();
+
+            // get output relation "path"
+            if (Relation* path = prog->getRelation("path")) {
+                // iterate over output relation in chunks of four tuples
+                const SymbolTable& symbols = prog->getSymbolTable();
+                path->forEachChunk(
+                        [&](const RamDomain* data, std::size_t count) {
+                            for (std::size_t i = 0; i < count; i++) {
+                                std::cout << symbols.resolve(data[2 * i]) << "-"
+                                          << symbols.resolve(data[2 * i + 1]) << "\n";
+                            }
+                        },
+                        4);
+            } else {
+                error("cannot find relation path");
+            }
+
+            // free program analysis
+            delete prog;
+
+        } else {
+            error("cannot find relation edge");
+        }
+    } else {
+        error("cannot find program bulk_insert");
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2020 The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for resetting a Souffle program between runs using the OO-interface
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <memory>
+#include <string>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+void printSource2sink(Own<SouffleProgram>& prog) {
+    Relation* source2sink = prog->getRelation("source2sink");
+    for (tuple tuple : *source2sink) {
+        std::string field;
+        std::string field2;
+        tuple >> field;
+        tuple >> field2;
+        std::cout << field << "-" << field2 << std::endl;
+    }
+}
+
+void insertNode(Own<SouffleProgram>& prog, const std::string& relName, const std::string& node) {
+    Relation* relation = prog->getRelation(relName);
+    tuple t(relation);
+    t << node;
+    relation->insert(t);
+}
+
+/**
+ * Main program
+ */
+int main(int /* argc */, char** /* argv */) {
+    Own<SouffleProgram> prog(ProgramFactory::newInstance("reset_analysis"));
+    if (prog == nullptr) {
+        error("failed to create souffle program");
+    }
+    // load the facts shared by all runs and keep them
+    prog->loadAll();
+    insertNode(prog, "sink", "F");
+    prog->snapshotInputs();
+
+    // run the program with a source
+    insertNode(prog, "source", "B");
+    prog->run();
+    std::cout << "source2sink - run 1" << std::endl;
+    printSource2sink(prog);
+
+    // run the program with a different source only
+    prog->reset();
+    insertNode(prog, "source", "D");
+    prog->run();
+    std::cout << "source2sink - run 2" << std::endl;
+    printSource2sink(prog);
+
+    // run the program without a source
+    prog->reset();
+    prog->run();
+    std::cout << "source2sink - run 3" << std::endl;
+    printSource2sink(prog);
+}